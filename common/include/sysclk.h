@@ -20,6 +20,9 @@ extern "C" {
 #include "sysclk/apm.h"
 #include "sysclk/config.h"
 #include "sysclk/errors.h"
+#include "sysclk/files.h"
+#include "sysclk/stats.h"
+#include "sysclk/metrics.h"
 
 #ifdef __cplusplus
 }
@@ -54,6 +54,17 @@ typedef enum
     SysClkPowerSensor_EnumMax
 } SysClkPowerSensor;
 
+// read from the fuel gauge along with power, current is negative while discharging
+typedef enum
+{
+    SysClkBatteryValue_ChargePermille = 0,
+    SysClkBatteryValue_TempMilli,
+    SysClkBatteryValue_RemainingMah,
+    SysClkBatteryValue_FullMah,
+    SysClkBatteryValue_AvgCurrentMa,
+    SysClkBatteryValue_EnumMax
+} SysClkBatteryValue;
+
 typedef enum
 {
     SysClkRamLoad_All = 0,
@@ -61,6 +72,39 @@ typedef enum
     SysClkRamLoad_EnumMax
 } SysClkRamLoad;
 
+typedef enum
+{
+    SysClkCpuCore_0 = 0,
+    SysClkCpuCore_1,
+    SysClkCpuCore_2,
+    SysClkCpuCore_3,
+    SysClkCpuCore_EnumMax
+} SysClkCpuCore;
+
+// sampled together, at their own period
+typedef enum
+{
+    SysClkSensor_BoardTemp = 0,
+    SysClkSensor_SkinTemp,
+    SysClkSensor_Power,
+    SysClkSensor_RealFreq,
+    SysClkSensor_RamLoad,
+    SysClkSensor_CpuLoad,
+    SysClkSensor_EnumMax
+} SysClkSensor;
+
+// sampled values that can go through the [filters] stages
+typedef enum
+{
+    SysClkSignal_PowerNow = 0,
+    SysClkSignal_PowerAvg,
+    SysClkSignal_RamLoadAll,
+    SysClkSignal_RamLoadCpu,
+    SysClkSignal_RamBandwidthAll,
+    SysClkSignal_RamBandwidthCpu,
+    SysClkSignal_EnumMax
+} SysClkSignal;
+
 #define SYSCLK_ENUM_VALID(n, v) ((v) < n##_EnumMax)
 
 static inline const char* sysclkFormatModule(SysClkModule module, bool pretty)
@@ -106,6 +150,110 @@ static inline const char* sysclkFormatPowerSensor(SysClkPowerSensor powSensor, b
     }
 }
 
+static inline const char* sysclkFormatBatteryValue(SysClkBatteryValue value, bool pretty)
+{
+    switch(value)
+    {
+        case SysClkBatteryValue_ChargePermille:
+            return pretty ? "Charge" : "charge";
+        case SysClkBatteryValue_TempMilli:
+            return pretty ? "Temperature" : "temp";
+        case SysClkBatteryValue_RemainingMah:
+            return pretty ? "Remaining" : "remaining";
+        case SysClkBatteryValue_FullMah:
+            return pretty ? "Full" : "full";
+        case SysClkBatteryValue_AvgCurrentMa:
+            return pretty ? "Avg current" : "avg_current";
+        default:
+            return NULL;
+    }
+}
+
+static inline const char* sysclkFormatRamLoad(SysClkRamLoad load, bool pretty)
+{
+    switch(load)
+    {
+        case SysClkRamLoad_All:
+            return pretty ? "All" : "all";
+        case SysClkRamLoad_Cpu:
+            return pretty ? "CPU" : "cpu";
+        default:
+            return NULL;
+    }
+}
+
+static inline const char* sysclkFormatCpuCore(SysClkCpuCore core, bool pretty)
+{
+    switch(core)
+    {
+        case SysClkCpuCore_0:
+            return pretty ? "Core 0" : "core0";
+        case SysClkCpuCore_1:
+            return pretty ? "Core 1" : "core1";
+        case SysClkCpuCore_2:
+            return pretty ? "Core 2" : "core2";
+        case SysClkCpuCore_3:
+            return pretty ? "Core 3" : "core3";
+        default:
+            return NULL;
+    }
+}
+
+static inline const char* sysclkFormatSensor(SysClkSensor sensor, bool pretty)
+{
+    switch(sensor)
+    {
+        case SysClkSensor_BoardTemp:
+            return pretty ? "SoC/PCB temperatures and fan" : "board_temp";
+        case SysClkSensor_SkinTemp:
+            return pretty ? "Skin temperature" : "skin_temp";
+        case SysClkSensor_Power:
+            return pretty ? "Power, battery and charger" : "power";
+        case SysClkSensor_RealFreq:
+            return pretty ? "Real frequencies" : "real_freq";
+        case SysClkSensor_RamLoad:
+            return pretty ? "RAM load" : "ram_load";
+        case SysClkSensor_CpuLoad:
+            return pretty ? "CPU load" : "cpu_load";
+        default:
+            return NULL;
+    }
+}
+
+static inline const char* sysclkFormatSignal(SysClkSignal signal, bool pretty)
+{
+    switch(signal)
+    {
+        case SysClkSignal_PowerNow:
+            return pretty ? "Power now" : "power_now";
+        case SysClkSignal_PowerAvg:
+            return pretty ? "Power avg" : "power_avg";
+        case SysClkSignal_RamLoadAll:
+            return pretty ? "RAM load" : "ram_load_all";
+        case SysClkSignal_RamLoadCpu:
+            return pretty ? "RAM load (CPU)" : "ram_load_cpu";
+        case SysClkSignal_RamBandwidthAll:
+            return pretty ? "RAM bandwidth" : "ram_bandwidth_all";
+        case SysClkSignal_RamBandwidthCpu:
+            return pretty ? "RAM bandwidth (CPU)" : "ram_bandwidth_cpu";
+        default:
+            return NULL;
+    }
+}
+
+static inline const char* sysclkFormatSocType(SysClkSocType socType, bool pretty)
+{
+    switch(socType)
+    {
+        case SysClkSocType_Erista:
+            return pretty ? "Erista" : "erista";
+        case SysClkSocType_Mariko:
+            return pretty ? "Mariko" : "mariko";
+        default:
+            return NULL;
+    }
+}
+
 static inline const char* sysclkFormatProfile(SysClkProfile profile, bool pretty)
 {
     switch(profile)
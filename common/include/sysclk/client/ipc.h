@@ -31,6 +31,16 @@ Result sysclkIpcSetProfiles(u64 tid, SysClkTitleProfileList* profiles);
 Result sysclkIpcGetConfigValues(SysClkConfigValueList* out_configValues);
 Result sysclkIpcSetConfigValues(SysClkConfigValueList* configValues);
 Result sysclkIpcGetFreqList(SysClkModule module, u32* list, u32 maxCount, u32* outCount);
+Result sysclkIpcGetFileSizes(SysClkFileSizes* out_sizes);
+Result sysclkIpcGetTitleStats(u64 tid, SysClkTitleStats* out_stats);
+Result sysclkIpcGetSessions(u64 tid, SysClkSessionSummary* list, u32 maxCount, u32* outCount);
+Result sysclkIpcGetMetrics(SysClkMetrics* out_metrics);
+Result sysclkIpcSetTraceEnabled(bool enabled);
+Result sysclkIpcDumpTrace();
+Result sysclkIpcDumpFlightRecorder();
+Result sysclkIpcGetSelfUsage(SysClkSelfUsage* out_usage);
+Result sysclkIpcGetContextExt(SysClkContextExt* out_context);
+Result sysclkIpcReloadConfig();
 
 static inline Result sysclkIpcRemoveOverride(SysClkModule module)
 {
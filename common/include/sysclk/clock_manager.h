@@ -26,6 +26,25 @@ typedef struct
     uint32_t ramLoad[SysClkRamLoad_EnumMax];
 } SysClkContext;
 
+// the context along with when each sensor group was last read (tick 0 and age UINT32_MAX if never)
+typedef struct
+{
+    SysClkContext context;
+    uint32_t cpuLoad[SysClkCpuCore_EnumMax]; // busy time since the previous sample, in permille
+    uint32_t fanLevel; // rotation speed level in permille, sampled with the SoC/PCB temperatures
+    uint32_t ramBandwidth[SysClkRamLoad_EnumMax]; // MB/s, averaged by actmon like ramLoad
+    int32_t battery[SysClkBatteryValue_EnumMax];
+    uint32_t timeToEmptyMin; // at the smoothed discharge current, 0 while charging or unknown
+    uint32_t chargerPowerMw; // negotiated charger input, 0 without a charger or if unknown
+    int32_t raw[SysClkSignal_EnumMax];      // same values as above, indexed by signal
+    int32_t filtered[SysClkSignal_EnumMax]; // raw through the [filters] stages of the signal, raw if none
+    uint64_t sampleTicks[SysClkSensor_EnumMax];
+    uint32_t sampleAgeMs[SysClkSensor_EnumMax];
+    uint32_t samplePeriodMs[SysClkSensor_EnumMax];
+    uint32_t sampleCalls[SysClkSensor_EnumMax]; // service and i2c round-trips of the last sample
+    uint32_t sampleUs[SysClkSensor_EnumMax];    // duration of the last sample
+} SysClkContextExt;
+
 typedef struct
 {
     union {
@@ -19,6 +19,24 @@ typedef enum {
     SysClkConfigValue_FreqLogIntervalMs,
     SysClkConfigValue_PowerLogIntervalMs,
     SysClkConfigValue_CsvWriteIntervalMs,
+    SysClkConfigValue_LogMaxSizeKb,
+    SysClkConfigValue_CsvMaxSizeKb,
+    SysClkConfigValue_FileRotateCount,
+    SysClkConfigValue_StatsSaveIntervalMs,
+    SysClkConfigValue_ThrottleTolerancePct,
+    SysClkConfigValue_ThrottleSustainMs,
+    SysClkConfigValue_ApplyLatencyBudgetMs,
+    SysClkConfigValue_TickWatchdogMs,
+    SysClkConfigValue_CpuBudgetPermille,
+    SysClkConfigValue_BoardTempSampleMs,
+    SysClkConfigValue_SkinTempSampleMs,
+    SysClkConfigValue_PowerSampleMs,
+    SysClkConfigValue_RealFreqSampleMs,
+    SysClkConfigValue_RamLoadSampleMs,
+    SysClkConfigValue_CpuLoadSampleMs,
+    SysClkConfigValue_RamActmonPeriodMs,
+    SysClkConfigValue_RamActmonWindow,
+    SysClkConfigValue_ConfigCheckIntervalMs,
     SysClkConfigValue_EnumMax,
 } SysClkConfigValue;
 
@@ -40,6 +58,42 @@ static inline const char* sysclkFormatConfigValue(SysClkConfigValue val, bool pr
             return pretty ? "Power logging interval (ms)" : "power_log_interval_ms";
         case SysClkConfigValue_CsvWriteIntervalMs:
             return pretty ? "CSV write interval (ms)" : "csv_write_interval_ms";
+        case SysClkConfigValue_LogMaxSizeKb:
+            return pretty ? "Log max size (KiB)" : "log_max_size_kb";
+        case SysClkConfigValue_CsvMaxSizeKb:
+            return pretty ? "CSV max size (KiB)" : "csv_max_size_kb";
+        case SysClkConfigValue_FileRotateCount:
+            return pretty ? "Rotated file count" : "file_rotate_count";
+        case SysClkConfigValue_StatsSaveIntervalMs:
+            return pretty ? "Stats save interval (ms)" : "stats_save_interval_ms";
+        case SysClkConfigValue_ThrottleTolerancePct:
+            return pretty ? "Throttle tolerance (%)" : "throttle_tolerance_pct";
+        case SysClkConfigValue_ThrottleSustainMs:
+            return pretty ? "Throttle sustain time (ms)" : "throttle_sustain_ms";
+        case SysClkConfigValue_ApplyLatencyBudgetMs:
+            return pretty ? "Apply latency budget (ms)" : "apply_latency_budget_ms";
+        case SysClkConfigValue_TickWatchdogMs:
+            return pretty ? "Tick watchdog (ms)" : "tick_watchdog_ms";
+        case SysClkConfigValue_CpuBudgetPermille:
+            return pretty ? "CPU budget (\u2030)" : "cpu_budget_permille";
+        case SysClkConfigValue_BoardTempSampleMs:
+            return pretty ? "SoC/PCB temperature and fan sampling (ms)" : "board_temp_sample_ms";
+        case SysClkConfigValue_SkinTempSampleMs:
+            return pretty ? "Skin temperature sampling (ms)" : "skin_temp_sample_ms";
+        case SysClkConfigValue_PowerSampleMs:
+            return pretty ? "Power sampling (ms)" : "power_sample_ms";
+        case SysClkConfigValue_RealFreqSampleMs:
+            return pretty ? "Real frequency sampling (ms)" : "real_freq_sample_ms";
+        case SysClkConfigValue_RamLoadSampleMs:
+            return pretty ? "RAM load sampling (ms)" : "ram_load_sample_ms";
+        case SysClkConfigValue_CpuLoadSampleMs:
+            return pretty ? "CPU load sampling (ms)" : "cpu_load_sample_ms";
+        case SysClkConfigValue_RamActmonPeriodMs:
+            return pretty ? "RAM activity monitor period (ms)" : "ram_actmon_period_ms";
+        case SysClkConfigValue_RamActmonWindow:
+            return pretty ? "RAM activity monitor window (samples)" : "ram_actmon_window";
+        case SysClkConfigValue_ConfigCheckIntervalMs:
+            return pretty ? "Config file check interval (ms)" : "config_check_interval_ms";
         default:
             return NULL;
     }
@@ -56,6 +110,38 @@ static inline uint64_t sysclkDefaultConfigValue(SysClkConfigValue val)
         case SysClkConfigValue_PowerLogIntervalMs:
         case SysClkConfigValue_CsvWriteIntervalMs:
             return 0ULL;
+        case SysClkConfigValue_LogMaxSizeKb:
+            return 1024ULL;
+        case SysClkConfigValue_CsvMaxSizeKb:
+            return 4096ULL;
+        case SysClkConfigValue_FileRotateCount:
+            return 2ULL;
+        case SysClkConfigValue_StatsSaveIntervalMs:
+            return 300000ULL;
+        case SysClkConfigValue_ThrottleTolerancePct:
+            return 5ULL;
+        case SysClkConfigValue_ThrottleSustainMs:
+            return 2000ULL;
+        case SysClkConfigValue_ApplyLatencyBudgetMs:
+            return 1000ULL;
+        case SysClkConfigValue_TickWatchdogMs:
+            return 2000ULL;
+        case SysClkConfigValue_CpuBudgetPermille:
+            return 20ULL;
+        case SysClkConfigValue_BoardTempSampleMs:
+        case SysClkConfigValue_SkinTempSampleMs:
+        case SysClkConfigValue_PowerSampleMs:
+        case SysClkConfigValue_RamLoadSampleMs:
+        case SysClkConfigValue_CpuLoadSampleMs:
+            return 1000ULL;
+        case SysClkConfigValue_RealFreqSampleMs:
+            return 0ULL;
+        case SysClkConfigValue_RamActmonPeriodMs:
+            return 20ULL;
+        case SysClkConfigValue_RamActmonWindow:
+            return 16ULL;
+        case SysClkConfigValue_ConfigCheckIntervalMs:
+            return 5000ULL;
         default:
             return 0ULL;
     }
@@ -71,7 +157,31 @@ static inline uint64_t sysclkValidConfigValue(SysClkConfigValue val, uint64_t in
         case SysClkConfigValue_FreqLogIntervalMs:
         case SysClkConfigValue_PowerLogIntervalMs:
         case SysClkConfigValue_CsvWriteIntervalMs:
+        case SysClkConfigValue_LogMaxSizeKb:
+        case SysClkConfigValue_CsvMaxSizeKb:
+        case SysClkConfigValue_StatsSaveIntervalMs:
+        case SysClkConfigValue_ThrottleSustainMs:
+        case SysClkConfigValue_ApplyLatencyBudgetMs:
+        case SysClkConfigValue_TickWatchdogMs:
+        case SysClkConfigValue_BoardTempSampleMs:
+        case SysClkConfigValue_SkinTempSampleMs:
+        case SysClkConfigValue_PowerSampleMs:
+        case SysClkConfigValue_RealFreqSampleMs:
+        case SysClkConfigValue_RamLoadSampleMs:
+        case SysClkConfigValue_CpuLoadSampleMs:
+        case SysClkConfigValue_ConfigCheckIntervalMs:
             return input >= 0;
+        case SysClkConfigValue_CpuBudgetPermille:
+            return input >= 0 && input <= 1000;
+        case SysClkConfigValue_ThrottleTolerancePct:
+            return input <= 100;
+        case SysClkConfigValue_FileRotateCount:
+            return input <= 9;
+        case SysClkConfigValue_RamActmonPeriodMs:
+            return input >= 1 && input <= 256;
+        case SysClkConfigValue_RamActmonWindow:
+            // power of two, 2^(K+1) for the actmon K value
+            return input >= 2 && input <= 256 && !(input & (input - 1));
         default:
             return false;
     }
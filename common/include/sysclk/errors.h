@@ -18,4 +18,6 @@ typedef enum
     SysClkError_Generic = 0,
     SysClkError_ConfigNotLoaded = 1,
     SysClkError_ConfigSaveFailed = 2,
+    SysClkError_OutOfMemory = 3,
+    SysClkError_FileWriteFailed = 4,
 } SysClkError;
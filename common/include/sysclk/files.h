@@ -0,0 +1,42 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    SysClkFile_Log = 0,
+    SysClkFile_LogBin,
+    SysClkFile_Csv,
+    SysClkFile_EnumMax
+} SysClkFile;
+
+typedef struct
+{
+    uint64_t sizes[SysClkFile_EnumMax];
+} SysClkFileSizes;
+
+static inline const char* sysclkFormatFile(SysClkFile file, bool pretty)
+{
+    switch(file)
+    {
+        case SysClkFile_Log:
+            return pretty ? "Log" : "log.txt";
+        case SysClkFile_LogBin:
+            return pretty ? "Binary log" : "log.bin";
+        case SysClkFile_Csv:
+            return pretty ? "CSV" : "context.csv";
+        default:
+            return NULL;
+    }
+}
@@ -13,8 +13,11 @@
 #include <stdint.h>
 #include "board.h"
 #include "clock_manager.h"
+#include "files.h"
+#include "stats.h"
+#include "metrics.h"
 
-#define SYSCLK_IPC_API_VERSION 4
+#define SYSCLK_IPC_API_VERSION 25
 #define SYSCLK_IPC_SERVICE_NAME "sys:clk"
 
 enum SysClkIpcCmd
@@ -31,6 +34,16 @@ enum SysClkIpcCmd
     SysClkIpcCmd_GetConfigValues = 9,
     SysClkIpcCmd_SetConfigValues = 10,
     SysClkIpcCmd_GetFreqList = 11,
+    SysClkIpcCmd_GetFileSizes = 12,
+    SysClkIpcCmd_GetTitleStats = 13,
+    SysClkIpcCmd_GetSessions = 14,
+    SysClkIpcCmd_GetMetrics = 15,
+    SysClkIpcCmd_SetTraceEnabled = 16,
+    SysClkIpcCmd_DumpTrace = 17,
+    SysClkIpcCmd_DumpFlightRecorder = 18,
+    SysClkIpcCmd_GetSelfUsage = 19,
+    SysClkIpcCmd_GetContextExt = 20,
+    SysClkIpcCmd_ReloadConfig = 21,
 };
 
 
@@ -51,3 +64,9 @@ typedef struct
     SysClkModule module;
     uint32_t maxCount;
 } SysClkIpc_GetFreqList_Args;
+
+typedef struct
+{
+    uint64_t tid;
+    uint32_t maxCount;
+} SysClkIpc_GetSessions_Args;
@@ -0,0 +1,177 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+    SysClkMetricCounter_ClkrstCalls = 0,
+    SysClkMetricCounter_PcvCalls,
+    SysClkMetricCounter_PsmCalls,
+    SysClkMetricCounter_ApmCalls,
+    SysClkMetricCounter_PmCalls,
+    SysClkMetricCounter_I2cCalls,
+    SysClkMetricCounter_TcCalls,
+    SysClkMetricCounter_FanCalls,
+    SysClkMetricCounter_ConfigReloads,
+    SysClkMetricCounter_ConfigChecks,
+    SysClkMetricCounter_ClockSets,
+    SysClkMetricCounter_SdWrites,
+    SysClkMetricCounter_ServiceErrors,
+    SysClkMetricCounter_EnumMax
+} SysClkMetricCounter;
+
+typedef enum
+{
+    SysClkMetricHistogram_Tick = 0,
+    SysClkMetricHistogram_AppLaunchApply,
+    SysClkMetricHistogram_ProfileChangeApply,
+    SysClkMetricHistogram_OverrideApply,
+    SysClkMetricHistogram_ConfigApply,
+    SysClkMetricHistogram_EnumMax
+} SysClkMetricHistogram;
+
+typedef enum
+{
+    SysClkThread_Tick = 0,
+    SysClkThread_Ipc,
+    SysClkThread_EnumMax
+} SysClkThread;
+
+// bucket 0 holds 0 us, bucket n holds [2^(n-1), 2^n) us, the last one is open ended
+#define SYSCLK_METRICS_BUCKETS 24
+#define SYSCLK_METRICS_IPC_CMD_MAX 24
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t reserved;
+    uint64_t sumUs;
+    uint32_t buckets[SYSCLK_METRICS_BUCKETS];
+} SysClkMetricsHistogram;
+
+typedef struct
+{
+    uint64_t uptimeMs;
+    uint64_t counters[SysClkMetricCounter_EnumMax];
+    SysClkMetricsHistogram histograms[SysClkMetricHistogram_EnumMax];
+    SysClkMetricsHistogram ipc[SYSCLK_METRICS_IPC_CMD_MAX];
+} SysClkMetrics;
+
+// sysmodule's own footprint, rates cover the last sampling window
+typedef struct
+{
+    uint64_t cpuTimeUs[SysClkThread_EnumMax];
+    uint64_t wakeups[SysClkThread_EnumMax];
+    uint32_t cpuPermille[SysClkThread_EnumMax];
+    uint32_t wakeupsPerMin[SysClkThread_EnumMax];
+    uint32_t pollingIntervalMs;
+    uint32_t backoff;
+    uint32_t heapSize;
+    uint32_t heapUsed;
+    uint32_t heapPeak;
+    uint32_t arenaSize;
+    uint32_t arenaUsed;
+    uint32_t stackSize[SysClkThread_EnumMax];
+    uint32_t stackPeak[SysClkThread_EnumMax];
+    uint32_t startupReadyMs;
+    uint32_t startupFirstApplyMs;
+} SysClkSelfUsage;
+
+static inline const char* sysclkFormatMetricCounter(SysClkMetricCounter counter, bool pretty)
+{
+    switch(counter)
+    {
+        case SysClkMetricCounter_ClkrstCalls:
+            return pretty ? "clkrst calls" : "clkrst_calls";
+        case SysClkMetricCounter_PcvCalls:
+            return pretty ? "pcv calls" : "pcv_calls";
+        case SysClkMetricCounter_PsmCalls:
+            return pretty ? "psm calls" : "psm_calls";
+        case SysClkMetricCounter_ApmCalls:
+            return pretty ? "apm calls" : "apm_calls";
+        case SysClkMetricCounter_PmCalls:
+            return pretty ? "pm calls" : "pm_calls";
+        case SysClkMetricCounter_I2cCalls:
+            return pretty ? "i2c transactions" : "i2c_calls";
+        case SysClkMetricCounter_TcCalls:
+            return pretty ? "tc calls" : "tc_calls";
+        case SysClkMetricCounter_FanCalls:
+            return pretty ? "fan calls" : "fan_calls";
+        case SysClkMetricCounter_ConfigReloads:
+            return pretty ? "Config reloads" : "config_reloads";
+        case SysClkMetricCounter_ConfigChecks:
+            return pretty ? "Config checks" : "config_checks";
+        case SysClkMetricCounter_ClockSets:
+            return pretty ? "Clock sets" : "clock_sets";
+        case SysClkMetricCounter_SdWrites:
+            return pretty ? "SD writes" : "sd_writes";
+        case SysClkMetricCounter_ServiceErrors:
+            return pretty ? "Service errors" : "service_errors";
+        default:
+            return NULL;
+    }
+}
+
+static inline const char* sysclkFormatMetricHistogram(SysClkMetricHistogram histogram, bool pretty)
+{
+    switch(histogram)
+    {
+        case SysClkMetricHistogram_Tick:
+            return pretty ? "Tick" : "tick";
+        case SysClkMetricHistogram_AppLaunchApply:
+            return pretty ? "App launch to clocks applied" : "app_launch_apply";
+        case SysClkMetricHistogram_ProfileChangeApply:
+            return pretty ? "Dock/charger change to clocks applied" : "profile_change_apply";
+        case SysClkMetricHistogram_OverrideApply:
+            return pretty ? "Override to clocks applied" : "override_apply";
+        case SysClkMetricHistogram_ConfigApply:
+            return pretty ? "Config change to clocks applied" : "config_apply";
+        default:
+            return NULL;
+    }
+}
+
+static inline const char* sysclkFormatThread(SysClkThread thread, bool pretty)
+{
+    switch(thread)
+    {
+        case SysClkThread_Tick:
+            return pretty ? "Tick" : "tick";
+        case SysClkThread_Ipc:
+            return pretty ? "IPC" : "ipc";
+        default:
+            return NULL;
+    }
+}
+
+// upper bound of the bucket holding the given percentile, in us
+static inline uint64_t sysclkMetricsPercentileUs(const SysClkMetricsHistogram* histogram, uint32_t percentile)
+{
+    uint64_t target = ((uint64_t)histogram->count * percentile + 99) / 100;
+    uint64_t seen = 0;
+
+    for(uint32_t i = 0; i < SYSCLK_METRICS_BUCKETS; i++)
+    {
+        seen += histogram->buckets[i];
+        if(target && seen >= target)
+        {
+            uint64_t upper = i ? (1ULL << i) - 1 : 0;
+            return upper < histogram->maxUs ? upper : histogram->maxUs;
+        }
+    }
+
+    return histogram->maxUs;
+}
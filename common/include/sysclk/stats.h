@@ -0,0 +1,38 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "board.h"
+#include "clock_manager.h"
+
+// time spent at each slot of the GetFreqList table, in milliseconds
+typedef struct
+{
+    uint32_t timeInStateMs[SysClkProfile_EnumMax][SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX];
+    uint32_t throttledMs[SysClkModule_EnumMax];         // real clock sustainedly off target
+    uint32_t throttleEpisodes[SysClkModule_EnumMax];
+} SysClkTitleStats;
+
+// summary of a title run, from launch until exit
+typedef struct
+{
+    uint64_t tid;
+    uint32_t startTime;                                 // unix seconds
+    uint32_t durationMs;
+    int32_t energyMj;                                   // SysClkPowerSensor_Now integral, negative while discharging
+    uint32_t profileMask;                               // 1 << SysClkProfile seen during the run
+    uint32_t avgTemps[SysClkThermalSensor_EnumMax];     // millidegrees
+    uint32_t peakTemps[SysClkThermalSensor_EnumMax];    // millidegrees
+    uint32_t avgFreqs[SysClkModule_EnumMax];            // hz, time weighted
+} SysClkSessionSummary;
+
+#define SYSCLK_SESSION_LIST_MAX 16
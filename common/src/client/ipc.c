@@ -126,3 +126,70 @@ Result sysclkIpcGetFreqList(SysClkModule module, u32* list, u32 maxCount, u32* o
         .buffers = {{list, maxCount * sizeof(u32)}},
     );
 }
+
+Result sysclkIpcGetFileSizes(SysClkFileSizes* out_sizes)
+{
+    return serviceDispatchOut(&g_sysclkSrv, SysClkIpcCmd_GetFileSizes, *out_sizes);
+}
+
+Result sysclkIpcGetTitleStats(u64 tid, SysClkTitleStats* out_stats)
+{
+    return serviceDispatchIn(&g_sysclkSrv, SysClkIpcCmd_GetTitleStats, tid,
+        .buffer_attrs = { SfBufferAttr_HipcMapAlias | SfBufferAttr_Out },
+        .buffers = {{out_stats, sizeof(SysClkTitleStats)}},
+    );
+}
+
+Result sysclkIpcGetSessions(u64 tid, SysClkSessionSummary* list, u32 maxCount, u32* outCount)
+{
+    SysClkIpc_GetSessions_Args args = {
+        .tid = tid,
+        .maxCount = maxCount
+    };
+    return serviceDispatchInOut(&g_sysclkSrv, SysClkIpcCmd_GetSessions, args, *outCount,
+        .buffer_attrs = { SfBufferAttr_HipcMapAlias | SfBufferAttr_Out },
+        .buffers = {{list, maxCount * sizeof(SysClkSessionSummary)}},
+    );
+}
+
+Result sysclkIpcGetMetrics(SysClkMetrics* out_metrics)
+{
+    return serviceDispatch(&g_sysclkSrv, SysClkIpcCmd_GetMetrics,
+        .buffer_attrs = { SfBufferAttr_HipcMapAlias | SfBufferAttr_Out },
+        .buffers = {{out_metrics, sizeof(SysClkMetrics)}},
+    );
+}
+
+Result sysclkIpcSetTraceEnabled(bool enabled)
+{
+    u8 enabledRaw = (u8)enabled;
+    return serviceDispatchIn(&g_sysclkSrv, SysClkIpcCmd_SetTraceEnabled, enabledRaw);
+}
+
+Result sysclkIpcDumpTrace()
+{
+    return serviceDispatch(&g_sysclkSrv, SysClkIpcCmd_DumpTrace);
+}
+
+Result sysclkIpcDumpFlightRecorder()
+{
+    return serviceDispatch(&g_sysclkSrv, SysClkIpcCmd_DumpFlightRecorder);
+}
+
+Result sysclkIpcGetSelfUsage(SysClkSelfUsage* out_usage)
+{
+    return serviceDispatchOut(&g_sysclkSrv, SysClkIpcCmd_GetSelfUsage, *out_usage);
+}
+
+Result sysclkIpcGetContextExt(SysClkContextExt* out_context)
+{
+    return serviceDispatch(&g_sysclkSrv, SysClkIpcCmd_GetContextExt,
+        .buffer_attrs = { SfBufferAttr_HipcMapAlias | SfBufferAttr_Out },
+        .buffers = {{out_context, sizeof(SysClkContextExt)}},
+    );
+}
+
+Result sysclkIpcReloadConfig()
+{
+    return serviceDispatch(&g_sysclkSrv, SysClkIpcCmd_ReloadConfig);
+}
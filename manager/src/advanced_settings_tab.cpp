@@ -172,6 +172,39 @@ std::string AdvancedSettingsTab::getDescriptionForConfig(SysClkConfigValue confi
             return "How often to log power consumption (in milliseconds)\n\uE016  Use 0 to disable";
         case SysClkConfigValue_PollingIntervalMs:
             return "How fast to check and apply profiles (in milliseconds)";
+        case SysClkConfigValue_LogMaxSizeKb:
+            return "Size at which log.txt and log.bin are rotated (in KiB)\n\uE016  Use 0 to disable";
+        case SysClkConfigValue_CsvMaxSizeKb:
+            return "Size at which context.csv is rotated (in KiB)\n\uE016  Use 0 to disable";
+        case SysClkConfigValue_FileRotateCount:
+            return "How many rotated generations to keep for each file (0 to 9)";
+        case SysClkConfigValue_StatsSaveIntervalMs:
+            return "How often to save time-in-state stats to /config/sys-clk/stats.bin (in milliseconds)\n\uE016  Use 0 to disable";
+        case SysClkConfigValue_ThrottleTolerancePct:
+            return "How far the real clock may drift from the set clock before it counts as throttled (in percent)\n\uE016  Use 0 to disable";
+        case SysClkConfigValue_ThrottleSustainMs:
+            return "How long the real clock must stay off before a throttle episode is reported (in milliseconds)";
+        case SysClkConfigValue_ApplyLatencyBudgetMs:
+            return "Launch, dock, override and config changes slower than this to apply are logged (in milliseconds)\n\uE016  Use 0 to disable";
+        case SysClkConfigValue_CpuBudgetPermille:
+            return "Polling slows down while sys-clk uses more CPU time than this (in \u2030 of one core)\n\uE016  Use 0 to disable";
+        case SysClkConfigValue_TickWatchdogMs:
+            return "A tick slower than this dumps the flight recorder to the SD card (in milliseconds)\n\uE016  Use 0 to disable, app and profile changes wait one polling interval";
+        case SysClkConfigValue_BoardTempSampleMs:
+        case SysClkConfigValue_SkinTempSampleMs:
+        case SysClkConfigValue_PowerSampleMs:
+        case SysClkConfigValue_RamLoadSampleMs:
+            return "How often this sensor is read (in milliseconds), longer periods mean less bus traffic but older values\n\uE016  Use 0 to read it on every tick";
+        case SysClkConfigValue_RealFreqSampleMs:
+            return "How often real clocks are read (in milliseconds), throttle detection reacts this late at worst\n\uE016  Use 0 to read them on every tick";
+        case SysClkConfigValue_CpuLoadSampleMs:
+            return "How often CPU load is read (in milliseconds), the load is averaged over this period\n\uE016  Use 0 to read it on every tick";
+        case SysClkConfigValue_RamActmonPeriodMs:
+            return "Activity monitor sample period for RAM load and bandwidth (1 to 256 milliseconds)";
+        case SysClkConfigValue_RamActmonWindow:
+            return "How many activity monitor samples RAM load and bandwidth are averaged over (power of two, 2 to 256)";
+        case SysClkConfigValue_ConfigCheckIntervalMs:
+            return "How often config.ini is checked for edits made outside of sys-clk (in milliseconds)\n\uE016  Use 0 to only reload it from the diagnostics tab";
         default:
             return "";
     }
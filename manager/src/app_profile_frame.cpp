@@ -27,6 +27,7 @@
 #include "ipc/client.h"
 
 #include <cstring>
+#include <ctime>
 
 AppProfileFrame::AppProfileFrame(Title* title) : ThumbnailFrame(), title(title)
 {
@@ -39,6 +40,15 @@ AppProfileFrame::AppProfileFrame(Title* title) : ThumbnailFrame(), title(title)
     if (R_FAILED(rc))
         errorResult("sysclkIpcGetProfiles", rc);
 
+    // Get the time in state stats
+    rc = sysclkIpcGetTitleStats(title->tid, &this->stats);
+
+    if (R_FAILED(rc))
+    {
+        errorResult("sysclkIpcGetTitleStats", rc);
+        memset(&this->stats, 0, sizeof(SysClkTitleStats));
+    }
+
     // Setup the right sidebar
     this->getSidebar()->setThumbnail(title->icon, sizeof(title->icon));
     this->getSidebar()->setTitle(std::string(title->name));
@@ -81,6 +91,16 @@ AppProfileFrame::AppProfileFrame(Title* title) : ThumbnailFrame(), title(title)
     this->addFreqs(list, SysClkProfile_HandheldChargingOfficial);
     this->addFreqs(list, SysClkProfile_HandheldChargingUSB);
 
+    this->addStats(list, SysClkProfile_Docked);
+    this->addStats(list, SysClkProfile_Handheld);
+
+    this->addStats(list, SysClkProfile_HandheldCharging);
+    this->addStats(list, SysClkProfile_HandheldChargingOfficial);
+    this->addStats(list, SysClkProfile_HandheldChargingUSB);
+
+    this->addThrottle(list);
+    this->addSessions(list);
+
     this->setContentView(list);
 }
 
@@ -129,6 +149,111 @@ void AppProfileFrame::addFreqs(brls::List* list, SysClkProfile profile)
     list->addView(memListItem);
 }
 
+void AppProfileFrame::addStats(brls::List* list, SysClkProfile profile)
+{
+    // Every module is sampled on the same ticks, CPU holds the total time
+    uint64_t totalMs = 0;
+    for (int i = 0; i < SYSCLK_FREQ_LIST_MAX; i++)
+        totalMs += this->stats.timeInStateMs[profile][SysClkModule_CPU][i];
+
+    if (!totalMs)
+        return;
+
+    list->addView(new brls::Header("Time in state - " + std::string(sysclkFormatProfile(profile, true)) + " - " + formatDuration(totalMs)));
+
+    for (int m = 0; m < SysClkModule_EnumMax; m++)
+    {
+        uint32_t* table = &g_freq_table_hz[m][0];
+        uint32_t* ms = &this->stats.timeInStateMs[profile][m][0];
+        std::string description;
+        uint32_t topSlot = 0;
+
+        // Highest clocks first
+        for (uint32_t i = table[0]; i > 0; i--)
+        {
+            if (ms[i - 1] > ms[topSlot])
+                topSlot = i - 1;
+
+            if (!ms[i - 1])
+                continue;
+
+            char entry[32];
+            snprintf(entry, sizeof(entry), "%s%u MHz: %.1f%%", description.empty() ? "" : ", ", table[i] / 1000000, ms[i - 1] * 100.0f / totalMs);
+            description += entry;
+        }
+
+        brls::ListItem* item = new brls::ListItem(std::string(sysclkFormatModule((SysClkModule)m, true)), description);
+        item->setValue(ms[topSlot] ? formatFreq(table[topSlot + 1]) : "-");
+        list->addView(item);
+    }
+}
+
+void AppProfileFrame::addThrottle(brls::List* list)
+{
+    uint32_t episodes = 0;
+    for (int m = 0; m < SysClkModule_EnumMax; m++)
+        episodes += this->stats.throttleEpisodes[m];
+
+    if (!episodes)
+        return;
+
+    list->addView(new brls::Header("Throttling"));
+
+    for (int m = 0; m < SysClkModule_EnumMax; m++)
+    {
+        char description[32];
+        snprintf(description, sizeof(description), "%u episode%s", this->stats.throttleEpisodes[m], this->stats.throttleEpisodes[m] == 1 ? "" : "s");
+
+        brls::ListItem* item = new brls::ListItem(std::string(sysclkFormatModule((SysClkModule)m, true)), description);
+        item->setValue(formatDuration(this->stats.throttledMs[m]));
+        list->addView(item);
+    }
+}
+
+void AppProfileFrame::addSessions(brls::List* list)
+{
+    SysClkSessionSummary sessions[SYSCLK_SESSION_LIST_MAX];
+    uint32_t count = 0;
+
+    Result rc = sysclkIpcGetSessions(this->title->tid, sessions, SYSCLK_SESSION_LIST_MAX, &count);
+
+    if (R_FAILED(rc))
+    {
+        errorResult("sysclkIpcGetSessions", rc);
+        return;
+    }
+
+    if (!count)
+        return;
+
+    list->addView(new brls::Header("Recent sessions"));
+
+    // Most recent first
+    for (uint32_t i = count; i > 0; i--)
+    {
+        SysClkSessionSummary* session = &sessions[i - 1];
+
+        char date[32];
+        time_t startTime = session->startTime;
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M", localtime(&startTime));
+
+        char energy[32];
+        snprintf(energy, sizeof(energy), "%d mWh", session->energyMj / 3600);
+
+        std::string description = std::string("Battery: ") + energy;
+
+        for (int s = 0; s < SysClkThermalSensor_EnumMax; s++)
+            description += std::string(" \u2022 ") + sysclkFormatThermalSensor((SysClkThermalSensor)s, true) + ": " + formatTemp(session->avgTemps[s]) + " (peak " + formatTemp(session->peakTemps[s]) + ")";
+
+        for (int m = 0; m < SysClkModule_EnumMax; m++)
+            description += std::string(" \u2022 ") + sysclkFormatModule((SysClkModule)m, true) + ": " + formatFreq(session->avgFreqs[m]);
+
+        brls::ListItem* item = new brls::ListItem(std::string(date), description);
+        item->setValue(formatDuration(session->durationMs));
+        list->addView(item);
+    }
+}
+
 void AppProfileFrame::onProfileChanged()
 {
     this->getSidebar()->getButton()->setState(brls::ButtonState::ENABLED);
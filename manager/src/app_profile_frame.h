@@ -37,10 +37,14 @@ class AppProfileFrame : public brls::ThumbnailFrame
         Title* title;
 
         SysClkTitleProfileList profiles;
+        SysClkTitleStats stats;
 
         bool hasProfileChanged();
 
         void addFreqs(brls::List* list, SysClkProfile profile);
+        void addStats(brls::List* list, SysClkProfile profile);
+        void addThrottle(brls::List* list);
+        void addSessions(brls::List* list);
 
         void onProfileChanged();
 };
@@ -0,0 +1,348 @@
+/*
+    sys-clk manager, a sys-clk frontend homebrew
+    Copyright (C) 2019-2020  natinusala
+    Copyright (C) 2019  p-sam
+    Copyright (C) 2019  m4xw
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "diagnostics_tab.h"
+
+#include "utils.h"
+
+#include "ipc/client.h"
+
+static std::string formatIpcCmd(uint32_t cmdId)
+{
+    switch (cmdId)
+    {
+        case SysClkIpcCmd_GetApiVersion:
+            return "GetApiVersion";
+        case SysClkIpcCmd_GetVersionString:
+            return "GetVersionString";
+        case SysClkIpcCmd_GetCurrentContext:
+            return "GetCurrentContext";
+        case SysClkIpcCmd_Exit:
+            return "Exit";
+        case SysClkIpcCmd_GetProfileCount:
+            return "GetProfileCount";
+        case SysClkIpcCmd_GetProfiles:
+            return "GetProfiles";
+        case SysClkIpcCmd_SetProfiles:
+            return "SetProfiles";
+        case SysClkIpcCmd_SetEnabled:
+            return "SetEnabled";
+        case SysClkIpcCmd_SetOverride:
+            return "SetOverride";
+        case SysClkIpcCmd_GetConfigValues:
+            return "GetConfigValues";
+        case SysClkIpcCmd_SetConfigValues:
+            return "SetConfigValues";
+        case SysClkIpcCmd_GetFreqList:
+            return "GetFreqList";
+        case SysClkIpcCmd_GetFileSizes:
+            return "GetFileSizes";
+        case SysClkIpcCmd_GetTitleStats:
+            return "GetTitleStats";
+        case SysClkIpcCmd_GetSessions:
+            return "GetSessions";
+        case SysClkIpcCmd_GetMetrics:
+            return "GetMetrics";
+        case SysClkIpcCmd_SetTraceEnabled:
+            return "SetTraceEnabled";
+        case SysClkIpcCmd_DumpTrace:
+            return "DumpTrace";
+        case SysClkIpcCmd_DumpFlightRecorder:
+            return "DumpFlightRecorder";
+        case SysClkIpcCmd_GetSelfUsage:
+            return "GetSelfUsage";
+        case SysClkIpcCmd_GetContextExt:
+            return "GetContextExt";
+        case SysClkIpcCmd_ReloadConfig:
+            return "ReloadConfig";
+        default:
+            return "Command " + std::to_string(cmdId);
+    }
+}
+
+static std::string formatHistogram(const SysClkMetricsHistogram* histogram)
+{
+    char str[128];
+
+    if (!histogram->count)
+        return "-";
+
+    snprintf(str, sizeof(str), "%u \u2022 min %u \u00B5s \u2022 avg %lu \u00B5s \u2022 p99 %lu \u00B5s \u2022 max %u \u00B5s",
+        histogram->count,
+        histogram->minUs,
+        histogram->sumUs / histogram->count,
+        sysclkMetricsPercentileUs(histogram, 99),
+        histogram->maxUs
+    );
+
+    return std::string(str);
+}
+
+DiagnosticsTab::DiagnosticsTab()
+{
+    brls::ListItem* refreshListItem = new brls::ListItem("Refresh");
+    refreshListItem->getClickEvent()->subscribe([this](brls::View* view) {
+        this->refresh();
+    });
+    this->addView(refreshListItem);
+
+    this->uptimeListItem = new brls::ListItem("System uptime");
+    this->addView(this->uptimeListItem);
+
+    // Tracing
+    this->addView(new brls::Header("Tracing"));
+
+    brls::ToggleListItem* traceListItem = new brls::ToggleListItem("Record trace", false, "Keeps the latest sysmodule activity spans in memory", "Yes", "No");
+    traceListItem->getClickEvent()->subscribe([traceListItem](brls::View* view) {
+        Result rc = sysclkIpcSetTraceEnabled(traceListItem->getToggleState());
+
+        if (R_FAILED(rc))
+        {
+            errorResult("sysclkIpcSetTraceEnabled", rc);
+            brls::Application::notify("An error occured while toggling the trace - see logs for more details");
+        }
+    });
+    this->addView(traceListItem);
+
+    brls::ListItem* dumpListItem = new brls::ListItem("Dump trace", "Writes /config/sys-clk/trace.json, open it in a Chrome trace viewer");
+    dumpListItem->getClickEvent()->subscribe([](brls::View* view) {
+        Result rc = sysclkIpcDumpTrace();
+
+        if (R_SUCCEEDED(rc))
+        {
+            brls::Application::notify("\uE14B Trace saved");
+        }
+        else
+        {
+            errorResult("sysclkIpcDumpTrace", rc);
+            brls::Application::notify("An error occured while saving the trace - is it recording?");
+        }
+    });
+    this->addView(dumpListItem);
+
+    brls::ListItem* flightListItem = new brls::ListItem("Dump flight recorder", "Writes the latest tick decisions to /config/sys-clk/flight.txt");
+    flightListItem->getClickEvent()->subscribe([](brls::View* view) {
+        Result rc = sysclkIpcDumpFlightRecorder();
+
+        if (R_SUCCEEDED(rc))
+        {
+            brls::Application::notify("\uE14B Flight recorder saved");
+        }
+        else
+        {
+            errorResult("sysclkIpcDumpFlightRecorder", rc);
+            brls::Application::notify("An error occured while saving the flight recorder - see logs for more details");
+        }
+    });
+    this->addView(flightListItem);
+
+    brls::ListItem* reloadListItem = new brls::ListItem("Reload config", "Reads /config/sys-clk/config.ini again, for edits made outside of sys-clk");
+    reloadListItem->getClickEvent()->subscribe([](brls::View* view) {
+        Result rc = sysclkIpcReloadConfig();
+
+        if (R_SUCCEEDED(rc))
+        {
+            brls::Application::notify("\uE14B Config reloaded");
+        }
+        else
+        {
+            errorResult("sysclkIpcReloadConfig", rc);
+            brls::Application::notify("An error occured while reloading the config - see logs for more details");
+        }
+    });
+    this->addView(reloadListItem);
+
+    // Self usage
+    this->addView(new brls::Header("sys-clk threads"));
+
+    for (int t = 0; t < SysClkThread_EnumMax; t++)
+    {
+        this->threadListItems[t] = new brls::ListItem(std::string(sysclkFormatThread((SysClkThread)t, true)));
+        this->addView(this->threadListItems[t]);
+    }
+
+    this->pollingListItem = new brls::ListItem("Polling interval");
+    this->addView(this->pollingListItem);
+
+    this->startupListItem = new brls::ListItem("Startup", "Ready \u2022 first profile applied, since sys-clk started");
+    this->addView(this->startupListItem);
+
+    // Sensors
+    this->addView(new brls::Header("Sensors"));
+
+    for (int s = 0; s < SysClkSensor_EnumMax; s++)
+    {
+        this->sensorListItems[s] = new brls::ListItem(std::string(sysclkFormatSensor((SysClkSensor)s, true)), "Period \u2022 age \u2022 round-trips and time of the last sample");
+        this->addView(this->sensorListItems[s]);
+    }
+
+    // Filters
+    this->addView(new brls::Header("Filters"));
+
+    for (int s = 0; s < SysClkSignal_EnumMax; s++)
+    {
+        this->signalListItems[s] = new brls::ListItem(std::string(sysclkFormatSignal((SysClkSignal)s, true)), "Raw \u2022 filtered, stages are set in the [filters] section of config.ini");
+        this->addView(this->signalListItems[s]);
+    }
+
+    // Memory
+    this->addView(new brls::Header("Memory"));
+
+    this->heapListItem = new brls::ListItem("Heap", "In use \u2022 high-water \u2022 size");
+    this->addView(this->heapListItem);
+
+    this->arenaListItem = new brls::ListItem("Arena", "Runtime tables carved at startup");
+    this->addView(this->arenaListItem);
+
+    for (int t = 0; t < SysClkThread_EnumMax; t++)
+    {
+        this->stackListItems[t] = new brls::ListItem(std::string(sysclkFormatThread((SysClkThread)t, true)) + " stack", "High-water \u2022 size");
+        this->addView(this->stackListItems[t]);
+    }
+
+    // Counters
+    this->addView(new brls::Header("Counters"));
+
+    for (int c = 0; c < SysClkMetricCounter_EnumMax; c++)
+    {
+        this->counterListItems[c] = new brls::ListItem(std::string(sysclkFormatMetricCounter((SysClkMetricCounter)c, true)));
+        this->addView(this->counterListItems[c]);
+    }
+
+    // Durations
+    this->addView(new brls::Header("Durations"));
+
+    for (int h = 0; h < SysClkMetricHistogram_EnumMax; h++)
+    {
+        this->histogramListItems[h] = new brls::ListItem(std::string(sysclkFormatMetricHistogram((SysClkMetricHistogram)h, true)));
+        this->addView(this->histogramListItems[h]);
+    }
+
+    // IPC
+    this->addView(new brls::Header("IPC requests"));
+
+    for (int i = 0; i < SYSCLK_METRICS_IPC_CMD_MAX; i++)
+        this->ipcListItems[i] = nullptr;
+
+    for (int i = 0; i <= SysClkIpcCmd_GetContextExt; i++)
+    {
+        this->ipcListItems[i] = new brls::ListItem(formatIpcCmd(i));
+        this->addView(this->ipcListItems[i]);
+    }
+
+    this->refresh();
+}
+
+void DiagnosticsTab::refresh()
+{
+    SysClkMetrics metrics;
+    Result rc = sysclkIpcGetMetrics(&metrics);
+
+    if (R_FAILED(rc))
+    {
+        errorResult("sysclkIpcGetMetrics", rc);
+        brls::Application::notify("An error occured while getting metrics - see logs for more details");
+        return;
+    }
+
+    this->uptimeListItem->setValue(formatDuration(metrics.uptimeMs));
+
+    SysClkSelfUsage usage;
+    rc = sysclkIpcGetSelfUsage(&usage);
+
+    if (R_SUCCEEDED(rc))
+    {
+        for (int t = 0; t < SysClkThread_EnumMax; t++)
+        {
+            char value[64];
+            snprintf(value, sizeof(value), "%u.%u%% \u2022 %u.%u wakeups/s \u2022 %lu ms total",
+                usage.cpuPermille[t] / 10, usage.cpuPermille[t] % 10,
+                usage.wakeupsPerMin[t] / 60, usage.wakeupsPerMin[t] % 60 / 6,
+                usage.cpuTimeUs[t] / 1000
+            );
+            this->threadListItems[t]->setValue(value);
+        }
+
+        char polling[32];
+        snprintf(polling, sizeof(polling), "%u ms (x%u)", usage.pollingIntervalMs, usage.backoff);
+        this->pollingListItem->setValue(polling);
+
+        char startup[48];
+        if (usage.startupFirstApplyMs)
+            snprintf(startup, sizeof(startup), "%u ms \u2022 %u ms", usage.startupReadyMs, usage.startupFirstApplyMs);
+        else
+            snprintf(startup, sizeof(startup), "%u ms \u2022 -", usage.startupReadyMs);
+        this->startupListItem->setValue(startup);
+
+        this->heapListItem->setValue(formatBytes(usage.heapUsed) + " \u2022 " + formatBytes(usage.heapPeak) + " \u2022 " + formatBytes(usage.heapSize));
+        this->arenaListItem->setValue(formatBytes(usage.arenaUsed) + " / " + formatBytes(usage.arenaSize));
+
+        for (int t = 0; t < SysClkThread_EnumMax; t++)
+            this->stackListItems[t]->setValue(formatBytes(usage.stackPeak[t]) + " / " + formatBytes(usage.stackSize[t]));
+    }
+    else
+    {
+        errorResult("sysclkIpcGetSelfUsage", rc);
+    }
+
+    SysClkContextExt contextExt;
+    rc = sysclkIpcGetContextExt(&contextExt);
+
+    if (R_SUCCEEDED(rc))
+    {
+        for (int s = 0; s < SysClkSensor_EnumMax; s++)
+        {
+            char value[64];
+            std::string period = contextExt.samplePeriodMs[s] ? std::to_string(contextExt.samplePeriodMs[s]) + " ms" : "every tick";
+            if (contextExt.sampleAgeMs[s] == UINT32_MAX)
+                snprintf(value, sizeof(value), "%s \u2022 -", period.c_str());
+            else
+                snprintf(value, sizeof(value), "%s \u2022 %u ms \u2022 %u calls, %u us", period.c_str(), contextExt.sampleAgeMs[s], contextExt.sampleCalls[s], contextExt.sampleUs[s]);
+            this->sensorListItems[s]->setValue(value);
+        }
+
+        for (int s = 0; s < SysClkSignal_EnumMax; s++)
+            this->signalListItems[s]->setValue(std::to_string(contextExt.raw[s]) + " \u2022 " + std::to_string(contextExt.filtered[s]));
+    }
+    else
+    {
+        errorResult("sysclkIpcGetContextExt", rc);
+    }
+
+    for (int c = 0; c < SysClkMetricCounter_EnumMax; c++)
+    {
+        char value[48];
+        snprintf(value, sizeof(value), "%lu (%.1f/s)", metrics.counters[c], metrics.uptimeMs ? metrics.counters[c] * 1000.0 / metrics.uptimeMs : 0.0);
+        this->counterListItems[c]->setValue(value);
+    }
+
+    for (int h = 0; h < SysClkMetricHistogram_EnumMax; h++)
+    {
+        this->histogramListItems[h]->setValue(formatHistogram(&metrics.histograms[h]));
+    }
+
+    for (int i = 0; i < SYSCLK_METRICS_IPC_CMD_MAX; i++)
+    {
+        if (!this->ipcListItems[i])
+            continue;
+
+        this->ipcListItems[i]->setValue(formatHistogram(&metrics.ipc[i]));
+    }
+}
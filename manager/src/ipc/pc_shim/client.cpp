@@ -113,6 +113,42 @@ Result sysclkIpcGetCurrentContext(SysClkContext* out_context)
     return 0;
 }
 
+Result sysclkIpcGetContextExt(SysClkContextExt* out_context)
+{
+    memset(out_context, 0, sizeof(SysClkContextExt));
+    g_server->CopyContext(&out_context->context);
+    out_context->cpuLoad[SysClkCpuCore_0] = 874;
+    out_context->cpuLoad[SysClkCpuCore_1] = 612;
+    out_context->cpuLoad[SysClkCpuCore_2] = 455;
+    out_context->cpuLoad[SysClkCpuCore_3] = 97;
+    out_context->ramBandwidth[SysClkRamLoad_All] = 6143;
+    out_context->ramBandwidth[SysClkRamLoad_Cpu] = 2210;
+    out_context->battery[SysClkBatteryValue_ChargePermille] = 783;
+    out_context->battery[SysClkBatteryValue_TempMilli] = 31400;
+    out_context->battery[SysClkBatteryValue_RemainingMah] = 3371;
+    out_context->battery[SysClkBatteryValue_FullMah] = 4310;
+    out_context->battery[SysClkBatteryValue_AvgCurrentMa] = -1420;
+    out_context->timeToEmptyMin = 142;
+    out_context->fanLevel = 385;
+    out_context->chargerPowerMw = 0;
+    for(int s = 0; s < SysClkSignal_EnumMax; s++)
+    {
+        out_context->raw[s] = 1000 + s * 37;
+        out_context->filtered[s] = 990 + s * 35;
+    }
+
+    for(int s = 0; s < SysClkSensor_EnumMax; s++)
+    {
+        out_context->samplePeriodMs[s] = s == SysClkSensor_RealFreq ? 0 : 1000;
+        out_context->sampleAgeMs[s] = s == SysClkSensor_RealFreq ? 120 : 640;
+        out_context->sampleTicks[s] = 1;
+        out_context->sampleCalls[s] = s == SysClkSensor_RealFreq || s == SysClkSensor_RamLoad ? 0 : 1;
+        out_context->sampleUs[s] = s == SysClkSensor_RealFreq ? 12 : 380;
+    }
+
+    return 0;
+}
+
 Result sysclkIpcGetProfileCount(u64 tid, u8* out_count)
 {
     *out_count = g_server->CountProfiles(tid);
@@ -179,6 +215,158 @@ Result sysclkIpcGetFreqList(SysClkModule module, u32* list, u32 maxCount, u32* o
     return 0;
 }
 
+Result sysclkIpcGetFileSizes(SysClkFileSizes* out_sizes)
+{
+    out_sizes->sizes[SysClkFile_Log] = 12345;
+    out_sizes->sizes[SysClkFile_LogBin] = 4096;
+    out_sizes->sizes[SysClkFile_Csv] = 524288;
+    return 0;
+}
+
+Result sysclkIpcGetTitleStats(u64 tid, SysClkTitleStats* out_stats)
+{
+    memset(out_stats, 0, sizeof(SysClkTitleStats));
+
+    if(tid == 0x010000000000F002)
+    {
+        out_stats->timeInStateMs[SysClkProfile_Docked][SysClkModule_CPU][6] = 5400000;
+        out_stats->timeInStateMs[SysClkProfile_Docked][SysClkModule_CPU][4] = 600000;
+        out_stats->timeInStateMs[SysClkProfile_Docked][SysClkModule_GPU][11] = 6000000;
+        out_stats->timeInStateMs[SysClkProfile_Docked][SysClkModule_MEM][4] = 6000000;
+
+        out_stats->timeInStateMs[SysClkProfile_Handheld][SysClkModule_CPU][4] = 1200000;
+        out_stats->timeInStateMs[SysClkProfile_Handheld][SysClkModule_GPU][3] = 900000;
+        out_stats->timeInStateMs[SysClkProfile_Handheld][SysClkModule_GPU][5] = 300000;
+        out_stats->timeInStateMs[SysClkProfile_Handheld][SysClkModule_MEM][3] = 1200000;
+
+        out_stats->throttledMs[SysClkModule_GPU] = 84000;
+        out_stats->throttleEpisodes[SysClkModule_GPU] = 3;
+    }
+
+    return 0;
+}
+
+Result sysclkIpcGetSessions(u64 tid, SysClkSessionSummary* list, u32 maxCount, u32* outCount)
+{
+    *outCount = 0;
+
+    if(tid == 0x010000000000F002)
+    {
+        for(u32 i = 0; i < 3 && i < maxCount; i++)
+        {
+            SysClkSessionSummary* session = &list[i];
+            memset(session, 0, sizeof(SysClkSessionSummary));
+            session->tid = tid;
+            session->startTime = 1700000000 + i * 86400;
+            session->durationMs = 2700000 + i * 600000;
+            session->energyMj = -(s32)(session->durationMs / 1000) * 7200;
+            session->profileMask = 1 << SysClkProfile_Handheld;
+            session->avgTemps[SysClkThermalSensor_SOC] = 48200 + i * 500;
+            session->peakTemps[SysClkThermalSensor_SOC] = 53100 + i * 500;
+            session->avgTemps[SysClkThermalSensor_PCB] = 45700;
+            session->peakTemps[SysClkThermalSensor_PCB] = 47300;
+            session->avgFreqs[SysClkModule_CPU] = 1224000000;
+            session->avgFreqs[SysClkModule_GPU] = 307200000;
+            session->avgFreqs[SysClkModule_MEM] = 1600000000;
+            (*outCount)++;
+        }
+    }
+
+    return 0;
+}
+
+Result sysclkIpcGetMetrics(SysClkMetrics* out_metrics)
+{
+    memset(out_metrics, 0, sizeof(SysClkMetrics));
+
+    out_metrics->uptimeMs = 3600000;
+    out_metrics->counters[SysClkMetricCounter_ClkrstCalls] = 107820;
+    out_metrics->counters[SysClkMetricCounter_ApmCalls] = 12000;
+    out_metrics->counters[SysClkMetricCounter_PsmCalls] = 12000;
+    out_metrics->counters[SysClkMetricCounter_PmCalls] = 24000;
+    out_metrics->counters[SysClkMetricCounter_I2cCalls] = 10800;
+    out_metrics->counters[SysClkMetricCounter_TcCalls] = 12000;
+    out_metrics->counters[SysClkMetricCounter_ConfigReloads] = 2;
+    out_metrics->counters[SysClkMetricCounter_ConfigChecks] = 720;
+    out_metrics->counters[SysClkMetricCounter_ClockSets] = 18;
+    out_metrics->counters[SysClkMetricCounter_SdWrites] = 732;
+    out_metrics->counters[SysClkMetricCounter_ServiceErrors] = 2;
+
+    SysClkMetricsHistogram* tick = &out_metrics->histograms[SysClkMetricHistogram_Tick];
+    tick->count = 12000;
+    tick->sumUs = tick->count * 850ULL;
+    tick->minUs = 610;
+    tick->maxUs = 302140;
+    tick->buckets[10] = 11000;
+    tick->buckets[11] = 980;
+    tick->buckets[19] = 20;
+
+    SysClkMetricsHistogram* ctx = &out_metrics->ipc[SysClkIpcCmd_GetCurrentContext];
+    ctx->count = 4200;
+    ctx->sumUs = ctx->count * 40ULL;
+    ctx->minUs = 22;
+    ctx->maxUs = 310;
+    ctx->buckets[6] = 4150;
+    ctx->buckets[9] = 50;
+
+    SysClkMetricsHistogram* launch = &out_metrics->histograms[SysClkMetricHistogram_AppLaunchApply];
+    launch->count = 3;
+    launch->sumUs = 3 * 612000ULL;
+    launch->minUs = 540210;
+    launch->maxUs = 701880;
+    launch->buckets[19] = 3;
+
+    return 0;
+}
+
+Result sysclkIpcSetTraceEnabled(bool enabled)
+{
+    return 0;
+}
+
+Result sysclkIpcDumpTrace()
+{
+    return 0;
+}
+
+Result sysclkIpcDumpFlightRecorder()
+{
+    return 0;
+}
+
+Result sysclkIpcReloadConfig()
+{
+    return 0;
+}
+
+Result sysclkIpcGetSelfUsage(SysClkSelfUsage* out_usage)
+{
+    memset(out_usage, 0, sizeof(SysClkSelfUsage));
+
+    out_usage->cpuTimeUs[SysClkThread_Tick] = 10200000;
+    out_usage->cpuTimeUs[SysClkThread_Ipc] = 168000;
+    out_usage->wakeups[SysClkThread_Tick] = 12000;
+    out_usage->wakeups[SysClkThread_Ipc] = 4200;
+    out_usage->cpuPermille[SysClkThread_Tick] = 3;
+    out_usage->wakeupsPerMin[SysClkThread_Tick] = 200;
+    out_usage->wakeupsPerMin[SysClkThread_Ipc] = 70;
+    out_usage->pollingIntervalMs = 300;
+    out_usage->backoff = 1;
+    out_usage->heapSize = 0x30000;
+    out_usage->heapUsed = 0xE340;
+    out_usage->heapPeak = 0x15000;
+    out_usage->arenaSize = 0x6000;
+    out_usage->arenaUsed = 0x5400;
+    out_usage->stackSize[SysClkThread_Tick] = 0x4000;
+    out_usage->stackPeak[SysClkThread_Tick] = 0x1A30;
+    out_usage->stackSize[SysClkThread_Ipc] = 0x2000;
+    out_usage->stackPeak[SysClkThread_Ipc] = 0x9C0;
+    out_usage->startupReadyMs = 412;
+    out_usage->startupFirstApplyMs = 3630;
+
+    return 0;
+}
+
 SysClkShimServer::SysClkShimServer()
 {
     this->store = std::map<std::tuple<u64, SysClkModule, SysClkProfile>, u32>();
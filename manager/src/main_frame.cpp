@@ -24,6 +24,7 @@
 #include "advanced_settings_tab.h"
 #include "app_profiles_tab.h"
 #include "cheat_sheet_tab.h"
+#include "diagnostics_tab.h"
 #include "about_tab.h"
 #include "logo.h"
 
@@ -43,6 +44,7 @@ MainFrame::MainFrame() : TabFrame()
     this->addTab("Status", new StatusTab(this->refreshTask));
     this->addTab("Application Profiles", tab);
     this->addTab("Advanced Settings", new AdvancedSettingsTab());
+    this->addTab("Diagnostics", new DiagnosticsTab());
 
     this->addSeparator();
 
@@ -20,6 +20,8 @@
 
 #include "refresh_task.h"
 
+#include <cstring>
+
 #include "utils.h"
 
 #define REFRESH_INTERVAL 400
@@ -31,11 +33,11 @@ RefreshTask::RefreshTask() : RepeatingTask(REFRESH_INTERVAL)
 
 void RefreshTask::onStart()
 {
-    Result rc = sysclkIpcGetCurrentContext(&this->oldContext);
+    Result rc = sysclkIpcGetContextExt(&this->oldContextExt);
     if (R_FAILED(rc))
     {
         brls::Logger::error("Unable to get context");
-        errorResult("sysclkIpcGetCurrentContext", rc);
+        errorResult("sysclkIpcGetContextExt", rc);
     }
 }
 
@@ -44,59 +46,85 @@ void RefreshTask::run(retro_time_t currentTime)
     RepeatingTask::run(currentTime);
 
     // Get new context
-    SysClkContext context;
-    if (R_SUCCEEDED(sysclkIpcGetCurrentContext(&context)))
+    SysClkContextExt contextExt;
+    if (R_SUCCEEDED(sysclkIpcGetContextExt(&contextExt)))
     {
+        SysClkContext& context = contextExt.context;
+        SysClkContext& oldContext = this->oldContextExt.context;
+
         // CPU Freq
-        if (context.freqs[SysClkModule_CPU] != this->oldContext.freqs[SysClkModule_CPU])
+        if (context.freqs[SysClkModule_CPU] != oldContext.freqs[SysClkModule_CPU])
             this->freqUpdateEvent.fire(SysClkModule_CPU, context.freqs[SysClkModule_CPU]);
 
         // GPU Freq
-        if (context.freqs[SysClkModule_GPU] != this->oldContext.freqs[SysClkModule_GPU])
+        if (context.freqs[SysClkModule_GPU] != oldContext.freqs[SysClkModule_GPU])
             this->freqUpdateEvent.fire(SysClkModule_GPU, context.freqs[SysClkModule_GPU]);
 
         // MEM Freq
-        if (context.freqs[SysClkModule_MEM] != this->oldContext.freqs[SysClkModule_MEM])
+        if (context.freqs[SysClkModule_MEM] != oldContext.freqs[SysClkModule_MEM])
             this->freqUpdateEvent.fire(SysClkModule_MEM, context.freqs[SysClkModule_MEM]);
 
         // Real CPU Freq
-        if (context.realFreqs[SysClkModule_CPU] != this->oldContext.realFreqs[SysClkModule_CPU])
+        if (context.realFreqs[SysClkModule_CPU] != oldContext.realFreqs[SysClkModule_CPU])
             this->realFreqUpdateEvent.fire(SysClkModule_CPU, context.realFreqs[SysClkModule_CPU]);
 
         // Real GPU Freq
-        if (context.realFreqs[SysClkModule_GPU] != this->oldContext.realFreqs[SysClkModule_GPU])
+        if (context.realFreqs[SysClkModule_GPU] != oldContext.realFreqs[SysClkModule_GPU])
             this->realFreqUpdateEvent.fire(SysClkModule_GPU, context.realFreqs[SysClkModule_GPU]);
 
         // Real MEM Freq
-        if (context.realFreqs[SysClkModule_MEM] != this->oldContext.realFreqs[SysClkModule_MEM])
+        if (context.realFreqs[SysClkModule_MEM] != oldContext.realFreqs[SysClkModule_MEM])
             this->realFreqUpdateEvent.fire(SysClkModule_MEM, context.realFreqs[SysClkModule_MEM]);
 
         // Application ID
-        if (context.applicationId != this->oldContext.applicationId)
+        if (context.applicationId != oldContext.applicationId)
             this->appIdUpdateEvent.fire(context.applicationId);
 
         // Profile
-        if (context.profile != this->oldContext.profile)
+        if (context.profile != oldContext.profile)
             this->profileUpdateEvent.fire(context.profile);
 
         // Only notify temp changes every other tick
         if (this->shouldNotifyTempChange)
         {
             // PCB Temp
-            if (context.temps[SysClkThermalSensor_PCB] != this->oldContext.temps[SysClkThermalSensor_PCB])
+            if (context.temps[SysClkThermalSensor_PCB] != oldContext.temps[SysClkThermalSensor_PCB])
                 this->tempUpdateEvent.fire(SysClkThermalSensor_PCB, context.temps[SysClkThermalSensor_PCB]);
 
             //SoC Temp
-            if (context.temps[SysClkThermalSensor_SOC] != this->oldContext.temps[SysClkThermalSensor_SOC])
+            if (context.temps[SysClkThermalSensor_SOC] != oldContext.temps[SysClkThermalSensor_SOC])
                 this->tempUpdateEvent.fire(SysClkThermalSensor_SOC, context.temps[SysClkThermalSensor_SOC]);
 
             //Skin Temp
-            if (context.temps[SysClkThermalSensor_Skin] != this->oldContext.temps[SysClkThermalSensor_Skin])
+            if (context.temps[SysClkThermalSensor_Skin] != oldContext.temps[SysClkThermalSensor_Skin])
                 this->tempUpdateEvent.fire(SysClkThermalSensor_Skin, context.temps[SysClkThermalSensor_Skin]);
         }
 
+        // CPU load
+        for (int core = 0; core < SysClkCpuCore_EnumMax; core++)
+        {
+            if (contextExt.cpuLoad[core] != this->oldContextExt.cpuLoad[core])
+                this->cpuLoadUpdateEvent.fire((SysClkCpuCore)core, contextExt.cpuLoad[core]);
+        }
+
+        // RAM bandwidth
+        for (int load = 0; load < SysClkRamLoad_EnumMax; load++)
+        {
+            if (contextExt.ramBandwidth[load] != this->oldContextExt.ramBandwidth[load])
+                this->ramBandwidthUpdateEvent.fire((SysClkRamLoad)load, contextExt.ramBandwidth[load]);
+        }
+
+        // Battery
+        if (memcmp(contextExt.battery, this->oldContextExt.battery, sizeof(contextExt.battery)) || contextExt.timeToEmptyMin != this->oldContextExt.timeToEmptyMin
+            || contextExt.chargerPowerMw != this->oldContextExt.chargerPowerMw)
+            this->batteryUpdateEvent.fire(&contextExt);
+
+        // Fan
+        if (contextExt.fanLevel != this->oldContextExt.fanLevel)
+            this->fanUpdateEvent.fire(contextExt.fanLevel);
+
         this->shouldNotifyTempChange = !this->shouldNotifyTempChange;
-        this->oldContext = context;
+        this->oldContextExt = contextExt;
     }
     else
     {
@@ -30,17 +30,25 @@ typedef brls::Event<SysClkModule, uint32_t> FreqUpdateEvent;
 typedef brls::Event<uint64_t> AppIdUpdateEvent;
 typedef brls::Event<SysClkProfile> ProfileUpdateEvent;
 typedef brls::Event<SysClkThermalSensor, uint32_t> TempUpdateEvent;
+typedef brls::Event<SysClkCpuCore, uint32_t> CpuLoadUpdateEvent;
+typedef brls::Event<SysClkRamLoad, uint32_t> RamBandwidthUpdateEvent;
+typedef brls::Event<const SysClkContextExt*> BatteryUpdateEvent;
+typedef brls::Event<uint32_t> FanUpdateEvent;
 
 class RefreshTask : public brls::RepeatingTask
 {
     private:
-        SysClkContext oldContext;
+        SysClkContextExt oldContextExt;
 
         FreqUpdateEvent freqUpdateEvent;
         FreqUpdateEvent realFreqUpdateEvent;
         AppIdUpdateEvent appIdUpdateEvent;
         ProfileUpdateEvent profileUpdateEvent;
         TempUpdateEvent tempUpdateEvent;
+        CpuLoadUpdateEvent cpuLoadUpdateEvent;
+        RamBandwidthUpdateEvent ramBandwidthUpdateEvent;
+        BatteryUpdateEvent batteryUpdateEvent;
+        FanUpdateEvent fanUpdateEvent;
 
         bool shouldNotifyTempChange = true;
 
@@ -85,4 +93,32 @@ class RefreshTask : public brls::RepeatingTask
         inline void unregisterTempListener(TempUpdateEvent::Subscription subscription) {
             this->tempUpdateEvent.unsubscribe(subscription);
         }
+
+        inline CpuLoadUpdateEvent::Subscription registerCpuLoadListener(CpuLoadUpdateEvent::Callback cb) {
+            return this->cpuLoadUpdateEvent.subscribe(cb);
+        }
+        inline void unregisterCpuLoadListener(CpuLoadUpdateEvent::Subscription subscription) {
+            this->cpuLoadUpdateEvent.unsubscribe(subscription);
+        }
+
+        inline RamBandwidthUpdateEvent::Subscription registerRamBandwidthListener(RamBandwidthUpdateEvent::Callback cb) {
+            return this->ramBandwidthUpdateEvent.subscribe(cb);
+        }
+        inline void unregisterRamBandwidthListener(RamBandwidthUpdateEvent::Subscription subscription) {
+            this->ramBandwidthUpdateEvent.unsubscribe(subscription);
+        }
+
+        inline BatteryUpdateEvent::Subscription registerBatteryListener(BatteryUpdateEvent::Callback cb) {
+            return this->batteryUpdateEvent.subscribe(cb);
+        }
+        inline void unregisterBatteryListener(BatteryUpdateEvent::Subscription subscription) {
+            this->batteryUpdateEvent.unsubscribe(subscription);
+        }
+
+        inline FanUpdateEvent::Subscription registerFanListener(FanUpdateEvent::Callback cb) {
+            return this->fanUpdateEvent.subscribe(cb);
+        }
+        inline void unregisterFanListener(FanUpdateEvent::Subscription subscription) {
+            this->fanUpdateEvent.unsubscribe(subscription);
+        }
 };
@@ -32,13 +32,14 @@ StatusTab::StatusTab(RefreshTask *refreshTask) :
     refreshTask(refreshTask)
 {
     // Get context
-    SysClkContext context;
-    Result rc = sysclkIpcGetCurrentContext(&context);
+    SysClkContextExt contextExt;
+    SysClkContext& context = contextExt.context;
+    Result rc = sysclkIpcGetContextExt(&contextExt);
 
     if (R_FAILED(rc))
     {
         brls::Logger::error("Unable to get context");
-        errorResult("sysclkIpcGetCurrentContext", rc);
+        errorResult("sysclkIpcGetContextExt", rc);
         brls::Application::crash("Could not get the current sys-clk context, please check that it is correctly installed and enabled.");
         return;
     }
@@ -107,7 +108,7 @@ StatusTab::StatusTab(RefreshTask *refreshTask) :
     freqsBox->addView(realFreqsLayout);
 
     // Temperatures
-    brls::Header *temperaturesHeader = new brls::Header("Temperatures");
+    brls::Header *temperaturesHeader = new brls::Header("Temperatures and fan");
     this->addView(temperaturesHeader);
     StatusGrid *tempsLayout = new StatusGrid();
     tempsLayout->setSpacing(22);
@@ -116,6 +117,7 @@ StatusTab::StatusTab(RefreshTask *refreshTask) :
     this->skinTempCell = new StatusCell("Skin", formatTemp(context.temps[SysClkThermalSensor_Skin]));
     this->socTempCell = new StatusCell("SOC", formatTemp(context.temps[SysClkThermalSensor_SOC]));
     this->pcbTempCell = new StatusCell("PCB", formatTemp(context.temps[SysClkThermalSensor_PCB]));
+    this->fanCell = new StatusCell("Fan", formatLoad(contextExt.fanLevel));
 
     if (context.temps[SysClkThermalSensor_SOC] > DANGEROUS_TEMP_THRESHOLD)
         this->socTempCell->setValueColor(DANGEROUS_TEMP_COLOR);
@@ -129,6 +131,7 @@ StatusTab::StatusTab(RefreshTask *refreshTask) :
     tempsLayout->addView(this->socTempCell);
     tempsLayout->addView(this->pcbTempCell);
     tempsLayout->addView(this->skinTempCell);
+    tempsLayout->addView(this->fanCell);
 
     this->addView(tempsLayout);
 
@@ -148,6 +151,57 @@ StatusTab::StatusTab(RefreshTask *refreshTask) :
 
     this->addView(powerLayout);
 
+    // CPU load
+    brls::Header *cpuLoadHeader = new brls::Header("CPU load");
+    this->addView(cpuLoadHeader);
+    StatusGrid *cpuLoadLayout = new StatusGrid();
+    cpuLoadLayout->setSpacing(22);
+    cpuLoadLayout->setHeight(40);
+
+    for (int core = 0; core < SysClkCpuCore_EnumMax; core++)
+    {
+        this->cpuLoadCells[core] = new StatusCell(sysclkFormatCpuCore((SysClkCpuCore)core, true), formatLoad(contextExt.cpuLoad[core]));
+        cpuLoadLayout->addView(this->cpuLoadCells[core]);
+    }
+
+    this->addView(cpuLoadLayout);
+
+    // RAM bandwidth
+    brls::Header *ramBandwidthHeader = new brls::Header("RAM bandwidth");
+    this->addView(ramBandwidthHeader);
+    StatusGrid *ramBandwidthLayout = new StatusGrid();
+    ramBandwidthLayout->setSpacing(22);
+    ramBandwidthLayout->setHeight(40);
+
+    ramBandwidthLayout->addView(new StatusCell("", ""));
+    for (int load = 0; load < SysClkRamLoad_EnumMax; load++)
+    {
+        this->ramBandwidthCells[load] = new StatusCell(sysclkFormatRamLoad((SysClkRamLoad)load, true), formatBandwidth(contextExt.ramBandwidth[load]));
+        ramBandwidthLayout->addView(this->ramBandwidthCells[load]);
+    }
+
+    this->addView(ramBandwidthLayout);
+
+    // Battery
+    brls::Header *batteryHeader = new brls::Header("Battery");
+    this->addView(batteryHeader);
+    StatusGrid *batteryLayout = new StatusGrid();
+    batteryLayout->setSpacing(22);
+    batteryLayout->setHeight(40);
+
+    this->chargeCell = new StatusCell("Charge", "");
+    this->batteryTempCell = new StatusCell("Temperature", "");
+    this->timeLeftCell = new StatusCell("Time left", "");
+    this->chargerCell = new StatusCell("Charger", "");
+
+    batteryLayout->addView(this->chargeCell);
+    batteryLayout->addView(this->batteryTempCell);
+    batteryLayout->addView(this->timeLeftCell);
+    batteryLayout->addView(this->chargerCell);
+    this->updateBattery(&contextExt);
+
+    this->addView(batteryLayout);
+
     // Info
     brls::Header *systemHeader = new brls::Header("System");
     this->addView(systemHeader);
@@ -239,10 +293,30 @@ StatusTab::StatusTab(RefreshTask *refreshTask) :
                 break;
         }
     });
+
+    this->cpuLoadListenerSub = refreshTask->registerCpuLoadListener([this](SysClkCpuCore core, uint32_t load) {
+        this->cpuLoadCells[core]->setValue(formatLoad(load));
+    });
+
+    this->batteryListenerSub = refreshTask->registerBatteryListener([this](const SysClkContextExt *contextExt) {
+        this->updateBattery(contextExt);
+    });
+
+    this->fanListenerSub = refreshTask->registerFanListener([this](uint32_t level) {
+        this->fanCell->setValue(formatLoad(level));
+    });
+
+    this->ramBandwidthListenerSub = refreshTask->registerRamBandwidthListener([this](SysClkRamLoad load, uint32_t mbps) {
+        this->ramBandwidthCells[load]->setValue(formatBandwidth(mbps));
+    });
 }
 
 StatusTab::~StatusTab()
 {
+    refreshTask->unregisterCpuLoadListener(this->cpuLoadListenerSub);
+    refreshTask->unregisterRamBandwidthListener(this->ramBandwidthListenerSub);
+    refreshTask->unregisterBatteryListener(this->batteryListenerSub);
+    refreshTask->unregisterFanListener(this->fanListenerSub);
     refreshTask->unregisterFreqListener(this->freqListenerSub);
     refreshTask->unregisterRealFreqListener(this->realFreqListenerSub);
     refreshTask->unregisterAppIdListener(this->appIdListenerSub);
@@ -250,6 +324,19 @@ StatusTab::~StatusTab()
     refreshTask->unregisterTempListener(this->tempListenerSub);
 }
 
+void StatusTab::updateBattery(const SysClkContextExt *contextExt)
+{
+    this->chargeCell->setValue(formatLoad(contextExt->battery[SysClkBatteryValue_ChargePermille]));
+    this->batteryTempCell->setValue(formatTemp(contextExt->battery[SysClkBatteryValue_TempMilli]));
+
+    if (contextExt->timeToEmptyMin)
+        this->timeLeftCell->setValue(formatDuration(contextExt->timeToEmptyMin * 60000ULL));
+    else
+        this->timeLeftCell->setValue(contextExt->battery[SysClkBatteryValue_AvgCurrentMa] > 0 ? "Charging" : "-");
+
+    this->chargerCell->setValue(contextExt->chargerPowerMw ? formatPower(contextExt->chargerPowerMw) : "-");
+}
+
 StatusGrid::StatusGrid() 
     : BoxLayout(brls::BoxLayoutOrientation::HORIZONTAL)
 {
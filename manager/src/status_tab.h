@@ -68,6 +68,10 @@ class StatusTab : public brls::List
         AppIdUpdateEvent::Subscription appIdListenerSub;
         ProfileUpdateEvent::Subscription profileListenerSub;
         TempUpdateEvent::Subscription tempListenerSub;
+        CpuLoadUpdateEvent::Subscription cpuLoadListenerSub;
+        RamBandwidthUpdateEvent::Subscription ramBandwidthListenerSub;
+        BatteryUpdateEvent::Subscription batteryListenerSub;
+        FanUpdateEvent::Subscription fanListenerSub;
 
         StatusCell *cpuFreqCell;
         StatusCell *gpuFreqCell;
@@ -80,10 +84,21 @@ class StatusTab : public brls::List
         StatusCell *socTempCell;
         StatusCell *pcbTempCell;
         StatusCell *skinTempCell;
+        StatusCell *fanCell;
 
         StatusCell *nowPowerCell;
         StatusCell *avgPowerCell;
 
+        StatusCell *cpuLoadCells[SysClkCpuCore_EnumMax];
+        StatusCell *ramBandwidthCells[SysClkRamLoad_EnumMax];
+
+        StatusCell *chargeCell;
+        StatusCell *batteryTempCell;
+        StatusCell *timeLeftCell;
+        StatusCell *chargerCell;
+
+        void updateBattery(const SysClkContextExt *contextExt);
+
         StatusCell *profileCell;
         StatusCell *tidCell;
 
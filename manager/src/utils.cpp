@@ -74,6 +74,50 @@ std::string formatPower(int32_t power)
     return std::string(str);
 }
 
+std::string formatLoad(uint32_t permille)
+{
+    char str[16];
+    snprintf(str, sizeof(str), "%u.%u%%", permille / 10, permille % 10);
+    return std::string(str);
+}
+
+std::string formatBandwidth(uint32_t mbps)
+{
+    char str[16];
+    if (mbps >= 1000)
+        snprintf(str, sizeof(str), "%u.%u GB/s", mbps / 1000, mbps % 1000 / 100);
+    else
+        snprintf(str, sizeof(str), "%u MB/s", mbps);
+    return std::string(str);
+}
+
+std::string formatDuration(uint64_t ms)
+{
+    char str[24];
+    uint64_t s = ms / 1000;
+
+    if (s >= 3600)
+        snprintf(str, sizeof(str), "%luh %02lum", s / 3600, (s / 60) % 60);
+    else if (s >= 60)
+        snprintf(str, sizeof(str), "%lum %02lus", s / 60, s % 60);
+    else
+        snprintf(str, sizeof(str), "%lus", s);
+
+    return std::string(str);
+}
+
+std::string formatBytes(uint64_t bytes)
+{
+    char str[24];
+
+    if (bytes >= 1024)
+        snprintf(str, sizeof(str), "%.1f KiB", (float)bytes / 1024.0f);
+    else
+        snprintf(str, sizeof(str), "%lu B", bytes);
+
+    return std::string(str);
+}
+
 void errorResult(std::string tag, Result rc)
 {
 #ifdef __SWITCH__
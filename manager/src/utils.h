@@ -40,5 +40,9 @@ std::string formatTid(uint64_t tid);
 std::string formatProfile(SysClkProfile profile);
 std::string formatTemp(uint32_t temp);
 std::string formatPower(int32_t power);
+std::string formatLoad(uint32_t permille);
+std::string formatBandwidth(uint32_t mbps);
+std::string formatDuration(uint64_t ms);
+std::string formatBytes(uint64_t bytes);
 
 void errorResult(std::string tag, Result rc);
@@ -12,18 +12,27 @@
 
 #include "fatal_gui.h"
 
+#define CPU_LOAD_WARNING_PERMILLE 950
+
 BaseMenuGui::BaseMenuGui()
 {
+    this->contextExt = nullptr;
     this->context = nullptr;
+    this->selfUsage = nullptr;
     this->lastContextUpdate = 0;
     this->listElement = nullptr;
 }
 
 BaseMenuGui::~BaseMenuGui()
 {
-    if(this->context)
+    if(this->contextExt)
+    {
+        delete this->contextExt;
+    }
+
+    if(this->selfUsage)
     {
-        delete this->context;
+        delete this->selfUsage;
     }
 }
 
@@ -116,6 +125,63 @@ void BaseMenuGui::preDraw(tsl::gfx::Renderer* renderer)
             snprintf(buf, sizeof(buf), "%d mW", mw);
             renderer->drawString(buf, false, powerOffsets[i].x, y, SMALL_TEXT_SIZE, VALUE_COLOR);
         }
+
+        y += 25;
+
+        renderer->drawString("CPU load:", false, 20, y, SMALL_TEXT_SIZE, DESC_COLOR);
+        for(unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+        {
+            std::uint32_t permille = this->contextExt->cpuLoad[core];
+            snprintf(buf, sizeof(buf), "%u.%u %%", permille / 10, permille % 10);
+            // a saturated core means the title is CPU bound at this clock
+            renderer->drawString(buf, false, 100 + core * 80, y, SMALL_TEXT_SIZE, permille >= CPU_LOAD_WARNING_PERMILLE ? WARNING_COLOR : VALUE_COLOR);
+        }
+
+        y += 25;
+
+        std::uint32_t charge = this->contextExt->battery[SysClkBatteryValue_ChargePermille];
+        renderer->drawString("Battery:", false, 20, y, SMALL_TEXT_SIZE, DESC_COLOR);
+        snprintf(buf, sizeof(buf), "%u.%u %%", charge / 10, charge % 10);
+        renderer->drawString(buf, false, 100, y, SMALL_TEXT_SIZE, VALUE_COLOR);
+
+        // at the smoothed draw, so a profile change shows up within a minute or so
+        std::uint32_t tte = this->contextExt->timeToEmptyMin;
+        renderer->drawString("Time left:", false, 204, y, SMALL_TEXT_SIZE, DESC_COLOR);
+        if(tte)
+            snprintf(buf, sizeof(buf), "%uh %02um", tte / 60, tte % 60);
+        else
+            snprintf(buf, sizeof(buf), "%s", this->contextExt->battery[SysClkBatteryValue_AvgCurrentMa] > 0 ? "Charging" : "-");
+        renderer->drawString(buf, false, 290, y, SMALL_TEXT_SIZE, VALUE_COLOR);
+
+        y += 25;
+
+        std::uint32_t fan = this->contextExt->fanLevel;
+        renderer->drawString("Fan:", false, 20, y, SMALL_TEXT_SIZE, DESC_COLOR);
+        snprintf(buf, sizeof(buf), "%u.%u %%", fan / 10, fan % 10);
+        renderer->drawString(buf, false, 100, y, SMALL_TEXT_SIZE, VALUE_COLOR);
+    }
+
+    if(this->selfUsage)
+    {
+        char buf[32];
+        std::uint32_t y = 295;
+        std::uint32_t permille = 0;
+        std::uint32_t wakeupsPerMin = 0;
+
+        for(unsigned int i = 0; i < SysClkThread_EnumMax; i++)
+        {
+            permille += this->selfUsage->cpuPermille[i];
+            wakeupsPerMin += this->selfUsage->wakeupsPerMin[i];
+        }
+
+        renderer->drawString("sys-clk CPU:", false, 20, y, SMALL_TEXT_SIZE, DESC_COLOR);
+        snprintf(buf, sizeof(buf), "%u.%u %%", permille / 10, permille % 10);
+        // polling is backed off while over budget
+        renderer->drawString(buf, false, 116, y, SMALL_TEXT_SIZE, this->selfUsage->backoff > 1 ? WARNING_COLOR : VALUE_COLOR);
+
+        renderer->drawString("Wakeups:", false, 204, y, SMALL_TEXT_SIZE, DESC_COLOR);
+        snprintf(buf, sizeof(buf), "%u.%u/s", wakeupsPerMin / 60, wakeupsPerMin % 60 / 6);
+        renderer->drawString(buf, false, 276, y, SMALL_TEXT_SIZE, VALUE_COLOR);
     }
 }
 
@@ -126,17 +192,31 @@ void BaseMenuGui::refresh()
     if(armTicksToNs(ticks - this->lastContextUpdate) > 500000000UL)
     {
         this->lastContextUpdate = ticks;
-        if(!this->context)
+        if(!this->contextExt)
         {
-            this->context = new SysClkContext;
+            this->contextExt = new SysClkContextExt;
+            this->context = &this->contextExt->context;
         }
 
-        Result rc = sysclkIpcGetCurrentContext(this->context);
+        Result rc = sysclkIpcGetContextExt(this->contextExt);
         if(R_FAILED(rc))
         {
-            FatalGui::openWithResultCode("sysclkIpcGetCurrentContext", rc);
+            FatalGui::openWithResultCode("sysclkIpcGetContextExt", rc);
             return;
         }
+
+        if(!this->selfUsage)
+        {
+            this->selfUsage = new SysClkSelfUsage;
+        }
+
+        // informational only, not worth a fatal screen
+        rc = sysclkIpcGetSelfUsage(this->selfUsage);
+        if(R_FAILED(rc))
+        {
+            delete this->selfUsage;
+            this->selfUsage = nullptr;
+        }
     }
 }
 
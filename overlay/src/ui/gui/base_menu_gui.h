@@ -16,7 +16,9 @@
 class BaseMenuGui : public BaseGui
 {
     protected:
+        SysClkContextExt* contextExt;
         SysClkContext* context;
+        SysClkSelfUsage* selfUsage;
         std::uint64_t lastContextUpdate;
         tsl::elm::List* listElement;
 
@@ -0,0 +1,27 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <switch.h>
+
+// the service and i2c drivers only exist on console, the core only needs these
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+u64 i2cExtGetTransactionCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#include <nxExt/cpp/lockable_mutex.h>
@@ -0,0 +1,140 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+/*
+ * Host stand-in for the small part of libnx used by the sysmodule core, see
+ * nx_shim.cpp. The system tick is virtual: it only moves when a thread sleeps,
+ * so the tick loop runs as fast as the host allows and always the same way.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+
+typedef u32 Result;
+typedef u32 Handle;
+
+#define R_FAILED(res) ((res) != 0)
+#define R_SUCCEEDED(res) ((res) == 0)
+#define R_MODULE(res) ((res) & 0x1FF)
+#define R_DESCRIPTION(res) (((res) >> 9) & 0x1FFF)
+#define MAKERESULT(module, description) (((module) & 0x1FF) | ((description) & 0x1FFF) << 9)
+
+#define HOST_SHIM_RESULT MAKERESULT(345, 1)
+#define CUR_THREAD_HANDLE 0xFFFF8000
+#define INVALID_HANDLE 0
+
+#define MAKEHOSVERSION(major, minor, micro) (((u32)(major) << 16) | ((u32)(minor) << 8) | (u32)(micro))
+
+typedef enum
+{
+    InfoType_ThreadTickCount = 25,
+} InfoType;
+
+typedef struct
+{
+    u64 addr;
+    u64 size;
+    u32 type;
+    u32 attr;
+    u32 perm;
+    u32 ipc_refcount;
+    u32 device_refcount;
+    u32 padding;
+} MemoryInfo;
+
+typedef pthread_mutex_t Mutex;
+
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool signaled;
+    bool autoclear;
+} UEvent;
+
+typedef struct
+{
+    UEvent* event;
+} Waiter;
+
+typedef void (*ThreadFunc)(void*);
+
+typedef struct
+{
+    Handle handle;
+    void* stack_mem;
+    void* stack_mirror;
+    size_t stack_sz;
+    pthread_t pthread;
+    ThreadFunc entry;
+    void* arg;
+} Thread;
+
+// virtual clock
+u64 armGetSystemTick(void);
+u64 armGetSystemTickFreq(void);
+u64 armNsToTicks(u64 ns);
+u64 armTicksToNs(u64 tick);
+void svcSleepThread(s64 nano);
+
+Result svcGetInfo(u64* out, u32 id0, Handle handle, u64 id1);
+Result svcGetThreadId(u64* out, Handle handle);
+Result svcQueryMemory(MemoryInfo* meminfo_ptr, u32* pageinfo, u64 addr);
+Handle envGetMainThreadHandle(void);
+
+void hosversionSet(u32 version);
+u32 hosversionGet(void);
+bool hosversionAtLeast(u8 major, u8 minor, u8 micro);
+
+void mutexInit(Mutex* m);
+void mutexLock(Mutex* m);
+bool mutexTryLock(Mutex* m);
+void mutexUnlock(Mutex* m);
+
+void ueventCreate(UEvent* e, bool autoclear);
+void ueventSignal(UEvent* e);
+void ueventClear(UEvent* e);
+Waiter waiterForUEvent(UEvent* e);
+Result waitSingle(Waiter w, u64 timeout);
+
+Result threadCreate(Thread* t, ThreadFunc entry, void* arg, void* stack_mem, size_t stack_sz, int prio, int cpuid);
+Result threadStart(Thread* t);
+Result threadWaitForExit(Thread* t);
+Result threadClose(Thread* t);
+
+// the host file system is always there
+Result timeInitialize(void);
+void timeExit(void);
+void __libnx_init_time(void);
+Result fsInitialize(void);
+void fsExit(void);
+Result fsdevMountSdmc(void);
+int fsdevUnmountAll(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,198 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file_utils.h"
+#include "board.h"
+#include "clock_manager.h"
+#include "metrics.h"
+#include "trace.h"
+#include "arena.h"
+#include "sim_board.h"
+#include "replay_board.h"
+
+static void Usage(const char* name)
+{
+    fprintf(stderr, "usage: %s [-C work_dir] [-c config.ini] scenario.txt\n", name);
+    fprintf(stderr, "       %s [-C work_dir] [-c config.ini] -r record.bin\n", name);
+    fprintf(stderr, "  clock sets are printed on stdout, a summary on stderr\n");
+    fprintf(stderr, "  -r replays a recording and marks decisions that differ with -/+, exit code 2 if any\n");
+}
+
+static bool CopyFile(const char* from, const char* to)
+{
+    FILE* in = fopen(from, "rb");
+    FILE* out = in ? fopen(to, "wb") : NULL;
+    char buffer[0x1000];
+    std::size_t size;
+    bool ok = in && out;
+
+    while (ok && (size = fread(buffer, 1, sizeof(buffer), in)) > 0)
+    {
+        ok = fwrite(buffer, 1, size, out) == size;
+    }
+
+    if (in)
+    {
+        fclose(in);
+    }
+    if (out)
+    {
+        fclose(out);
+    }
+
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    const char* workDir = ".";
+    const char* configPath = NULL;
+    bool replay = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "C:c:rh")) != -1)
+    {
+        switch (opt)
+        {
+            case 'C':
+                workDir = optarg;
+                break;
+            case 'c':
+                configPath = optarg;
+                break;
+            case 'r':
+                replay = true;
+                break;
+            default:
+                Usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind != argc - 1)
+    {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    // everything is resolved before moving into the work dir
+    char scenarioPath[PATH_MAX];
+    char configFullPath[PATH_MAX];
+    if (!realpath(argv[optind], scenarioPath))
+    {
+        fprintf(stderr, "%s: %s\n", argv[optind], strerror(errno));
+        return 1;
+    }
+
+    if (configPath && !realpath(configPath, configFullPath))
+    {
+        fprintf(stderr, "%s: %s\n", configPath, strerror(errno));
+        return 1;
+    }
+
+    if (chdir(workDir))
+    {
+        fprintf(stderr, "%s: %s\n", workDir, strerror(errno));
+        return 1;
+    }
+
+    mkdir("config", 0777);
+    mkdir(FILE_CONFIG_DIR, 0777);
+    if (configPath && !CopyFile(configFullPath, FILE_CONFIG_DIR "/config.ini"))
+    {
+        fprintf(stderr, "%s: cannot copy to %s/%s\n", configPath, workDir, FILE_CONFIG_DIR);
+        return 1;
+    }
+
+    // freq lists come from the scenario or the recording, never from a previous run
+    remove(FILE_FREQ_CACHE_PATH);
+
+    SimBoard* simBoard = NULL;
+    ReplayBoard* replayBoard = NULL;
+    BoardBackend* board = NULL;
+    bool loaded = false;
+    if (replay)
+    {
+        board = replayBoard = new ReplayBoard(stdout);
+        loaded = replayBoard->Load(scenarioPath);
+    }
+    else
+    {
+        board = simBoard = new SimBoard(stdout);
+        loaded = simBoard->Load(scenarioPath);
+    }
+
+    if (!loaded)
+    {
+        delete board;
+        return 1;
+    }
+
+    // same sequence as the sysmodule, minus the ipc service
+    Metrics::MarkStart();
+    FileUtils::Initialize();
+    Board::Initialize(board);
+    Trace::Initialize();
+    ClockManager* clockMgr = new ClockManager();
+    Arena::Seal();
+    Metrics::MarkReady();
+
+    clockMgr->SetRunning(true);
+    clockMgr->GetConfig()->SetEnabled(true);
+
+    std::uint64_t ticks = 0;
+    auto wallStart = std::chrono::steady_clock::now();
+
+    if (replayBoard)
+    {
+        // the recording paces the ticks, polling interval and backoff do not apply
+        while (clockMgr->Running() && replayBoard->NextTick(clockMgr->GetConfig()))
+        {
+            clockMgr->Tick();
+            ticks++;
+        }
+    }
+    else
+    {
+        while (clockMgr->Running() && !simBoard->Finished())
+        {
+            clockMgr->Tick();
+            clockMgr->WaitForNextTick();
+            ticks++;
+        }
+    }
+
+    std::uint64_t wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - wallStart).count();
+    std::uint64_t simMs = replayBoard ? replayBoard->GetElapsedMs() : simBoard->GetElapsedMs();
+    fprintf(stderr, "%" PRIu64 " ticks, %" PRIu64 " ms simulated in %" PRIu64 " ms (x%" PRIu64 ")\n", ticks, simMs, wallMs, simMs / (wallMs ? wallMs : 1));
+
+    int status = 0;
+    if (replayBoard)
+    {
+        fprintf(stderr, "%u recorded decisions, %u ticks differ\n", replayBoard->GetDecisionCount(), replayBoard->GetDifferenceCount());
+        status = replayBoard->GetDifferenceCount() ? 2 : 0;
+    }
+
+    delete clockMgr;
+    InputRecorder::Exit();
+    Board::Exit();
+    FileUtils::Exit();
+    return status;
+}
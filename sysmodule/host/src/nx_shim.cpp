@@ -0,0 +1,224 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include <switch.h>
+#include <nxExt.h>
+#include <atomic>
+
+#define NX_SHIM_TICK_FREQ 19200000ULL
+
+// starts at 1 s, 0 is used as "never" all over the sysmodule
+static std::atomic_uint64_t g_tick{NX_SHIM_TICK_FREQ};
+static u32 g_hos_version = MAKEHOSVERSION(16, 0, 0);
+
+extern "C"
+{
+    char* fake_heap_start = NULL;
+    char* fake_heap_end = NULL;
+
+    u64 armGetSystemTick(void)
+    {
+        return g_tick;
+    }
+
+    u64 armGetSystemTickFreq(void)
+    {
+        return NX_SHIM_TICK_FREQ;
+    }
+
+    u64 armNsToTicks(u64 ns)
+    {
+        return (ns * 12) / 625;
+    }
+
+    u64 armTicksToNs(u64 tick)
+    {
+        return (tick * 625) / 12;
+    }
+
+    void svcSleepThread(s64 nano)
+    {
+        if (nano > 0)
+        {
+            g_tick += armNsToTicks(nano);
+        }
+    }
+
+    Result svcGetInfo(u64* out, u32 id0, Handle handle, u64 id1)
+    {
+        return HOST_SHIM_RESULT;
+    }
+
+    Result svcGetThreadId(u64* out, Handle handle)
+    {
+        *out = 1;
+        return 0;
+    }
+
+    Result svcQueryMemory(MemoryInfo* meminfo_ptr, u32* pageinfo, u64 addr)
+    {
+        return HOST_SHIM_RESULT;
+    }
+
+    Handle envGetMainThreadHandle(void)
+    {
+        return INVALID_HANDLE;
+    }
+
+    void hosversionSet(u32 version)
+    {
+        g_hos_version = version;
+    }
+
+    u32 hosversionGet(void)
+    {
+        return g_hos_version;
+    }
+
+    bool hosversionAtLeast(u8 major, u8 minor, u8 micro)
+    {
+        return g_hos_version >= MAKEHOSVERSION(major, minor, micro);
+    }
+
+    void mutexInit(Mutex* m)
+    {
+        pthread_mutex_init(m, NULL);
+    }
+
+    void mutexLock(Mutex* m)
+    {
+        pthread_mutex_lock(m);
+    }
+
+    bool mutexTryLock(Mutex* m)
+    {
+        return pthread_mutex_trylock(m) == 0;
+    }
+
+    void mutexUnlock(Mutex* m)
+    {
+        pthread_mutex_unlock(m);
+    }
+
+    void ueventCreate(UEvent* e, bool autoclear)
+    {
+        pthread_mutex_init(&e->mutex, NULL);
+        pthread_cond_init(&e->cond, NULL);
+        e->signaled = false;
+        e->autoclear = autoclear;
+    }
+
+    void ueventSignal(UEvent* e)
+    {
+        pthread_mutex_lock(&e->mutex);
+        e->signaled = true;
+        pthread_cond_broadcast(&e->cond);
+        pthread_mutex_unlock(&e->mutex);
+    }
+
+    void ueventClear(UEvent* e)
+    {
+        pthread_mutex_lock(&e->mutex);
+        e->signaled = false;
+        pthread_mutex_unlock(&e->mutex);
+    }
+
+    Waiter waiterForUEvent(UEvent* e)
+    {
+        Waiter w = { e };
+        return w;
+    }
+
+    // timeouts are ignored: they would be virtual, and only UINT64_MAX is used
+    Result waitSingle(Waiter w, u64 timeout)
+    {
+        pthread_mutex_lock(&w.event->mutex);
+        while (!w.event->signaled)
+        {
+            pthread_cond_wait(&w.event->cond, &w.event->mutex);
+        }
+        if (w.event->autoclear)
+        {
+            w.event->signaled = false;
+        }
+        pthread_mutex_unlock(&w.event->mutex);
+        return 0;
+    }
+
+    static void* ThreadEntry(void* arg)
+    {
+        Thread* t = (Thread*)arg;
+        t->entry(t->arg);
+        return NULL;
+    }
+
+    Result threadCreate(Thread* t, ThreadFunc entry, void* arg, void* stack_mem, size_t stack_sz, int prio, int cpuid)
+    {
+        t->handle = INVALID_HANDLE;
+        t->stack_mem = NULL;
+        t->stack_mirror = NULL;
+        t->stack_sz = 0;
+        t->entry = entry;
+        t->arg = arg;
+        return 0;
+    }
+
+    Result threadStart(Thread* t)
+    {
+        return pthread_create(&t->pthread, NULL, ThreadEntry, t) ? HOST_SHIM_RESULT : 0;
+    }
+
+    Result threadWaitForExit(Thread* t)
+    {
+        return pthread_join(t->pthread, NULL) ? HOST_SHIM_RESULT : 0;
+    }
+
+    Result threadClose(Thread* t)
+    {
+        return 0;
+    }
+
+    Result timeInitialize(void)
+    {
+        return 0;
+    }
+
+    void timeExit(void)
+    {
+    }
+
+    void __libnx_init_time(void)
+    {
+    }
+
+    Result fsInitialize(void)
+    {
+        return 0;
+    }
+
+    void fsExit(void)
+    {
+    }
+
+    Result fsdevMountSdmc(void)
+    {
+        return 0;
+    }
+
+    int fsdevUnmountAll(void)
+    {
+        return 0;
+    }
+
+    u64 i2cExtGetTransactionCount(void)
+    {
+        return 0;
+    }
+}
@@ -0,0 +1,483 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "replay_board.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+ReplayBoard::ReplayBoard(FILE* out)
+{
+    this->out = out;
+    this->offset = 0;
+    this->startTick = 0;
+    this->recordedUs = 0;
+    this->decisionCount = 0;
+    this->differenceCount = 0;
+    this->socType = SysClkSocType_Erista;
+    this->applicationId = 0;
+    this->profile = SysClkProfile_Handheld;
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        this->hz[module] = 0;
+        this->recordedSetHz[module] = 0;
+        this->realHz[module] = 0;
+        this->freqCounts[module] = 0;
+    }
+    for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+    {
+        this->temps[sensor] = 0;
+    }
+    for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+    {
+        this->power[sensor] = 0;
+    }
+    for (unsigned int value = 0; value < SysClkBatteryValue_EnumMax; value++)
+    {
+        this->battery[value] = 0;
+    }
+    this->fanLevel = 0;
+    this->chargerPowerMw = 0;
+    for (unsigned int load = 0; load < SysClkRamLoad_EnumMax; load++)
+    {
+        this->ramLoad[load] = 0;
+        this->ramBandwidth[load] = 0;
+    }
+    for (unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+    {
+        this->cpuLoad[core] = 0;
+    }
+}
+
+bool ReplayBoard::Load(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    std::uint8_t buffer[0x1000];
+    std::size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        this->data.insert(this->data.end(), buffer, buffer + size);
+    }
+    fclose(file);
+
+    InputRecordFileHeader header;
+    if (this->data.size() < sizeof(header))
+    {
+        fprintf(stderr, "%s: truncated header\n", path);
+        return false;
+    }
+
+    memcpy(&header, &this->data[0], sizeof(header));
+    if (header.magic != INPUT_RECORD_MAGIC || header.version != INPUT_RECORD_VERSION)
+    {
+        fprintf(stderr, "%s: not a version %u input recording\n", path, INPUT_RECORD_VERSION);
+        return false;
+    }
+
+    this->socType = header.socType == SysClkSocType_Mariko ? SysClkSocType_Mariko : SysClkSocType_Erista;
+    this->offset = sizeof(header);
+
+    // the freq table is written right after the first tick, it is needed before that
+    InputRecordHeader record;
+    const std::uint8_t* payload;
+    std::size_t start = this->offset;
+    unsigned int ticks = 0;
+    while (ticks < 2 && this->ReadRecord(&record, &payload))
+    {
+        if (record.type == InputRecordType_Tick)
+        {
+            ticks++;
+        }
+        else if (record.type == InputRecordType_FreqList && record.index < SysClkModule_EnumMax)
+        {
+            this->freqCounts[record.index] = std::min((std::size_t)SYSCLK_FREQ_LIST_MAX, record.size / sizeof(std::uint32_t));
+            memcpy(this->freqLists[record.index], payload, this->freqCounts[record.index] * sizeof(std::uint32_t));
+        }
+    }
+    this->offset = start;
+
+    return true;
+}
+
+bool ReplayBoard::ReadRecord(InputRecordHeader* header, const std::uint8_t** payload)
+{
+    if (this->offset + sizeof(*header) > this->data.size())
+    {
+        return false;
+    }
+
+    memcpy(header, &this->data[this->offset], sizeof(*header));
+    if (this->offset + sizeof(*header) + header->size > this->data.size())
+    {
+        fprintf(stderr, "truncated record at offset %zu\n", this->offset);
+        this->offset = this->data.size();
+        return false;
+    }
+
+    *payload = &this->data[this->offset + sizeof(*header)];
+    this->offset += sizeof(*header) + header->size;
+    return true;
+}
+
+bool ReplayBoard::NextTick(Config* config)
+{
+    this->CompareDecisions();
+
+    // ipc writes land between ticks, they are seen by the tick after the one they were recorded in
+    InputRecordHeader header;
+    const std::uint8_t* payload;
+    std::size_t resume = this->offset;
+    for (std::size_t pending : this->pendingWrites)
+    {
+        this->offset = pending;
+        this->ReadRecord(&header, &payload);
+        this->ApplyWrite(&header, payload, config);
+    }
+    this->pendingWrites.clear();
+    this->offset = resume;
+
+    // skip to the next tick
+    bool ticked = false;
+    while (!ticked && this->ReadRecord(&header, &payload))
+    {
+        ticked = header.type == InputRecordType_Tick && header.size == sizeof(std::uint32_t);
+    }
+
+    if (!ticked)
+    {
+        return false;
+    }
+
+    std::uint32_t us;
+    memcpy(&us, payload, sizeof(us));
+    this->recordedUs += us;
+
+    // the replayed ticks may sleep less than the recorded ones did, never more
+    std::uint64_t target = this->startTick + armNsToTicks(this->recordedUs * 1000ULL);
+    std::uint64_t now = armGetSystemTick();
+    if (target > now)
+    {
+        svcSleepThread(armTicksToNs(target - now));
+    }
+
+    std::size_t start;
+    while ((start = this->offset) < this->data.size() && this->ReadRecord(&header, &payload))
+    {
+        if (header.type == InputRecordType_Tick)
+        {
+            this->offset = start;
+            break;
+        }
+
+        if (header.type == InputRecordType_Profiles || header.type == InputRecordType_ConfigValues)
+        {
+            this->pendingWrites.push_back(start);
+        }
+        else
+        {
+            this->ApplyInput(&header, payload, config);
+        }
+    }
+
+    return true;
+}
+
+void ReplayBoard::ApplyInput(const InputRecordHeader* header, const std::uint8_t* payload, Config* config)
+{
+    std::uint32_t value = 0;
+    std::uint64_t value64 = 0;
+
+    if (header->size == sizeof(value64))
+    {
+        memcpy(&value64, payload, sizeof(value64));
+    }
+    else if (header->size == sizeof(value))
+    {
+        memcpy(&value, payload, sizeof(value));
+        value64 = value;
+    }
+
+    value = (std::uint32_t)value64;
+
+    switch (header->type)
+    {
+        case InputRecordType_ApplicationId:
+            this->applicationId = value64;
+            break;
+        case InputRecordType_Profile:
+            this->profile = SYSCLK_ENUM_VALID(SysClkProfile, value) ? (SysClkProfile)value : SysClkProfile_Handheld;
+            break;
+        case InputRecordType_Hz:
+            if (header->index < SysClkModule_EnumMax && value != this->recordedSetHz[header->index])
+            {
+                this->hz[header->index] = value;
+            }
+            break;
+        case InputRecordType_RealHz:
+            if (header->index < SysClkModule_EnumMax)
+            {
+                this->realHz[header->index] = value;
+            }
+            break;
+        case InputRecordType_Temp:
+            if (header->index < SysClkThermalSensor_EnumMax)
+            {
+                this->temps[header->index] = value;
+            }
+            break;
+        case InputRecordType_Power:
+            if (header->index < SysClkPowerSensor_EnumMax)
+            {
+                this->power[header->index] = (std::int32_t)value;
+            }
+            break;
+        case InputRecordType_ChargerPower:
+            this->chargerPowerMw = value;
+            break;
+        case InputRecordType_FanLevel:
+            this->fanLevel = value;
+            break;
+        case InputRecordType_Battery:
+            if (header->index < SysClkBatteryValue_EnumMax)
+            {
+                this->battery[header->index] = (std::int32_t)value;
+            }
+            break;
+        case InputRecordType_RamLoad:
+            if (header->index < SysClkRamLoad_EnumMax)
+            {
+                this->ramLoad[header->index] = value;
+            }
+            break;
+        case InputRecordType_RamBandwidth:
+            if (header->index < SysClkRamLoad_EnumMax)
+            {
+                this->ramBandwidth[header->index] = value;
+            }
+            break;
+        case InputRecordType_CpuLoad:
+            if (header->index < SysClkCpuCore_EnumMax)
+            {
+                this->cpuLoad[header->index] = value;
+            }
+            break;
+        case InputRecordType_SetHz:
+            if (header->index < SysClkModule_EnumMax)
+            {
+                this->recordedSetHz[header->index] = value;
+                this->recordedDecisions.push_back({ header->index, value });
+            }
+            break;
+        case InputRecordType_ResetToStock:
+            this->recordedDecisions.push_back({ SysClkModule_EnumMax, 0 });
+            break;
+        case InputRecordType_Enabled:
+            config->SetEnabled(value);
+            break;
+        case InputRecordType_Override:
+            if (header->index < SysClkModule_EnumMax)
+            {
+                config->SetOverrideHz((SysClkModule)header->index, value);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void ReplayBoard::ApplyWrite(const InputRecordHeader* header, const std::uint8_t* payload, Config* config)
+{
+    if (header->type == InputRecordType_Profiles && header->size == sizeof(SysClkIpc_SetProfiles_Args))
+    {
+        SysClkIpc_SetProfiles_Args args;
+        memcpy(&args, payload, sizeof(args));
+        config->SetProfiles(args.tid, &args.profiles, true);
+    }
+    else if (header->type == InputRecordType_ConfigValues)
+    {
+        // recordings from builds with fewer config values keep the defaults for the rest
+        SysClkConfigValueList values;
+        config->GetConfigValues(&values);
+        memcpy(&values, payload, std::min((std::size_t)header->size, sizeof(values)));
+        config->SetConfigValues(&values, true);
+    }
+}
+
+void ReplayBoard::CompareDecisions()
+{
+    bool same = this->recordedDecisions.size() == this->replayedDecisions.size();
+    for (std::size_t i = 0; same && i < this->recordedDecisions.size(); i++)
+    {
+        same = this->recordedDecisions[i].module == this->replayedDecisions[i].module && this->recordedDecisions[i].hz == this->replayedDecisions[i].hz;
+    }
+
+    if (same)
+    {
+        for (const Decision& decision : this->recordedDecisions)
+        {
+            this->PrintDecision(" ", &decision);
+        }
+    }
+    else
+    {
+        for (const Decision& decision : this->recordedDecisions)
+        {
+            this->PrintDecision("-", &decision);
+        }
+        for (const Decision& decision : this->replayedDecisions)
+        {
+            this->PrintDecision("+", &decision);
+        }
+        this->differenceCount++;
+    }
+
+    this->decisionCount += this->recordedDecisions.size();
+    this->recordedDecisions.clear();
+    this->replayedDecisions.clear();
+}
+
+void ReplayBoard::PrintDecision(const char* prefix, const Decision* decision)
+{
+    std::uint64_t ms = this->recordedUs / 1000;
+
+    if (decision->module >= SysClkModule_EnumMax)
+    {
+        fprintf(this->out, "%s %8" PRIu64 " ms reset\n", prefix, ms);
+    }
+    else
+    {
+        fprintf(this->out, "%s %8" PRIu64 " ms %s %u.%u MHz\n", prefix, ms, sysclkFormatModule((SysClkModule)decision->module, false), decision->hz / 1000000, decision->hz / 100000 % 10);
+    }
+}
+
+std::uint64_t ReplayBoard::GetElapsedMs()
+{
+    return this->recordedUs / 1000;
+}
+
+std::uint32_t ReplayBoard::GetDecisionCount()
+{
+    return this->decisionCount;
+}
+
+std::uint32_t ReplayBoard::GetDifferenceCount()
+{
+    return this->differenceCount;
+}
+
+void ReplayBoard::Initialize()
+{
+    this->startTick = armGetSystemTick();
+}
+
+void ReplayBoard::Exit()
+{
+}
+
+Result ReplayBoard::ResetToStock()
+{
+    // stock clocks come back as recorded reads
+    this->replayedDecisions.push_back({ SysClkModule_EnumMax, 0 });
+    return 0;
+}
+
+Result ReplayBoard::GetProfile(SysClkProfile* out_profile)
+{
+    *out_profile = this->profile;
+    return 0;
+}
+
+Result ReplayBoard::GetApplicationId(std::uint64_t* out_tid)
+{
+    *out_tid = this->applicationId;
+    return 0;
+}
+
+Result ReplayBoard::SetHz(SysClkModule module, std::uint32_t hz)
+{
+    this->replayedDecisions.push_back({ module, hz });
+    this->hz[module] = hz;
+    return 0;
+}
+
+Result ReplayBoard::GetHz(SysClkModule module, std::uint32_t* out_hz)
+{
+    *out_hz = this->hz[module];
+    return 0;
+}
+
+std::uint32_t ReplayBoard::GetRealHz(SysClkModule module)
+{
+    return this->realHz[module];
+}
+
+Result ReplayBoard::GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount)
+{
+    *outCount = std::min(maxCount, this->freqCounts[module]);
+    memcpy(outList, this->freqLists[module], *outCount * sizeof(*outList));
+    return 0;
+}
+
+std::uint32_t ReplayBoard::GetTemperatureMilli(SysClkThermalSensor sensor)
+{
+    return this->temps[sensor];
+}
+
+void ReplayBoard::GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb)
+{
+    *out_soc = this->temps[SysClkThermalSensor_SOC];
+    *out_pcb = this->temps[SysClkThermalSensor_PCB];
+}
+
+std::uint32_t ReplayBoard::GetFanLevel()
+{
+    return this->fanLevel;
+}
+
+std::uint32_t ReplayBoard::GetChargerPowerMw()
+{
+    return this->chargerPowerMw;
+}
+
+void ReplayBoard::GetBattery(BoardBattery* out_battery)
+{
+    memcpy(out_battery->powerMw, this->power, sizeof(out_battery->powerMw));
+    memcpy(out_battery->values, this->battery, sizeof(out_battery->values));
+}
+
+std::uint32_t ReplayBoard::GetRamLoad(SysClkRamLoad load)
+{
+    return this->ramLoad[load];
+}
+
+std::uint32_t ReplayBoard::GetRamBandwidth(SysClkRamLoad load)
+{
+    return this->ramBandwidth[load];
+}
+
+void ReplayBoard::SetRamSampling(std::uint32_t periodMs, std::uint32_t window)
+{
+}
+
+std::uint32_t ReplayBoard::GetCpuLoad(SysClkCpuCore core)
+{
+    return this->cpuLoad[core];
+}
+
+SysClkSocType ReplayBoard::GetSocType()
+{
+    return this->socType;
+}
@@ -0,0 +1,101 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include <switch.h>
+#include <sysclk.h>
+#include "board_backend.h"
+#include "config.h"
+#include "input_recorder.h"
+
+/*
+ * Plays back a record.bin written by InputRecorder. Each NextTick feeds the
+ * inputs of one recorded tick, then the clock decisions of the replayed tick
+ * are compared with the recorded ones. Matching decisions are printed like
+ * SimBoard prints them, differences as "-" (recorded) and "+" (replayed).
+ *
+ * Clocks read back follow the replayed decisions, a recorded read only wins
+ * when it is not the echo of a recorded decision (reset, another process).
+ */
+class ReplayBoard : public BoardBackend
+{
+  public:
+    ReplayBoard(FILE* out);
+
+    bool Load(const char* path);
+    bool NextTick(Config* config);
+    std::uint64_t GetElapsedMs();
+    std::uint32_t GetDecisionCount();
+    std::uint32_t GetDifferenceCount();
+
+    virtual void Initialize() override;
+    virtual void Exit() override;
+    virtual Result ResetToStock() override;
+    virtual Result GetProfile(SysClkProfile* out_profile) override;
+    virtual Result GetApplicationId(std::uint64_t* out_tid) override;
+    virtual Result SetHz(SysClkModule module, std::uint32_t hz) override;
+    virtual Result GetHz(SysClkModule module, std::uint32_t* out_hz) override;
+    virtual std::uint32_t GetRealHz(SysClkModule module) override;
+    virtual Result GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount) override;
+    virtual std::uint32_t GetTemperatureMilli(SysClkThermalSensor sensor) override;
+    virtual void GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb) override;
+    virtual std::uint32_t GetFanLevel() override;
+    virtual void GetBattery(BoardBattery* out_battery) override;
+    virtual std::uint32_t GetChargerPowerMw() override;
+    virtual std::uint32_t GetRamLoad(SysClkRamLoad load) override;
+    virtual std::uint32_t GetRamBandwidth(SysClkRamLoad load) override;
+    virtual void SetRamSampling(std::uint32_t periodMs, std::uint32_t window) override;
+    virtual std::uint32_t GetCpuLoad(SysClkCpuCore core) override;
+    virtual SysClkSocType GetSocType() override;
+
+  protected:
+    // module is SysClkModule_EnumMax for a reset to stock
+    typedef struct
+    {
+        std::uint32_t module;
+        std::uint32_t hz;
+    } Decision;
+
+    bool ReadRecord(InputRecordHeader* header, const std::uint8_t** payload);
+    void ApplyInput(const InputRecordHeader* header, const std::uint8_t* payload, Config* config);
+    void ApplyWrite(const InputRecordHeader* header, const std::uint8_t* payload, Config* config);
+    void CompareDecisions();
+    void PrintDecision(const char* prefix, const Decision* decision);
+
+    FILE* out;
+    std::vector<std::uint8_t> data;
+    std::size_t offset;
+    std::vector<std::size_t> pendingWrites;
+    std::vector<Decision> recordedDecisions;
+    std::vector<Decision> replayedDecisions;
+    std::uint64_t startTick;
+    std::uint64_t recordedUs;
+    std::uint32_t decisionCount;
+    std::uint32_t differenceCount;
+    SysClkSocType socType;
+    std::uint64_t applicationId;
+    SysClkProfile profile;
+    std::uint32_t hz[SysClkModule_EnumMax];
+    std::uint32_t recordedSetHz[SysClkModule_EnumMax];
+    std::uint32_t realHz[SysClkModule_EnumMax];
+    std::uint32_t temps[SysClkThermalSensor_EnumMax];
+    std::uint32_t fanLevel;
+    std::uint32_t chargerPowerMw;
+    std::int32_t power[SysClkPowerSensor_EnumMax];
+    std::int32_t battery[SysClkBatteryValue_EnumMax];
+    std::uint32_t ramLoad[SysClkRamLoad_EnumMax];
+    std::uint32_t ramBandwidth[SysClkRamLoad_EnumMax];
+    std::uint32_t cpuLoad[SysClkCpuCore_EnumMax];
+    std::uint32_t freqCounts[SysClkModule_EnumMax];
+    std::uint32_t freqLists[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX];
+};
@@ -0,0 +1,387 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "sim_board.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+#define SIM_QLAUNCH_TID 0x0100000000001000ULL
+#define SIM_EMC_BYTES_PER_CLOCK 16
+
+static const std::uint32_t g_freq_lists[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX] = {
+    { 204000000, 306000000, 408000000, 510000000, 612000000, 714000000, 816000000, 918000000, 1020000000, 1122000000, 1224000000, 1326000000, 1428000000, 1581000000, 1683000000, 1785000000 },
+    { 76800000, 153600000, 230400000, 307200000, 384000000, 460800000, 537600000, 614400000, 691200000, 768000000, 844800000, 921600000 },
+    { 204000000, 665600000, 800000000, 1065600000, 1331200000, 1600000000 },
+};
+
+static const std::uint32_t g_freq_counts[SysClkModule_EnumMax] = { 16, 12, 6 };
+
+static const std::uint32_t g_stock_hz[2][SysClkModule_EnumMax] = {
+    { 1020000000, 384000000, 1331200000 },
+    { 1020000000, 768000000, 1600000000 },
+};
+
+template<typename T>
+static bool ParseName(const char* name, const char* (*format)(T, bool), unsigned int count, T* out)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        if (!strcmp(name, format((T)i, false)))
+        {
+            *out = (T)i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+SimBoard::SimBoard(FILE* out)
+{
+    this->out = out;
+    this->startTick = 0;
+    this->endMs = 0;
+    this->socType = SysClkSocType_Erista;
+    this->app.linear = false;
+    this->profile.linear = false;
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        this->hz[module] = 0;
+        this->caps[module].linear = false;
+    }
+    for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+    {
+        this->temps[sensor].linear = true;
+    }
+    this->fan.linear = true;
+    for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+    {
+        this->power[sensor].linear = true;
+    }
+    for (unsigned int value = 0; value < SysClkBatteryValue_EnumMax; value++)
+    {
+        this->battery[value].linear = true;
+    }
+    for (unsigned int load = 0; load < SysClkRamLoad_EnumMax; load++)
+    {
+        this->ramLoad[load].linear = true;
+    }
+    for (unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+    {
+        this->cpuLoad[core].linear = true;
+    }
+}
+
+bool SimBoard::Load(const char* path)
+{
+    FILE* file = fopen(path, "r");
+    if (!file)
+    {
+        fprintf(stderr, "%s: cannot open\n", path);
+        return false;
+    }
+
+    char line[SIM_BOARD_LINE_MAX];
+    unsigned int lineNo = 0;
+    bool ok = true;
+
+    while (ok && fgets(line, sizeof(line), file))
+    {
+        lineNo++;
+        ok = this->ParseLine(line);
+        if (!ok)
+        {
+            fprintf(stderr, "%s:%u: cannot parse '%s'\n", path, lineNo, strtok(line, "\r\n"));
+        }
+    }
+
+    fclose(file);
+
+    if (ok && !this->endMs)
+    {
+        fprintf(stderr, "%s: missing end\n", path);
+        ok = false;
+    }
+
+    return ok;
+}
+
+bool SimBoard::ParseLine(char* line)
+{
+    char* comment = strchr(line, '#');
+    if (comment)
+    {
+        *comment = '\0';
+    }
+
+    std::uint64_t ms = 0;
+    char command[16] = {0};
+    char arg[32] = {0};
+    char valueArg[32] = {0};
+    int count = sscanf(line, "%" SCNu64 " %15s %31s %31s", &ms, command, arg, valueArg);
+
+    if (count <= 0)
+    {
+        // blank line
+        return true;
+    }
+
+    if (count < 2)
+    {
+        return false;
+    }
+
+    std::int64_t value = 0;
+    Channel* channel = NULL;
+
+    if (!strcmp(command, "end") && count == 2)
+    {
+        this->endMs = ms;
+        return true;
+    }
+    else if (!strcmp(command, "soc") && count == 3)
+    {
+        this->socType = !strcmp(arg, "mariko") ? SysClkSocType_Mariko : SysClkSocType_Erista;
+        return !strcmp(arg, "mariko") || !strcmp(arg, "erista");
+    }
+    else if (!strcmp(command, "app") && count == 3)
+    {
+        channel = &this->app;
+        value = (std::int64_t)strtoull(arg, NULL, 16);
+    }
+    else if (!strcmp(command, "charger") && count == 3)
+    {
+        channel = &this->charger;
+        value = strtoll(arg, NULL, 0);
+    }
+    else if (!strcmp(command, "fan") && count == 3)
+    {
+        channel = &this->fan;
+        value = strtoll(arg, NULL, 0);
+    }
+    else if (!strcmp(command, "profile") && count == 3)
+    {
+        SysClkProfile profile;
+        if (!ParseName(arg, sysclkFormatProfile, SysClkProfile_EnumMax, &profile))
+        {
+            return false;
+        }
+        channel = &this->profile;
+        value = profile;
+    }
+    else if (count == 4)
+    {
+        SysClkModule module;
+        SysClkThermalSensor sensor;
+        SysClkPowerSensor powerSensor;
+        SysClkBatteryValue batteryValue;
+        SysClkRamLoad load;
+        SysClkCpuCore core;
+        value = strtoll(valueArg, NULL, 0);
+
+        if (!strcmp(command, "cap") && ParseName(arg, sysclkFormatModule, SysClkModule_EnumMax, &module))
+        {
+            channel = &this->caps[module];
+        }
+        else if (!strcmp(command, "temp") && ParseName(arg, sysclkFormatThermalSensor, SysClkThermalSensor_EnumMax, &sensor))
+        {
+            channel = &this->temps[sensor];
+        }
+        else if (!strcmp(command, "power") && ParseName(arg, sysclkFormatPowerSensor, SysClkPowerSensor_EnumMax, &powerSensor))
+        {
+            channel = &this->power[powerSensor];
+        }
+        else if (!strcmp(command, "battery") && ParseName(arg, sysclkFormatBatteryValue, SysClkBatteryValue_EnumMax, &batteryValue))
+        {
+            channel = &this->battery[batteryValue];
+        }
+        else if (!strcmp(command, "ramload") && ParseName(arg, sysclkFormatRamLoad, SysClkRamLoad_EnumMax, &load))
+        {
+            channel = &this->ramLoad[load];
+        }
+        else if (!strcmp(command, "cpuload") && ParseName(arg, sysclkFormatCpuCore, SysClkCpuCore_EnumMax, &core))
+        {
+            channel = &this->cpuLoad[core];
+        }
+    }
+
+    // keyframes of a channel must come in time order
+    if (!channel || (!channel->points.empty() && channel->points.back().ms > ms))
+    {
+        return false;
+    }
+
+    channel->points.push_back({ ms, value });
+    return true;
+}
+
+std::uint64_t SimBoard::GetElapsedMs()
+{
+    return armTicksToNs(armGetSystemTick() - this->startTick) / 1000000ULL;
+}
+
+bool SimBoard::Finished()
+{
+    return this->GetElapsedMs() >= this->endMs;
+}
+
+std::int64_t SimBoard::GetValue(Channel* channel, std::int64_t defaultValue)
+{
+    std::uint64_t ms = this->GetElapsedMs();
+    std::vector<Point>& points = channel->points;
+
+    // sensors hold their first value until then, steps have not happened yet
+    if (points.empty() || ms < points[0].ms)
+    {
+        return points.empty() || !channel->linear ? defaultValue : points[0].value;
+    }
+
+    // last keyframe at or before now
+    std::size_t i = std::upper_bound(points.begin(), points.end(), ms, [](std::uint64_t t, const Point& p) { return t < p.ms; }) - points.begin() - 1;
+
+    if (!channel->linear || i + 1 >= points.size())
+    {
+        return points[i].value;
+    }
+
+    const Point& a = points[i];
+    const Point& b = points[i + 1];
+    return a.value + (b.value - a.value) * (std::int64_t)(ms - a.ms) / (std::int64_t)(b.ms - a.ms);
+}
+
+void SimBoard::Initialize()
+{
+    this->startTick = armGetSystemTick();
+}
+
+void SimBoard::Exit()
+{
+}
+
+Result SimBoard::ResetToStock()
+{
+    SysClkProfile profile = SysClkProfile_Handheld;
+    this->GetProfile(&profile);
+
+    fprintf(this->out, "%8" PRIu64 " ms reset\n", this->GetElapsedMs());
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        this->hz[module] = g_stock_hz[profile == SysClkProfile_Docked][module];
+    }
+
+    return 0;
+}
+
+Result SimBoard::GetProfile(SysClkProfile* out_profile)
+{
+    *out_profile = (SysClkProfile)this->GetValue(&this->profile, SysClkProfile_Handheld);
+    return 0;
+}
+
+Result SimBoard::GetApplicationId(std::uint64_t* out_tid)
+{
+    *out_tid = (std::uint64_t)this->GetValue(&this->app, SIM_QLAUNCH_TID);
+    return 0;
+}
+
+Result SimBoard::SetHz(SysClkModule module, std::uint32_t hz)
+{
+    fprintf(this->out, "%8" PRIu64 " ms %s %u.%u MHz\n", this->GetElapsedMs(), sysclkFormatModule(module, false), hz / 1000000, hz / 100000 % 10);
+    this->hz[module] = hz;
+    return 0;
+}
+
+Result SimBoard::GetHz(SysClkModule module, std::uint32_t* out_hz)
+{
+    if (!this->hz[module])
+    {
+        this->hz[module] = g_stock_hz[0][module];
+    }
+
+    *out_hz = this->hz[module];
+    return 0;
+}
+
+std::uint32_t SimBoard::GetRealHz(SysClkModule module)
+{
+    std::uint32_t hz = 0;
+    std::uint32_t cap = this->GetValue(&this->caps[module], 0);
+
+    this->GetHz(module, &hz);
+    return cap ? std::min(hz, cap) : hz;
+}
+
+Result SimBoard::GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount)
+{
+    *outCount = std::min(maxCount, g_freq_counts[module]);
+    memcpy(outList, g_freq_lists[module], *outCount * sizeof(*outList));
+    return 0;
+}
+
+std::uint32_t SimBoard::GetTemperatureMilli(SysClkThermalSensor sensor)
+{
+    return std::max((std::int64_t)0, this->GetValue(&this->temps[sensor], 0));
+}
+
+void SimBoard::GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb)
+{
+    *out_soc = this->GetTemperatureMilli(SysClkThermalSensor_SOC);
+    *out_pcb = this->GetTemperatureMilli(SysClkThermalSensor_PCB);
+}
+
+std::uint32_t SimBoard::GetFanLevel()
+{
+    return std::min((std::int64_t)1000, std::max((std::int64_t)0, this->GetValue(&this->fan, 0)));
+}
+
+std::uint32_t SimBoard::GetChargerPowerMw()
+{
+    return std::max((std::int64_t)0, this->GetValue(&this->charger, 0));
+}
+
+void SimBoard::GetBattery(BoardBattery* out_battery)
+{
+    for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+    {
+        out_battery->powerMw[sensor] = this->GetValue(&this->power[sensor], 0);
+    }
+
+    for (unsigned int value = 0; value < SysClkBatteryValue_EnumMax; value++)
+    {
+        out_battery->values[value] = this->GetValue(&this->battery[value], 0);
+    }
+}
+
+std::uint32_t SimBoard::GetRamLoad(SysClkRamLoad load)
+{
+    return this->GetValue(&this->ramLoad[load], 0);
+}
+
+std::uint32_t SimBoard::GetRamBandwidth(SysClkRamLoad load)
+{
+    // what actmon would report for that load at the current MEM clock
+    std::uint64_t permille = std::min((std::int64_t)1000, std::max((std::int64_t)0, this->GetValue(&this->ramLoad[load], 0)));
+    return permille * this->GetRealHz(SysClkModule_MEM) * SIM_EMC_BYTES_PER_CLOCK / 1000 / 1000000;
+}
+
+void SimBoard::SetRamSampling(std::uint32_t periodMs, std::uint32_t window)
+{
+}
+
+std::uint32_t SimBoard::GetCpuLoad(SysClkCpuCore core)
+{
+    return std::min((std::int64_t)1000, std::max((std::int64_t)0, this->GetValue(&this->cpuLoad[core], 0)));
+}
+
+SysClkSocType SimBoard::GetSocType()
+{
+    return this->socType;
+}
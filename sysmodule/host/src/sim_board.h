@@ -0,0 +1,87 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdio>
+#include <cstdint>
+#include <vector>
+#include <switch.h>
+#include <sysclk.h>
+#include "board_backend.h"
+
+#define SIM_BOARD_LINE_MAX 0x100
+
+/*
+ * Deterministic console driven by a scenario file, see scenarios/dock_cycle.txt.
+ * Inputs are keyframes on the virtual clock: app, profile and real clock caps
+ * are steps, sensors are interpolated linearly. Every clock set is written to
+ * the output as one line, which makes runs diffable.
+ */
+class SimBoard : public BoardBackend
+{
+  public:
+    SimBoard(FILE* out);
+
+    bool Load(const char* path);
+    bool Finished();
+    std::uint64_t GetElapsedMs();
+
+    virtual void Initialize() override;
+    virtual void Exit() override;
+    virtual Result ResetToStock() override;
+    virtual Result GetProfile(SysClkProfile* out_profile) override;
+    virtual Result GetApplicationId(std::uint64_t* out_tid) override;
+    virtual Result SetHz(SysClkModule module, std::uint32_t hz) override;
+    virtual Result GetHz(SysClkModule module, std::uint32_t* out_hz) override;
+    virtual std::uint32_t GetRealHz(SysClkModule module) override;
+    virtual Result GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount) override;
+    virtual std::uint32_t GetTemperatureMilli(SysClkThermalSensor sensor) override;
+    virtual void GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb) override;
+    virtual std::uint32_t GetFanLevel() override;
+    virtual void GetBattery(BoardBattery* out_battery) override;
+    virtual std::uint32_t GetChargerPowerMw() override;
+    virtual std::uint32_t GetRamLoad(SysClkRamLoad load) override;
+    virtual std::uint32_t GetRamBandwidth(SysClkRamLoad load) override;
+    virtual void SetRamSampling(std::uint32_t periodMs, std::uint32_t window) override;
+    virtual std::uint32_t GetCpuLoad(SysClkCpuCore core) override;
+    virtual SysClkSocType GetSocType() override;
+
+  protected:
+    typedef struct
+    {
+        std::uint64_t ms;
+        std::int64_t value;
+    } Point;
+
+    typedef struct
+    {
+        bool linear;
+        std::vector<Point> points;
+    } Channel;
+
+    std::int64_t GetValue(Channel* channel, std::int64_t defaultValue);
+    bool ParseLine(char* line);
+
+    FILE* out;
+    std::uint64_t startTick;
+    std::uint64_t endMs;
+    SysClkSocType socType;
+    std::uint32_t hz[SysClkModule_EnumMax];
+    Channel app;
+    Channel profile;
+    Channel caps[SysClkModule_EnumMax];
+    Channel temps[SysClkThermalSensor_EnumMax];
+    Channel fan;
+    Channel charger;
+    Channel power[SysClkPowerSensor_EnumMax];
+    Channel battery[SysClkBatteryValue_EnumMax];
+    Channel ramLoad[SysClkRamLoad_EnumMax];
+    Channel cpuLoad[SysClkCpuCore_EnumMax];
+};
@@ -0,0 +1,105 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include <cstdint>
+#include <cstdio>
+
+#include "signal_filter.h"
+
+#define TRACE_LENGTH 8
+#define TRACE_PERIOD_MS 1000
+
+// power_now on the console, one sample per second, with a spike at the 4th
+static const std::int32_t g_trace[TRACE_LENGTH] = { 5000, 5100, 5050, 9800, 5150, 5200, 5100, 5000 };
+
+static unsigned int g_failures = 0;
+
+static void CheckTrace(const char* spec, const std::int32_t* expected)
+{
+    SignalFilter filter;
+    if(!filter.Configure(spec))
+    {
+        fprintf(stderr, "FAIL %s: rejected\n", spec);
+        g_failures++;
+        return;
+    }
+
+    for(unsigned int i = 0; i < TRACE_LENGTH; i++)
+    {
+        std::int32_t out = filter.Apply(g_trace[i], i ? TRACE_PERIOD_MS : 0);
+        if(out != expected[i])
+        {
+            fprintf(stderr, "FAIL %s: sample %u is %d, expected %d\n", spec, i, out, expected[i]);
+            g_failures++;
+        }
+    }
+}
+
+static void CheckSpec(const char* spec, bool valid)
+{
+    if(SignalFilter::Validate(spec) != valid)
+    {
+        fprintf(stderr, "FAIL Validate(\"%s\") should be %s\n", spec, valid ? "true" : "false");
+        g_failures++;
+    }
+
+    // a rejected spec must leave the previous chain in place
+    SignalFilter filter;
+    filter.Configure("slew:1");
+    filter.Apply(0, 0);
+    bool configured = filter.Configure(spec);
+    std::int32_t out = filter.Apply(1000, TRACE_PERIOD_MS);
+    if(configured != valid || (!valid && out != 1))
+    {
+        fprintf(stderr, "FAIL Configure(\"%s\") should be %s\n", spec, valid ? "true" : "false");
+        g_failures++;
+    }
+}
+
+int main()
+{
+    static const std::int32_t ema[TRACE_LENGTH] = { 5000, 5025, 5031, 6223, 5955, 5766, 5600, 5450 };
+    static const std::int32_t median[TRACE_LENGTH] = { 5000, 5000, 5050, 5100, 5150, 5200, 5150, 5100 };
+    static const std::int32_t slew[TRACE_LENGTH] = { 5000, 5100, 5050, 5550, 5150, 5200, 5100, 5000 };
+    static const std::int32_t chain[TRACE_LENGTH] = { 5000, 5000, 5013, 5034, 5063, 5097, 5111, 5108 };
+
+    CheckTrace("", g_trace);
+    CheckTrace("ema:250", ema);
+    CheckTrace("median:3", median);
+    CheckTrace("slew:500", slew);
+    CheckTrace(" median:3 , ema:250", chain);
+
+    CheckSpec("ema:1000", true);
+    CheckSpec("median:9", true);
+    CheckSpec("slew:1000000", true);
+    CheckSpec("ema:1,ema:1,ema:1,ema:1", true);
+    CheckSpec("ema:0", false);
+    CheckSpec("ema:1001", false);
+    CheckSpec("median:1", false);
+    CheckSpec("median:10", false);
+    CheckSpec("slew:0", false);
+    CheckSpec("slew:1000001", false);
+    CheckSpec("ema:-5", false);
+    CheckSpec("ema:", false);
+    CheckSpec("ema", false);
+    CheckSpec("mean:3", false);
+    CheckSpec("ema:250x", false);
+    CheckSpec("ema:250;median:3", false);
+    CheckSpec("ema:1,ema:1,ema:1,ema:1,ema:1", false);
+
+    if(g_failures)
+    {
+        fprintf(stderr, "%u failures\n", g_failures);
+        return 1;
+    }
+
+    fprintf(stderr, "all passed\n");
+    return 0;
+}
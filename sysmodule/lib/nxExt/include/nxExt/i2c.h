@@ -17,7 +17,32 @@ extern "C"
 
 #include <switch.h>
 
+#define I2C_EXT_BATCH_CMDLIST_MAX 0x40
+#define I2C_EXT_BATCH_RECV_MAX 0x20
+
+/*
+ * Register reads of one device issued as a single command list, so a sensor
+ * refresh costs one round-trip to the i2c service. Received bytes are laid
+ * out in the order the reads were added. With auto_increment, a read of the
+ * register right after the previous one is merged into it as a burst read.
+ */
+typedef struct
+{
+    u8 cmdlist[I2C_EXT_BATCH_CMDLIST_MAX];
+    u8 cmdlist_size;
+    u8 recv_size;
+    u8 reg_width;
+    bool auto_increment;
+    s16 last_rcv;
+    u8 next_reg;
+} I2cExtBatch;
+
+void i2cExtBatchInit(I2cExtBatch* b, u8 reg_width, bool auto_increment);
+bool i2cExtBatchAddRegReceive(I2cExtBatch* b, u8 reg, u8 count);
+Result i2csessionExtBatchExecute(I2cSession* s, I2cExtBatch* b, void* out, u8 out_size);
+
 Result i2csessionExtRegReceive(I2cSession* s, u8 in, void* out, u8 out_size);
+u64 i2cExtGetTransactionCount(void);
 
 #ifdef __cplusplus
 }
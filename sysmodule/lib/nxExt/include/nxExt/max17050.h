@@ -17,10 +17,22 @@ extern "C"
 
 #include <switch.h>
 
+// current is positive while charging, negative while discharging
+typedef struct
+{
+    s32 power_now_mw;
+    s32 power_avg_mw;
+    u32 charge_permille;
+    s32 temp_milli;
+    u32 remaining_mah;
+    u32 full_mah;
+    s32 avg_current_ma;
+} Max17050Status;
+
 Result max17050Initialize(void);
 void max17050Exit(void);
-s32 max17050PowerNow(void);
-s32 max17050PowerAvg(void);
+// one i2c command list, keeps the previous values when it fails
+void max17050GetStatus(Max17050Status* out);
 
 #ifdef __cplusplus
 }
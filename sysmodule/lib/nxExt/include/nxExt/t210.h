@@ -22,6 +22,11 @@ u32 t210ClkMemFreq(void);
 u32 t210ClkGpuFreq(void);
 u32 t210EmcLoadAll(void);
 u32 t210EmcLoadCpu(void);
+// MB/s moved over the last actmon averaging window
+u32 t210EmcBandwidthAll(void);
+u32 t210EmcBandwidthCpu(void);
+// sample period in ms (1-256), moving average over 2^(k+1) samples (k 0-7)
+void t210EmcSetActmonSampling(u32 period_ms, u32 k);
 
 #ifdef __cplusplus
 }
@@ -21,6 +21,8 @@ Result tmp451Initialize(void);
 void tmp451Exit(void);
 s32 tmp451TempPcb(void);
 s32 tmp451TempSoc(void);
+// both sensors, all four registers in a single round-trip
+void tmp451GetTemps(s32* out_soc, s32* out_pcb);
 
 #ifdef __cplusplus
 }
@@ -13,16 +13,76 @@
 #define I2C_CMD_SND 0
 #define I2C_CMD_RCV 1
 
+static u64 g_transaction_count = 0;
+
+void i2cExtBatchInit(I2cExtBatch* b, u8 reg_width, bool auto_increment)
+{
+    b->cmdlist_size = 0;
+    b->recv_size = 0;
+    b->reg_width = reg_width;
+    b->auto_increment = auto_increment;
+    b->last_rcv = -1;
+    b->next_reg = 0;
+}
+
+bool i2cExtBatchAddRegReceive(I2cExtBatch* b, u8 reg, u8 count)
+{
+    u8 size = count * b->reg_width;
+    if(!size || b->recv_size + size > I2C_EXT_BATCH_RECV_MAX)
+    {
+        return false;
+    }
+
+    // contiguous with the previous read: extend its receive length
+    if(b->auto_increment && b->last_rcv >= 0 && reg == b->next_reg)
+    {
+        b->cmdlist[b->last_rcv + 1] += size;
+        b->recv_size += size;
+        b->next_reg = reg + count;
+        return true;
+    }
+
+    if(b->cmdlist_size + 5 > I2C_EXT_BATCH_CMDLIST_MAX)
+    {
+        return false;
+    }
+
+    u8* cmd = &b->cmdlist[b->cmdlist_size];
+    cmd[0] = I2C_CMD_SND | (I2cTransactionOption_Start << 6);
+    cmd[1] = sizeof(reg);
+    cmd[2] = reg;
+    cmd[3] = I2C_CMD_RCV | (I2cTransactionOption_All << 6);
+    cmd[4] = size;
+
+    b->last_rcv = b->cmdlist_size + 3;
+    b->cmdlist_size += 5;
+    b->recv_size += size;
+    b->next_reg = reg + count;
+    return true;
+}
+
+Result i2csessionExtBatchExecute(I2cSession* s, I2cExtBatch* b, void* out, u8 out_size)
+{
+    if(!b->cmdlist_size || out_size < b->recv_size)
+    {
+        return MAKERESULT(Module_Libnx, LibnxError_BadInput);
+    }
+
+    __atomic_fetch_add(&g_transaction_count, 1, __ATOMIC_RELAXED);
+
+    return i2csessionExecuteCommandList(s, out, b->recv_size, b->cmdlist, b->cmdlist_size);
+}
+
 Result i2csessionExtRegReceive(I2cSession* s, u8 in, void* out, u8 out_size)
 {
-    u8 cmdlist[5] = {
-        I2C_CMD_SND | (I2cTransactionOption_Start << 6),
-        sizeof(in),
-        in,
+    I2cExtBatch batch;
+    i2cExtBatchInit(&batch, out_size, false);
+    i2cExtBatchAddRegReceive(&batch, in, 1);
 
-        I2C_CMD_RCV | (I2cTransactionOption_All << 6),
-        out_size
-    };
+    return i2csessionExtBatchExecute(s, &batch, out, out_size);
+}
 
-    return i2csessionExecuteCommandList(s, out, out_size, cmdlist, sizeof(cmdlist));
+u64 i2cExtGetTransactionCount(void)
+{
+    return __atomic_load_n(&g_transaction_count, __ATOMIC_RELAXED);
 }
@@ -25,72 +25,46 @@
 #include "nxExt/max17050.h"
 #include "nxExt/i2c.h"
 
-#define MAX17050_WAIT_NS 1000000000UL
-
+#define MAX17050_RepCap     0x05
+#define MAX17050_RepSOC     0x06
+#define MAX17050_Temp       0x08
 #define MAX17050_VCELL      0x09
 #define MAX17050_Current    0x0A
 #define MAX17050_AvgCurrent 0x0B
+#define MAX17050_FullCAP    0x10
 #define MAX17050_AvgVCELL   0x19
 
 #define MAX17050_BOARD_CGAIN 2
 #define MAX17050_BOARD_SNS_RESISTOR_UOHM 5000
 
+// RepCap..AvgCurrent as one burst, then FullCAP and AvgVCELL
+#define MAX17050_BURST_FIRST MAX17050_RepCap
+#define MAX17050_BURST_COUNT (MAX17050_AvgCurrent - MAX17050_RepCap + 1)
+#define MAX17050_BURST(reg) ((reg) - MAX17050_BURST_FIRST)
+#define MAX17050_FULLCAP_INDEX MAX17050_BURST_COUNT
+#define MAX17050_AVGVCELL_INDEX (MAX17050_BURST_COUNT + 1)
+
 static I2cSession g_i2c_session;
-static u64 g_update_ticks = 0;
-static s32 g_power_now = 0;
-static s32 g_power_avg = 0;
+static Max17050Status g_status = {0};
 
-static Result _max17050_get_power(s32 *out_mw_now, s32 *out_mw_avg)
+static s32 _max17050_to_ua(u16 current)
 {
-    s64 ma, mv;
-    u16 values[3] = {0};
-
-    Result rc = i2csessionExtRegReceive(&g_i2c_session, MAX17050_VCELL, values, sizeof(values));
-
-    if (R_SUCCEEDED(rc))
-    {
-        ma = (s16)values[1];
-        ma = ma * 1562500 / (MAX17050_BOARD_SNS_RESISTOR_UOHM * MAX17050_BOARD_CGAIN);
-
-        mv = (int)(values[0] >> 3) * 625 / 1000;
-
-        *out_mw_now = ma * mv / 1000000;
-    }
-
-    if (R_SUCCEEDED(rc))
-    {
-        rc = i2csessionExtRegReceive(&g_i2c_session, MAX17050_AvgVCELL, values, sizeof(u16));
-    }
-
-    if (R_SUCCEEDED(rc))
-    {
-        ma = (s16)values[2];
-        ma = ma * 1562500 / (MAX17050_BOARD_SNS_RESISTOR_UOHM * MAX17050_BOARD_CGAIN);
-
-        mv = (int)(values[0] >> 3) * 625 / 1000;
-
-        *out_mw_avg = ma * mv / 1000000;
-    }
-
-    return rc;
+    // 1.5625 uV / Rsense per LSB
+    return (s64)(s16)current * 1562500 / (MAX17050_BOARD_SNS_RESISTOR_UOHM * MAX17050_BOARD_CGAIN);
 }
 
-static void _max17050_update()
+static s32 _max17050_to_mw(u16 vcell, u16 current)
 {
-    u64 ticks = armGetSystemTick();
-    if(armTicksToNs(ticks - g_update_ticks) <= MAX17050_WAIT_NS)
-    {
-        return;
-    }
-
-    g_update_ticks = ticks;
+    s64 ua = _max17050_to_ua(current);
+    s64 mv = (int)(vcell >> 3) * 625 / 1000;
 
-    if(!serviceIsActive(&g_i2c_session.s))
-    {
-        return;
-    }
+    return ua * mv / 1000000;
+}
 
-    _max17050_get_power(&g_power_now, &g_power_avg);
+static u32 _max17050_to_mah(u16 capacity)
+{
+    // 5 uVh / Rsense per LSB, with the same gain as the current registers
+    return (u64)capacity * 5000 / (MAX17050_BOARD_SNS_RESISTOR_UOHM * MAX17050_BOARD_CGAIN);
 }
 
 Result max17050Initialize(void)
@@ -111,14 +85,31 @@ void max17050Exit(void)
     i2cExit();
 }
 
-s32 max17050PowerNow(void)
+void max17050GetStatus(Max17050Status* out)
 {
-    _max17050_update();
-    return g_power_now;
-}
+    if(serviceIsActive(&g_i2c_session.s))
+    {
+        u16 values[MAX17050_BURST_COUNT + 2] = {0};
+        I2cExtBatch batch;
+        i2cExtBatchInit(&batch, sizeof(u16), true);
+        i2cExtBatchAddRegReceive(&batch, MAX17050_BURST_FIRST, MAX17050_BURST_COUNT);
+        i2cExtBatchAddRegReceive(&batch, MAX17050_FullCAP, 1);
+        i2cExtBatchAddRegReceive(&batch, MAX17050_AvgVCELL, 1);
+
+        if(R_SUCCEEDED(i2csessionExtBatchExecute(&g_i2c_session, &batch, values, sizeof(values))))
+        {
+            u16 vcell = values[MAX17050_BURST(MAX17050_VCELL)];
+            u16 avg_current = values[MAX17050_BURST(MAX17050_AvgCurrent)];
+
+            g_status.power_now_mw = _max17050_to_mw(vcell, values[MAX17050_BURST(MAX17050_Current)]);
+            g_status.power_avg_mw = _max17050_to_mw(values[MAX17050_AVGVCELL_INDEX], avg_current);
+            g_status.charge_permille = (u32)values[MAX17050_BURST(MAX17050_RepSOC)] * 10 / 256;
+            g_status.temp_milli = (s32)(s16)values[MAX17050_BURST(MAX17050_Temp)] * 1000 / 256;
+            g_status.remaining_mah = _max17050_to_mah(values[MAX17050_BURST(MAX17050_RepCap)]);
+            g_status.full_mah = _max17050_to_mah(values[MAX17050_FULLCAP_INDEX]);
+            g_status.avg_current_ma = _max17050_to_ua(avg_current) / 1000;
+        }
+    }
 
-s32 max17050PowerAvg(void)
-{
-    _max17050_update();
-    return g_power_avg;
+    *out = g_status;
 }
@@ -17,17 +17,65 @@
 
 #include "nxExt/t210.h"
 
-#define WAIT_NS 1000000000UL
+#define PTO_FALLBACK_NS 1000000000UL
 
 #define usleep(x) svcSleepThread(1000UL * x)
 
 #define GPU_TRIM_SYS_GPCPLL_COEFF 0x4
 #define GPU_TRIM_SYS_GPCPLL(x) (*(volatile u32 *)(g_gpu_base + 0x137000ul + (x)))
 
+#define CLK_RST_CONTROLLER_OSC_CTRL 0x50
 #define CLK_RST_CONTROLLER_PTO_CLK_CNT_CNTL 0x60
 #define CLK_RST_CONTROLLER_PTO_CLK_CNT_STATUS 0x64
+#define CLK_RST_CONTROLLER_PLLM_BASE 0x90
+#define CLK_RST_CONTROLLER_PLLX_BASE 0xE0
+#define CLK_RST_CONTROLLER_CLK_SOURCE_EMC 0x19C
 #define CLK_RST_CONTROLLER_CLK_OUT_ENB_X 0x280
 #define CLK_RST_CONTROLLER_RST_DEVICES_X 0x28C
+#define CLK_RST_CONTROLLER_CCLKG_BURST_POLICY 0x368
+#define CLK_RST_CONTROLLER_SUPER_CCLKG_DIVIDER 0x36C
+#define CLK_RST_CONTROLLER_PLLMB_BASE 0x5E8
+
+/*! OSC_CTRL */
+#define OSC_FREQ                 38400000
+#define OSC_PLL_REF_DIV_SHIFT    26
+#define OSC_PLL_REF_DIV_MASK     0x3
+
+/*! PLLx_BASE */
+#define PLL_BASE_DIVM(x)         ((x) & 0xFF)
+#define PLL_BASE_DIVN(x)         (((x) >> 8) & 0xFF)
+#define PLL_BASE_DIVP(x)         (((x) >> 20) & 0x1F)
+#define PLL_BASE_ENABLE          BIT(30)
+#define PLL_BASE_BYPASS          BIT(31)
+
+/*! CCLKG_BURST_POLICY */
+#define CCLK_BURST_POLICY_STATE_SHIFT 28
+#define CCLK_BURST_POLICY_STATE_IDLE  BIT(0)
+#define CCLK_BURST_POLICY_STATE_RUN   BIT(1)
+#define CCLK_BURST_POLICY_STATE_IRQ   BIT(2)
+#define CCLK_BURST_POLICY_STATE_FIQ   BIT(3)
+#define CCLK_BURST_POLICY_SRC_MASK    0xF
+#define CCLK_SRC_CLK_M                0
+#define CCLK_SRC_PLLP_OUT0            4
+#define CCLK_SRC_PLLX_OUT0_LJ         8
+
+/*! SUPER_CCLKG_DIVIDER */
+#define SUPER_CDIV_ENB           BIT(31)
+#define SUPER_CDIV_DIVIDEND(x)   (((x) >> 8) & 0xFF)
+#define SUPER_CDIV_DIVISOR(x)    ((x) & 0xFF)
+
+/*! CLK_SOURCE_EMC */
+#define EMC_2X_CLK_SRC_SHIFT     29
+#define EMC_2X_CLK_DIVISOR(x)    ((x) & 0xFF)
+#define EMC_SRC_PLLM_OUT0        0
+#define EMC_SRC_PLLP_OUT0        2
+#define EMC_SRC_CLK_M            3
+#define EMC_SRC_PLLM_UD          4
+#define EMC_SRC_PLLMB_UD         5
+#define EMC_SRC_PLLMB_OUT0       6
+#define EMC_SRC_PLLP_UD          7
+
+#define PLLP_OUT0_FREQ           408000000
 
 /*! PTO_CLK_CNT */
 #define PTO_REF_CLK_WIN_CFG_MASK 0xF
@@ -71,9 +119,17 @@
 #define ACTMON_DEV_CTRL_ENB_PERIODIC                   BIT(18)
 #define ACTMON_DEV_CTRL_ENB                            BIT(31)
 
-#define ACTMON_PERIOD_MS 20
+#define ACTMON_PERIOD_MS_DEFAULT 20
+#define ACTMON_K_DEFAULT 3 // 16 samples moving average
 #define DEV_COUNT_WEIGHT 1024
 
+/*
+ * MC actmon counts busy EMC cycles over each sample period. The Switch DRAM
+ * bus is 64-bit LPDDR4, moving two transfers (16 bytes) per EMC clock, so
+ * 1600 MHz gives the 25.6 GB/s peak.
+ */
+#define EMC_BYTES_PER_CLOCK 16
+
 #define ACTMON_BASE     (g_act_base + 0x800)
 #define ACTMON_DEV_BASE (ACTMON_BASE + 0x80)
 #define ACTMON(x) (*(volatile u32 *)(ACTMON_BASE + (x)))
@@ -107,15 +163,37 @@ typedef struct _actmon_dev_reg_t
     vu32 rsvd[5];
 } actmon_dev_reg_t;
 
+/*
+ * CPU and EMC rates are decoded from their source, divider and PLL registers
+ * on every read. The PTO counter (~0.5 ms of sleeping and busy waiting per
+ * clock) only validates the decoded rate from time to time, and stands in for
+ * it while the clock runs from a source that is not decoded (DFLL, PLLC...)
+ * or when both disagree.
+ */
+#define PTO_VALIDATE_NS 10000000000UL
+#define PTO_TOLERANCE_DIV 50 // 2%
+
+typedef struct
+{
+    u32 pto_id;
+    u32 measured;
+    u64 measure_ticks;
+    bool trusted;
+} clock_pto_t;
+
 static uintptr_t g_clk_base = 0;
 static uintptr_t g_gpu_base = 0;
 static uintptr_t g_act_base = 0;
-static u64 g_update_ticks = 0;
-static u32 g_cpu_freq = 0;
-static u32 g_gpu_freq = 0;
-static u32 g_mem_freq = 0;
 static u32 g_emc_lall = 0;
 static u32 g_emc_lcpu = 0;
+static u32 g_emc_bwall = 0;
+static u32 g_emc_bwcpu = 0;
+static u32 g_actmon_period_ms = ACTMON_PERIOD_MS_DEFAULT;
+static u32 g_actmon_k = ACTMON_K_DEFAULT;
+static bool g_actmon_reprogram = false;
+static clock_pto_t g_cpu_pto = { .pto_id = CLK_PTO_CCLK_G };
+static clock_pto_t g_mem_pto = { .pto_id = CLK_PTO_EMC };
+static const u8 g_pll_pdiv[] = { 1, 2, 3, 4, 5, 6, 8, 9, 10, 12, 15, 16, 18, 20, 24, 30, 32 };
 
 static u32 _clock_get_dev_freq(u32 id)
 {
@@ -157,10 +235,12 @@ static void _actmon_dev_enable(actmon_dev_t dev, u32 freq, u32 weight)
 {
     actmon_dev_reg_t *regs = (actmon_dev_reg_t *)(ACTMON_DEV_BASE + (dev * ACTMON_DEV_SIZE));
 
-    regs->init_avg = (u32)freq * ACTMON_PERIOD_MS / 2;
+    // disabled first so init_avg is reloaded when reprogramming a running device
+    regs->ctrl = 0;
+    regs->init_avg = (u32)freq * g_actmon_period_ms / 2;
     regs->count_weight = weight;
 
-    regs->ctrl = ACTMON_DEV_CTRL_ENB | ACTMON_DEV_CTRL_ENB_PERIODIC | ACTMON_DEV_CTRL_K_VAL(3); // 8 samples average.
+    regs->ctrl = ACTMON_DEV_CTRL_ENB | ACTMON_DEV_CTRL_ENB_PERIODIC | ACTMON_DEV_CTRL_K_VAL(g_actmon_k); // 2^(K+1) samples average.
 }
 
 static u32 _actmon_dev_get_count_avg(actmon_dev_t dev)
@@ -183,107 +263,264 @@ static inline Result _svcQueryMemoryMappingFallback(u64* virtaddr, u64 physaddr,
     }
 }
 
-static void _clock_update_freqs(void)
+static bool _clock_map(void)
 {
-    u64 ticks = armGetSystemTick();
-    if(armTicksToNs(ticks - g_update_ticks) <= WAIT_NS)
+    if (!g_clk_base)
     {
-        return;
+        _svcQueryMemoryMappingFallback(&g_clk_base, 0x60006000ul, 0x1000);
     }
 
-    g_update_ticks = ticks;
+    return g_clk_base != 0;
+}
 
-    if (!g_clk_base)
+static u32 _clock_get_pll_freq(u32 base_reg, bool undivided)
+{
+    u32 base = CLOCK(base_reg);
+    if (!(base & PLL_BASE_ENABLE) || (base & PLL_BASE_BYPASS))
     {
-        _svcQueryMemoryMappingFallback(&g_clk_base, 0x60006000ul, 0x1000);
+        return 0;
     }
 
-    if(!g_clk_base)
+    u32 divm = PLL_BASE_DIVM(base);
+    u32 divn = PLL_BASE_DIVN(base);
+    u32 divp = PLL_BASE_DIVP(base);
+    if (!divm || divp >= sizeof(g_pll_pdiv))
     {
-        return;
+        return 0;
     }
 
-    g_mem_freq = _clock_get_dev_freq(CLK_PTO_EMC) * 1000;
-    g_cpu_freq = _clock_get_dev_freq(CLK_PTO_CCLK_G) * 1000;
+    u32 ref = OSC_FREQ >> ((CLOCK(CLK_RST_CONTROLLER_OSC_CTRL) >> OSC_PLL_REF_DIV_SHIFT) & OSC_PLL_REF_DIV_MASK);
+    u64 vco = (u64)ref * divn / divm;
 
-    if (!g_gpu_base)
+    return undivided ? vco : vco / g_pll_pdiv[divp];
+}
+
+static u32 _clock_get_cpu_freq_fast(void)
+{
+    u32 policy = CLOCK(CLK_RST_CONTROLLER_CCLKG_BURST_POLICY);
+    u32 shift;
+    u64 freq;
+
+    // one-hot state, each selects its own 4-bit source field
+    switch (policy >> CCLK_BURST_POLICY_STATE_SHIFT)
     {
-        _svcQueryMemoryMappingFallback(&g_gpu_base, 0x57000000ul, 0x1000000);
+        case CCLK_BURST_POLICY_STATE_IDLE:
+            shift = 0;
+            break;
+        case CCLK_BURST_POLICY_STATE_RUN:
+            shift = 4;
+            break;
+        case CCLK_BURST_POLICY_STATE_IRQ:
+            shift = 8;
+            break;
+        case CCLK_BURST_POLICY_STATE_FIQ:
+            shift = 12;
+            break;
+        default:
+            return 0;
     }
 
-    if (!g_gpu_base)
+    switch ((policy >> shift) & CCLK_BURST_POLICY_SRC_MASK)
     {
-        return;
+        case CCLK_SRC_PLLX_OUT0_LJ:
+            freq = _clock_get_pll_freq(CLK_RST_CONTROLLER_PLLX_BASE, false);
+            break;
+        case CCLK_SRC_PLLP_OUT0:
+            freq = PLLP_OUT0_FREQ;
+            break;
+        case CCLK_SRC_CLK_M:
+            freq = OSC_FREQ / 2;
+            break;
+        default:
+            return 0;
     }
 
-    bool gpu_enabled = (CLOCK(CLK_RST_CONTROLLER_CLK_OUT_ENB_X) & BIT(24)) && !(CLOCK(CLK_RST_CONTROLLER_RST_DEVICES_X) & BIT(24));
-    if(!gpu_enabled)
+    u32 divider = CLOCK(CLK_RST_CONTROLLER_SUPER_CCLKG_DIVIDER);
+    if (divider & SUPER_CDIV_ENB)
     {
-        return;
+        freq = freq * (SUPER_CDIV_DIVIDEND(divider) + 1) / (SUPER_CDIV_DIVISOR(divider) + 1);
+    }
+
+    return freq;
+}
+
+static u32 _clock_get_emc_freq_fast(void)
+{
+    u32 source = CLOCK(CLK_RST_CONTROLLER_CLK_SOURCE_EMC);
+    u64 freq;
+
+    switch (source >> EMC_2X_CLK_SRC_SHIFT)
+    {
+        case EMC_SRC_PLLM_OUT0:
+            freq = _clock_get_pll_freq(CLK_RST_CONTROLLER_PLLM_BASE, false);
+            break;
+        case EMC_SRC_PLLM_UD:
+            freq = _clock_get_pll_freq(CLK_RST_CONTROLLER_PLLM_BASE, true);
+            break;
+        case EMC_SRC_PLLMB_OUT0:
+            freq = _clock_get_pll_freq(CLK_RST_CONTROLLER_PLLMB_BASE, false);
+            break;
+        case EMC_SRC_PLLMB_UD:
+            freq = _clock_get_pll_freq(CLK_RST_CONTROLLER_PLLMB_BASE, true);
+            break;
+        case EMC_SRC_PLLP_OUT0:
+        case EMC_SRC_PLLP_UD:
+            freq = PLLP_OUT0_FREQ;
+            break;
+        case EMC_SRC_CLK_M:
+            freq = OSC_FREQ / 2;
+            break;
+        default:
+            return 0;
     }
 
+    // 7.1 fixed point divisor
+    return freq * 2 / (EMC_2X_CLK_DIVISOR(source) + 2);
+}
+
+static u32 _clock_get_freq(clock_pto_t* pto, u32 fast)
+{
+    u64 ticks = armGetSystemTick();
+    bool trusted = fast && pto->trusted;
+
+    if (!pto->measure_ticks || armTicksToNs(ticks - pto->measure_ticks) > (trusted ? PTO_VALIDATE_NS : PTO_FALLBACK_NS))
+    {
+        pto->measure_ticks = ticks;
+        pto->measured = _clock_get_dev_freq(pto->pto_id) * 1000;
+
+        // decoded again, the clock may have just switched
+        fast = pto->pto_id == CLK_PTO_CCLK_G ? _clock_get_cpu_freq_fast() : _clock_get_emc_freq_fast();
+        u32 delta = fast > pto->measured ? fast - pto->measured : pto->measured - fast;
+        pto->trusted = fast && delta <= pto->measured / PTO_TOLERANCE_DIV;
+        trusted = pto->trusted;
+    }
+
+    return trusted ? fast : pto->measured;
+}
+
+static void _clock_update_loads(u32 mem_freq)
+{
     if (!g_act_base)
     {
         _svcQueryMemoryMappingFallback(&g_act_base, 0x6000C000ul, 0x1000);
     }
 
-    if(!g_act_base)
+    if(!g_act_base || !mem_freq)
     {
         return;
     }
 
-    const u32 osc = 38400000;
-    u32 coeff = GPU_TRIM_SYS_GPCPLL(GPU_TRIM_SYS_GPCPLL_COEFF);
-    u32 divm  = coeff & 0xFF;
-    u32 divn  = (coeff >>  8) & 0xFF;
-    u32 divp  = (coeff >> 16) & 0x3F;
-    g_gpu_freq = osc * divn / (divm * divp) / 2;
-
-    u32 emc_freq = g_mem_freq / 1000;
+    u32 emc_freq = mem_freq / 1000;
 
     // Check if actmon is disabled
-    if (!(ACTMON(ACTMON_GLB_STATUS) & ACTMON_MCALL_MON_ACT))
+    if (g_actmon_reprogram || !(ACTMON(ACTMON_GLB_STATUS) & ACTMON_MCALL_MON_ACT))
     {
-        ACTMON(ACTMON_GLB_PERIOD_CTRL) = ACTMON_GLB_PERIOD_SAMPLE(ACTMON_PERIOD_MS);
+        ACTMON(ACTMON_GLB_PERIOD_CTRL) = ACTMON_GLB_PERIOD_SAMPLE(g_actmon_period_ms);
         _actmon_dev_enable(ACTMON_DEV_MC_ALL, emc_freq, 256 * 4);
     }
 
     // Check if actmon is disabled
-    if (!(ACTMON(ACTMON_GLB_STATUS) & ACTMON_MCCPU_MON_ACT))
+    if (g_actmon_reprogram || !(ACTMON(ACTMON_GLB_STATUS) & ACTMON_MCCPU_MON_ACT))
         _actmon_dev_enable(ACTMON_DEV_MC_CPU, emc_freq, 256 * 4);
 
+    g_actmon_reprogram = false;
+
+    u64 count_all = _actmon_dev_get_count_avg(ACTMON_DEV_MC_ALL);
+    u64 count_cpu = _actmon_dev_get_count_avg(ACTMON_DEV_MC_CPU);
+
     // Get 1000 -> 100.0.
-    g_emc_lall = (u64)_actmon_dev_get_count_avg(ACTMON_DEV_MC_ALL) * 10 * 100 / (emc_freq * ACTMON_PERIOD_MS);
-    g_emc_lcpu = (u64)_actmon_dev_get_count_avg(ACTMON_DEV_MC_CPU) * 10 * 100 / (emc_freq * ACTMON_PERIOD_MS);
-}
+    g_emc_lall = count_all * 10 * 100 / (emc_freq * g_actmon_period_ms);
+    g_emc_lcpu = count_cpu * 10 * 100 / (emc_freq * g_actmon_period_ms);
 
+    // busy cycles per period -> MB/s, independent of the current EMC clock
+    g_emc_bwall = count_all * EMC_BYTES_PER_CLOCK / (g_actmon_period_ms * 1000);
+    g_emc_bwcpu = count_cpu * EMC_BYTES_PER_CLOCK / (g_actmon_period_ms * 1000);
+}
 
 u32 t210ClkCpuFreq(void)
 {
-    _clock_update_freqs();
-    return g_cpu_freq;
+    if (!_clock_map())
+    {
+        return 0;
+    }
+
+    return _clock_get_freq(&g_cpu_pto, _clock_get_cpu_freq_fast());
 }
 
 u32 t210ClkMemFreq(void)
 {
-    _clock_update_freqs();
-    return g_mem_freq;
+    if (!_clock_map())
+    {
+        return 0;
+    }
+
+    return _clock_get_freq(&g_mem_pto, _clock_get_emc_freq_fast());
 }
 
 u32 t210ClkGpuFreq(void)
 {
-    _clock_update_freqs();
-    return g_gpu_freq;
+    if (!_clock_map())
+    {
+        return 0;
+    }
+
+    if (!g_gpu_base)
+    {
+        _svcQueryMemoryMappingFallback(&g_gpu_base, 0x57000000ul, 0x1000000);
+    }
+
+    if (!g_gpu_base)
+    {
+        return 0;
+    }
+
+    bool gpu_enabled = (CLOCK(CLK_RST_CONTROLLER_CLK_OUT_ENB_X) & BIT(24)) && !(CLOCK(CLK_RST_CONTROLLER_RST_DEVICES_X) & BIT(24));
+    if(!gpu_enabled)
+    {
+        return 0;
+    }
+
+    const u32 osc = OSC_FREQ;
+    u32 coeff = GPU_TRIM_SYS_GPCPLL(GPU_TRIM_SYS_GPCPLL_COEFF);
+    u32 divm  = coeff & 0xFF;
+    u32 divn  = (coeff >>  8) & 0xFF;
+    u32 divp  = (coeff >> 16) & 0x3F;
+    return divm && divp ? (u64)osc * divn / (divm * divp) / 2 : 0;
 }
 
 u32 t210EmcLoadAll()
 {
-    _clock_update_freqs();
+    _clock_update_loads(t210ClkMemFreq());
     return g_emc_lall;
 }
 
 u32 t210EmcLoadCpu()
 {
-    _clock_update_freqs();
+    _clock_update_loads(t210ClkMemFreq());
     return g_emc_lcpu;
 }
+
+u32 t210EmcBandwidthAll()
+{
+    _clock_update_loads(t210ClkMemFreq());
+    return g_emc_bwall;
+}
+
+u32 t210EmcBandwidthCpu()
+{
+    _clock_update_loads(t210ClkMemFreq());
+    return g_emc_bwcpu;
+}
+
+void t210EmcSetActmonSampling(u32 period_ms, u32 k)
+{
+    period_ms = period_ms < 1 ? 1 : (period_ms > 256 ? 256 : period_ms);
+    k = k > 7 ? 7 : k;
+
+    if (period_ms != g_actmon_period_ms || k != g_actmon_k)
+    {
+        g_actmon_period_ms = period_ms;
+        g_actmon_k = k;
+        g_actmon_reprogram = true;
+    }
+}
@@ -20,8 +20,6 @@
 #include "nxExt/tmp451.h"
 #include "nxExt/i2c.h"
 
-#define TMP451_WAIT_NS 1000000000UL
-
 #define TMP451_PCB_TEMP_REG    0x00
 #define TMP451_SOC_TEMP_REG    0x01
 
@@ -29,46 +27,34 @@
 #define TMP451_PCB_TMP_DEC_REG 0x15
 
 static I2cSession g_i2c_session;
-static u64 g_update_ticks = 0;
 static s32 g_temp_pcb = 0;
 static s32 g_temp_soc = 0;
 
-static Result _tmp451_get_temp(u8 reg, u8 dec_reg, s32* out)
+static s32 _tmp451_to_milli(u8 val, u8 dec)
 {
-    u8 val = 0;
-    Result rc = i2csessionExtRegReceive(&g_i2c_session, reg, &val, sizeof(val));
-
-    if(R_SUCCEEDED(rc))
-    {
-        *out = (s32)val * 1000;
-        rc = i2csessionExtRegReceive(&g_i2c_session, dec_reg, &val, sizeof(val));
-    }
-
-    if(R_SUCCEEDED(rc))
-    {
-        *out += ((s32)(val >> 4) * 625) / 10;
-    }
-
-    return rc;
+    return (s32)val * 1000 + ((s32)(dec >> 4) * 625) / 10;
 }
 
-static void _tmp451_update()
+// integer and decimal registers in one command list
+static s32 _tmp451_get_temp(u8 reg, u8 dec_reg, s32* last)
 {
-    u64 ticks = armGetSystemTick();
-    if(armTicksToNs(ticks - g_update_ticks) <= TMP451_WAIT_NS)
+    if(!serviceIsActive(&g_i2c_session.s))
     {
-        return;
+        return *last;
     }
 
-    g_update_ticks = ticks;
+    u8 val[2] = {0};
+    I2cExtBatch batch;
+    i2cExtBatchInit(&batch, sizeof(u8), false);
+    i2cExtBatchAddRegReceive(&batch, reg, 1);
+    i2cExtBatchAddRegReceive(&batch, dec_reg, 1);
 
-    if(!serviceIsActive(&g_i2c_session.s))
+    if(R_SUCCEEDED(i2csessionExtBatchExecute(&g_i2c_session, &batch, val, sizeof(val))))
     {
-        return;
+        *last = _tmp451_to_milli(val[0], val[1]);
     }
 
-    _tmp451_get_temp(TMP451_PCB_TEMP_REG, TMP451_PCB_TMP_DEC_REG, &g_temp_pcb);
-    _tmp451_get_temp(TMP451_SOC_TEMP_REG, TMP451_SOC_TMP_DEC_REG, &g_temp_soc);
+    return *last;
 }
 
 Result tmp451Initialize(void)
@@ -91,12 +77,33 @@ void tmp451Exit(void)
 
 s32 tmp451TempPcb(void)
 {
-    _tmp451_update();
-    return g_temp_pcb;
+    return _tmp451_get_temp(TMP451_PCB_TEMP_REG, TMP451_PCB_TMP_DEC_REG, &g_temp_pcb);
 }
 
 s32 tmp451TempSoc(void)
 {
-    _tmp451_update();
-    return g_temp_soc;
+    return _tmp451_get_temp(TMP451_SOC_TEMP_REG, TMP451_SOC_TMP_DEC_REG, &g_temp_soc);
+}
+
+void tmp451GetTemps(s32* out_soc, s32* out_pcb)
+{
+    if(serviceIsActive(&g_i2c_session.s))
+    {
+        u8 val[4] = {0};
+        I2cExtBatch batch;
+        i2cExtBatchInit(&batch, sizeof(u8), false);
+        i2cExtBatchAddRegReceive(&batch, TMP451_SOC_TEMP_REG, 1);
+        i2cExtBatchAddRegReceive(&batch, TMP451_SOC_TMP_DEC_REG, 1);
+        i2cExtBatchAddRegReceive(&batch, TMP451_PCB_TEMP_REG, 1);
+        i2cExtBatchAddRegReceive(&batch, TMP451_PCB_TMP_DEC_REG, 1);
+
+        if(R_SUCCEEDED(i2csessionExtBatchExecute(&g_i2c_session, &batch, val, sizeof(val))))
+        {
+            g_temp_soc = _tmp451_to_milli(val[0], val[1]);
+            g_temp_pcb = _tmp451_to_milli(val[2], val[3]);
+        }
+    }
+
+    *out_soc = g_temp_soc;
+    *out_pcb = g_temp_pcb;
 }
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+#
+# --------------------------------------------------------------------------
+# "THE BEER-WARE LICENSE" (Revision 42):
+# <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+# wrote this file. As long as you retain this notice you can do whatever you
+# want with this stuff. If you meet any of us some day, and you think this
+# stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+# --------------------------------------------------------------------------
+#
+# Renders a sys-clk binary event log (log.bin) as text.
+#
+# The event table is read from sysmodule/src/log_events.h and the enum names
+# from common/include/sysclk/board.h, so this script never needs to be kept
+# in sync by hand.
+#
+# usage: decode_log.py log.bin
+
+import os
+import re
+import struct
+import sys
+import time
+
+ROOT_DIR = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", ".."))
+EVENTS_HEADER = os.path.join(ROOT_DIR, "sysmodule", "src", "log_events.h")
+BOARD_HEADER = os.path.join(ROOT_DIR, "common", "include", "sysclk", "board.h")
+METRICS_HEADER = os.path.join(ROOT_DIR, "common", "include", "sysclk", "metrics.h")
+
+RECORD_HEADER = struct.Struct("<QHBB")
+PLACEHOLDER_RE = re.compile(r"%([0-9]*)(l?)([udxXMPSWLHC%])")
+
+
+def load_events():
+    with open(EVENTS_HEADER) as f:
+        src = f.read()
+    table = src[src.index("#define SYSCLK_LOG_EVENTS(X)"):]
+    table = table[:table.index("\n\n")]
+    return [(name, fmt) for name, fmt in re.findall(r'X\((\w+),\s*"((?:[^"\\]|\\.)*)"\)', table)]
+
+
+def load_enum_names():
+    src = ""
+    for header in (BOARD_HEADER, METRICS_HEADER):
+        with open(header) as f:
+            src += f.read()
+    names = {}
+    for prefix in ("SysClkModule", "SysClkProfile", "SysClkThermalSensor", "SysClkPowerSensor", "SysClkMetricHistogram"):
+        values = re.findall(r"\b(" + prefix + r"_\w+)\b(?:\s*=\s*(\d+))?,", src)
+        index = {}
+        current = 0
+        for name, value in values:
+            if name.endswith("_EnumMax"):
+                continue
+            if value:
+                current = int(value)
+            index[name] = current
+            current += 1
+        pretty = dict(re.findall(r"case (" + prefix + r"_\w+):\s*return pretty \? \"([^\"]*)\"", src))
+        names[prefix] = {index[n]: pretty.get(n, n) for n in index}
+    return names
+
+
+class Renderer:
+    def __init__(self, enum_names):
+        self.enums = {
+            "M": enum_names["SysClkModule"],
+            "P": enum_names["SysClkProfile"],
+            "S": enum_names["SysClkThermalSensor"],
+            "W": enum_names["SysClkPowerSensor"],
+            "L": enum_names["SysClkMetricHistogram"],
+        }
+
+    def render(self, fmt, args):
+        args = list(args)
+
+        def pop():
+            return args.pop(0) if args else 0
+
+        def repl(m):
+            width, long_flag, conv = m.groups()
+            if conv == "%":
+                return "%"
+            if long_flag:
+                lo, hi = pop(), pop()
+                return ("%" + width + conv) % (lo | (hi << 32))
+            value = pop()
+            if conv == "d":
+                return ("%" + width + "d") % struct.unpack("<i", struct.pack("<I", value))[0]
+            if conv in "uxX":
+                return ("%" + width + conv) % value
+            if conv in self.enums:
+                return self.enums[conv].get(value, "?%u" % value)
+            if conv == "H":
+                return "%u.%u MHz" % (value // 1000000, value // 100000 - value // 1000000 * 10)
+            if conv == "C":
+                return "%u.%u °C" % (value // 1000, (value - value // 1000 * 1000) // 100)
+            return m.group(0)
+
+        return PLACEHOLDER_RE.sub(repl, fmt)
+
+
+def decode(path, out):
+    events = load_events()
+    renderer = Renderer(load_enum_names())
+
+    base_tick = None
+    base_ms = None
+    tick_freq = 19200000
+
+    with open(path, "rb") as f:
+        data = f.read()
+
+    offset = 0
+    while offset + RECORD_HEADER.size <= len(data):
+        tick, event, argc, _ = RECORD_HEADER.unpack_from(data, offset)
+        offset += RECORD_HEADER.size
+        if offset + argc * 4 > len(data):
+            out.write("[!] truncated record at offset %u\n" % (offset - RECORD_HEADER.size))
+            break
+        args = struct.unpack_from("<%uI" % argc, data, offset)
+        offset += argc * 4
+
+        if event >= len(events):
+            out.write("[!] unknown event %u (%u args)\n" % (event, argc))
+            continue
+
+        name, fmt = events[event]
+        if name == "Session" and argc >= 3:
+            base_tick = tick
+            base_ms = args[0] * 1000 + args[1]
+            tick_freq = args[2] or tick_freq
+
+        if base_tick is not None:
+            ms = base_ms + (tick - base_tick) * 1000 // tick_freq
+            stamp = time.strftime("%Y-%m-%d %H:%M:%S", time.localtime(ms // 1000)) + ".%03u" % (ms % 1000)
+        else:
+            stamp = "tick %u" % tick
+
+        out.write("[%s] %s\n" % (stamp, renderer.render(fmt, args)))
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 2:
+        sys.stderr.write("usage: %s log.bin\n" % sys.argv[0])
+        sys.exit(1)
+    decode(sys.argv[1], sys.stdout)
@@ -0,0 +1,43 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "arena.h"
+#include <cstring>
+#include "file_utils.h"
+
+alignas(16) std::uint8_t Arena::buffer[ARENA_SIZE];
+std::size_t Arena::used = 0;
+bool Arena::sealed = false;
+
+void* Arena::Allocate(std::size_t size, std::size_t align)
+{
+    std::size_t offset = (Arena::used + align - 1) & ~(align - 1);
+
+    if (Arena::sealed || offset + size > ARENA_SIZE)
+    {
+        FileUtils::LogLine("[arena] Cannot allocate %lu bytes (used %lu/%u, sealed = %u)", size, Arena::used, ARENA_SIZE, Arena::sealed);
+        return NULL;
+    }
+
+    Arena::used = offset + size;
+    memset(&Arena::buffer[offset], 0, size);
+
+    return &Arena::buffer[offset];
+}
+
+void Arena::Seal()
+{
+    Arena::sealed = true;
+}
+
+std::size_t Arena::GetUsed()
+{
+    return Arena::used;
+}
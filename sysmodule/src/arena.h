@@ -0,0 +1,40 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// config profile table (~9 KiB) + trace ring (12 KiB) + slack
+#define ARENA_SIZE 0x6000
+
+/*
+ * Bump allocator for the long-lived runtime tables, living outside of the
+ * newlib heap. Everything is carved during startup, then the arena is
+ * sealed: later requests fail instead of growing the heap behind our back.
+ */
+class Arena
+{
+  public:
+    static void* Allocate(std::size_t size, std::size_t align);
+    static void Seal();
+    static std::size_t GetUsed();
+
+    template<typename T>
+    static T* AllocateArray(std::size_t count)
+    {
+        return (T*)Allocate(sizeof(T) * count, alignof(T));
+    }
+
+  protected:
+    static std::uint8_t buffer[ARENA_SIZE];
+    static std::size_t used;
+    static bool sealed;
+};
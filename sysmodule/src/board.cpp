@@ -8,14 +8,13 @@
  * --------------------------------------------------------------------------
  */
 
-#include <nxExt.h>
 #include "board.h"
 #include "errors.h"
+#include "metrics.h"
+#include "trace.h"
+#include "input_recorder.h"
 
-#define HOSSVC_HAS_CLKRST (hosversionAtLeast(8,0,0))
-#define HOSSVC_HAS_TC (hosversionAtLeast(5,0,0))
-
-static SysClkSocType g_socType = SysClkSocType_Erista;
+BoardBackend* Board::backend = NULL;
 
 const char* Board::GetModuleName(SysClkModule module, bool pretty)
 {
@@ -41,337 +40,177 @@ const char* Board::GetPowerSensorName(SysClkPowerSensor sensor, bool pretty)
     return sysclkFormatPowerSensor(sensor, pretty);
 }
 
-PcvModule Board::GetPcvModule(SysClkModule sysclkModule)
+void Board::Initialize(BoardBackend* backend)
 {
-    switch(sysclkModule)
-    {
-        case SysClkModule_CPU:
-            return PcvModule_CpuBus;
-        case SysClkModule_GPU:
-            return PcvModule_GPU;
-        case SysClkModule_MEM:
-            return PcvModule_EMC;
-        default:
-            ASSERT_ENUM_VALID(SysClkModule, sysclkModule);
-    }
-
-    return (PcvModule)0;
+    Board::backend = backend;
+    Board::backend->Initialize();
 }
 
-PcvModuleId Board::GetPcvModuleId(SysClkModule sysclkModule)
+void Board::Exit()
 {
-    PcvModuleId pcvModuleId;
-    Result rc = pcvGetModuleId(&pcvModuleId, GetPcvModule(sysclkModule));
-    ASSERT_RESULT_OK(rc, "pcvGetModuleId");
-
-    return pcvModuleId;
+    Board::backend->Exit();
+    delete Board::backend;
+    Board::backend = NULL;
 }
 
-void Board::Initialize()
+Result Board::ResetToStock()
 {
-    Result rc = 0;
-
-    if(HOSSVC_HAS_CLKRST)
-    {
-        rc = clkrstInitialize();
-        ASSERT_RESULT_OK(rc, "clkrstInitialize");
-    }
-    else
-    {
-        rc = pcvInitialize();
-        ASSERT_RESULT_OK(rc, "pcvInitialize");
-    }
-
-    rc = apmExtInitialize();
-    ASSERT_RESULT_OK(rc, "apmExtInitialize");
-
-    rc = psmInitialize();
-    ASSERT_RESULT_OK(rc, "psmInitialize");
-
-    if(HOSSVC_HAS_TC)
-    {
-        rc = tcInitialize();
-        ASSERT_RESULT_OK(rc, "tcInitialize");
-    }
-
-    rc = max17050Initialize();
-    ASSERT_RESULT_OK(rc, "max17050Initialize");
-
-    rc = tmp451Initialize();
-    ASSERT_RESULT_OK(rc, "tmp451Initialize");
-
-    FetchHardwareInfos();
+    TRACE_SCOPE("Board::ResetToStock");
+    InputRecorder::RecordEvent(InputRecordType_ResetToStock, 0, NULL, 0);
+    return Board::backend->ResetToStock();
 }
 
-void Board::Exit()
+Result Board::GetProfile(SysClkProfile* out_profile)
 {
-    if(HOSSVC_HAS_CLKRST)
-    {
-        clkrstExit();
-    }
-    else
-    {
-        pcvExit();
-    }
-
-    apmExtExit();
-    psmExit();
-
-    if(HOSSVC_HAS_TC)
+    TRACE_SCOPE("Board::GetProfile");
+    Result rc = Board::backend->GetProfile(out_profile);
+    if(R_SUCCEEDED(rc))
     {
-        tcExit();
+        InputRecorder::RecordValue(InputRecordType_Profile, 0, *out_profile);
     }
 
-    max17050Exit();
-    tmp451Exit();
+    return rc;
 }
 
-SysClkProfile Board::GetProfile()
+Result Board::GetApplicationId(std::uint64_t* out_tid)
 {
-    std::uint32_t mode = 0;
-    Result rc = apmExtGetPerformanceMode(&mode);
-    ASSERT_RESULT_OK(rc, "apmExtGetPerformanceMode");
-
-    if(mode)
+    TRACE_SCOPE("Board::GetApplicationId");
+    Result rc = Board::backend->GetApplicationId(out_tid);
+    if(R_SUCCEEDED(rc))
     {
-        return SysClkProfile_Docked;
+        InputRecorder::RecordValue(InputRecordType_ApplicationId, 0, *out_tid);
     }
 
-    PsmChargerType chargerType;
-
-    rc = psmGetChargerType(&chargerType);
-    ASSERT_RESULT_OK(rc, "psmGetChargerType");
-
-    if(chargerType == PsmChargerType_EnoughPower)
-    {
-        return SysClkProfile_HandheldChargingOfficial;
-    }
-    else if(chargerType == PsmChargerType_LowPower)
-    {
-        return SysClkProfile_HandheldChargingUSB;
-    }
-
-    return SysClkProfile_Handheld;
+    return rc;
 }
 
-void Board::SetHz(SysClkModule module, std::uint32_t hz)
+Result Board::SetHz(SysClkModule module, std::uint32_t hz)
 {
-    Result rc = 0;
-
-    if(HOSSVC_HAS_CLKRST)
-    {
-        ClkrstSession session = {0};
-
-        rc = clkrstOpenSession(&session, Board::GetPcvModuleId(module), 3);
-        ASSERT_RESULT_OK(rc, "clkrstOpenSession");
-
-        rc = clkrstSetClockRate(&session, hz);
-        ASSERT_RESULT_OK(rc, "clkrstSetClockRate");
+    TRACE_SCOPE_ARG("Board::SetHz", module);
+    ASSERT_ENUM_VALID(SysClkModule, module);
+    InputRecorder::RecordValue(InputRecordType_SetHz, module, hz);
 
-        clkrstCloseSession(&session);
-    }
-    else
+    Result rc = Board::backend->SetHz(module, hz);
+    if(R_SUCCEEDED(rc))
     {
-        rc = pcvSetClockRate(Board::GetPcvModule(module), hz);
-        ASSERT_RESULT_OK(rc, "pcvSetClockRate");
+        Metrics::Increment(SysClkMetricCounter_ClockSets);
     }
+
+    return rc;
 }
 
-std::uint32_t Board::GetHz(SysClkModule module)
+Result Board::GetHz(SysClkModule module, std::uint32_t* out_hz)
 {
-    Result rc = 0;
-    std::uint32_t hz = 0;
-
-    if(HOSSVC_HAS_CLKRST)
-    {
-        ClkrstSession session = {0};
-
-        rc = clkrstOpenSession(&session, Board::GetPcvModuleId(module), 3);
-        ASSERT_RESULT_OK(rc, "clkrstOpenSession");
-
-        rc = clkrstGetClockRate(&session, &hz);
-        ASSERT_RESULT_OK(rc, "clkrstSetClockRate");
-
-        clkrstCloseSession(&session);
-    }
-    else
+    TRACE_SCOPE_ARG("Board::GetHz", module);
+    ASSERT_ENUM_VALID(SysClkModule, module);
+    Result rc = Board::backend->GetHz(module, out_hz);
+    if(R_SUCCEEDED(rc))
     {
-        rc = pcvGetClockRate(Board::GetPcvModule(module), &hz);
-        ASSERT_RESULT_OK(rc, "pcvGetClockRate");
+        InputRecorder::RecordValue(InputRecordType_Hz, module, *out_hz);
     }
 
-    return hz;
+    return rc;
 }
 
 std::uint32_t Board::GetRealHz(SysClkModule module)
 {
-    switch(module)
-    {
-        case SysClkModule_CPU:
-            return t210ClkCpuFreq();
-        case SysClkModule_GPU:
-            return t210ClkGpuFreq();
-        case SysClkModule_MEM:
-            return t210ClkMemFreq();
-        default:
-            ASSERT_ENUM_VALID(SysClkModule, module);
-    }
-
-    return 0;
+    TRACE_SCOPE_ARG("Board::GetRealHz", module);
+    ASSERT_ENUM_VALID(SysClkModule, module);
+    std::uint32_t hz = Board::backend->GetRealHz(module);
+    InputRecorder::RecordValue(InputRecordType_RealHz, module, hz);
+    return hz;
 }
 
-void Board::GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount)
+Result Board::GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount)
 {
-    Result rc = 0;
-    PcvClockRatesListType type;
-    s32 tmpInMaxCount = maxCount;
-    s32 tmpOutCount = 0;
-
-    if(HOSSVC_HAS_CLKRST)
-    {
-        ClkrstSession session = {0};
-
-        rc = clkrstOpenSession(&session, Board::GetPcvModuleId(module), 3);
-        ASSERT_RESULT_OK(rc, "clkrstOpenSession");
-
-        rc = clkrstGetPossibleClockRates(&session, outList, tmpInMaxCount, &type, &tmpOutCount);
-        ASSERT_RESULT_OK(rc, "clkrstGetPossibleClockRates");
-
-        clkrstCloseSession(&session);
-    }
-    else
-    {
-        rc = pcvGetPossibleClockRates(Board::GetPcvModule(module), outList, tmpInMaxCount, &type, &tmpOutCount);
-        ASSERT_RESULT_OK(rc, "pcvGetPossibleClockRates");
-    }
+    TRACE_SCOPE_ARG("Board::GetFreqList", module);
+    ASSERT_ENUM_VALID(SysClkModule, module);
+    return Board::backend->GetFreqList(module, outList, maxCount, outCount);
+}
 
-    if(type != PcvClockRatesListType_Discrete)
-    {
-        ERROR_THROW("Unexpected PcvClockRatesListType: %u (module = %s)", type, Board::GetModuleName(module, false));
-    }
+std::uint32_t Board::GetTemperatureMilli(SysClkThermalSensor sensor)
+{
+    TRACE_SCOPE_ARG("Board::GetTemperatureMilli", sensor);
+    ASSERT_ENUM_VALID(SysClkThermalSensor, sensor);
+    std::uint32_t millis = Board::backend->GetTemperatureMilli(sensor);
+    InputRecorder::RecordValue(InputRecordType_Temp, sensor, millis);
+    return millis;
+}
 
-    *outCount = tmpOutCount;
+// SOC and PCB share one device, read together
+void Board::GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb)
+{
+    TRACE_SCOPE("Board::GetBoardTemperatureMilli");
+    Board::backend->GetBoardTemperatureMilli(out_soc, out_pcb);
+    InputRecorder::RecordValue(InputRecordType_Temp, SysClkThermalSensor_SOC, *out_soc);
+    InputRecorder::RecordValue(InputRecordType_Temp, SysClkThermalSensor_PCB, *out_pcb);
 }
 
-void Board::ResetToStock()
+std::uint32_t Board::GetFanLevel()
 {
-    Result rc = 0;
-    if(hosversionAtLeast(9,0,0))
-    {
-        std::uint32_t confId = 0;
-        rc = apmExtGetCurrentPerformanceConfiguration(&confId);
-        ASSERT_RESULT_OK(rc, "apmExtGetCurrentPerformanceConfiguration");
-
-        SysClkApmConfiguration* apmConfiguration = NULL;
-        for(size_t i = 0; sysclk_g_apm_configurations[i].id; i++)
-        {
-            if(sysclk_g_apm_configurations[i].id == confId)
-            {
-                apmConfiguration = &sysclk_g_apm_configurations[i];
-                break;
-            }
-        }
-
-        if(!apmConfiguration)
-        {
-            ERROR_THROW("Unknown apm configuration: %x", confId);
-        }
-
-        Board::SetHz(SysClkModule_CPU, apmConfiguration->cpu_hz);
-        Board::SetHz(SysClkModule_GPU, apmConfiguration->gpu_hz);
-        Board::SetHz(SysClkModule_MEM, apmConfiguration->mem_hz);
-    }
-    else
-    {
-        std::uint32_t mode = 0;
-        rc = apmExtGetPerformanceMode(&mode);
-        ASSERT_RESULT_OK(rc, "apmExtGetPerformanceMode");
+    TRACE_SCOPE("Board::GetFanLevel");
+    std::uint32_t permille = Board::backend->GetFanLevel();
+    InputRecorder::RecordValue(InputRecordType_FanLevel, 0, permille);
+    return permille;
+}
 
-        rc = apmExtSysRequestPerformanceMode(mode);
-        ASSERT_RESULT_OK(rc, "apmExtSysRequestPerformanceMode");
-    }
+std::uint32_t Board::GetChargerPowerMw()
+{
+    TRACE_SCOPE("Board::GetChargerPowerMw");
+    std::uint32_t mw = Board::backend->GetChargerPowerMw();
+    InputRecorder::RecordValue(InputRecordType_ChargerPower, 0, mw);
+    return mw;
 }
 
-std::uint32_t Board::GetTemperatureMilli(SysClkThermalSensor sensor)
+void Board::GetBattery(BoardBattery* out_battery)
 {
-    std::int32_t millis = 0;
+    TRACE_SCOPE("Board::GetBattery");
+    Board::backend->GetBattery(out_battery);
 
-    if(sensor == SysClkThermalSensor_SOC)
-    {
-        millis = tmp451TempSoc();
-    }
-    else if(sensor == SysClkThermalSensor_PCB)
-    {
-        millis = tmp451TempPcb();
-    }
-    else if(sensor == SysClkThermalSensor_Skin)
-    {
-        if(HOSSVC_HAS_TC)
-        {
-            Result rc;
-            rc = tcGetSkinTemperatureMilliC(&millis);
-            ASSERT_RESULT_OK(rc, "tcGetSkinTemperatureMilliC");
-        }
-    }
-    else
+    for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
     {
-        ASSERT_ENUM_VALID(SysClkThermalSensor, sensor);
+        InputRecorder::RecordValue(InputRecordType_Power, sensor, (std::uint32_t)out_battery->powerMw[sensor]);
     }
 
-    return std::max(0, millis);
-}
-
-std::int32_t Board::GetPowerMw(SysClkPowerSensor sensor)
-{
-    switch(sensor)
+    for (unsigned int value = 0; value < SysClkBatteryValue_EnumMax; value++)
     {
-        case SysClkPowerSensor_Now:
-            return max17050PowerNow();
-        case SysClkPowerSensor_Avg:
-            return max17050PowerAvg();
-        default:
-            ASSERT_ENUM_VALID(SysClkPowerSensor, sensor);
+        InputRecorder::RecordValue(InputRecordType_Battery, value, (std::uint32_t)out_battery->values[value]);
     }
-
-    return 0;
 }
 
 std::uint32_t Board::GetRamLoad(SysClkRamLoad loadSource)
 {
-    switch(loadSource)
-    {
-        case SysClkRamLoad_All:
-            return t210EmcLoadAll();
-        case SysClkRamLoad_Cpu:
-            return t210EmcLoadCpu();
-        default:
-            ASSERT_ENUM_VALID(SysClkRamLoad, loadSource);
-    }
-
-    return 0;
+    TRACE_SCOPE_ARG("Board::GetRamLoad", loadSource);
+    ASSERT_ENUM_VALID(SysClkRamLoad, loadSource);
+    std::uint32_t load = Board::backend->GetRamLoad(loadSource);
+    InputRecorder::RecordValue(InputRecordType_RamLoad, loadSource, load);
+    return load;
 }
 
-SysClkSocType Board::GetSocType() {
-    return g_socType;
+std::uint32_t Board::GetRamBandwidth(SysClkRamLoad loadSource)
+{
+    TRACE_SCOPE_ARG("Board::GetRamBandwidth", loadSource);
+    ASSERT_ENUM_VALID(SysClkRamLoad, loadSource);
+    std::uint32_t mbps = Board::backend->GetRamBandwidth(loadSource);
+    InputRecorder::RecordValue(InputRecordType_RamBandwidth, loadSource, mbps);
+    return mbps;
 }
 
-void Board::FetchHardwareInfos()
+void Board::SetRamSampling(std::uint32_t periodMs, std::uint32_t window)
 {
-    u64 sku = 0;
-    Result rc = splInitialize();
-    ASSERT_RESULT_OK(rc, "splInitialize");
-
-    rc = splGetConfig(SplConfigItem_HardwareType, &sku);
-    ASSERT_RESULT_OK(rc, "splGetConfig");
+    Board::backend->SetRamSampling(periodMs, window);
+}
 
-    splExit();
+std::uint32_t Board::GetCpuLoad(SysClkCpuCore core)
+{
+    TRACE_SCOPE_ARG("Board::GetCpuLoad", core);
+    ASSERT_ENUM_VALID(SysClkCpuCore, core);
+    std::uint32_t load = Board::backend->GetCpuLoad(core);
+    InputRecorder::RecordValue(InputRecordType_CpuLoad, core, load);
+    return load;
+}
 
-    switch(sku)
-    {
-        case 2 ... 5:
-            g_socType = SysClkSocType_Mariko;
-            break;
-        default:
-            g_socType = SysClkSocType_Erista;
-    }
+SysClkSocType Board::GetSocType()
+{
+    return Board::backend->GetSocType();
 }
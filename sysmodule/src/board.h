@@ -12,6 +12,7 @@
 #include <cstdint>
 #include <switch.h>
 #include <sysclk.h>
+#include "board_backend.h"
 
 class Board
 {
@@ -20,21 +21,26 @@ class Board
     static const char* GetModuleName(SysClkModule module, bool pretty);
     static const char* GetThermalSensorName(SysClkThermalSensor sensor, bool pretty);
     static const char* GetPowerSensorName(SysClkPowerSensor sensor, bool pretty);
-    static void Initialize();
+    static void Initialize(BoardBackend* backend);
     static void Exit();
-    static void ResetToStock();
-    static SysClkProfile GetProfile();
-    static void SetHz(SysClkModule module, std::uint32_t hz);
-    static std::uint32_t GetHz(SysClkModule module);
+    static Result ResetToStock();
+    static Result GetProfile(SysClkProfile* out_profile);
+    static Result GetApplicationId(std::uint64_t* out_tid);
+    static Result SetHz(SysClkModule module, std::uint32_t hz);
+    static Result GetHz(SysClkModule module, std::uint32_t* out_hz);
     static std::uint32_t GetRealHz(SysClkModule module);
-    static void GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount);
+    static Result GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount);
     static std::uint32_t GetTemperatureMilli(SysClkThermalSensor sensor);
-    static std::int32_t GetPowerMw(SysClkPowerSensor sensor);
+    static void GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb);
+    static std::uint32_t GetFanLevel();
+    static std::uint32_t GetChargerPowerMw();
+    static void GetBattery(BoardBattery* out_battery);
     static std::uint32_t GetRamLoad(SysClkRamLoad load);
+    static std::uint32_t GetRamBandwidth(SysClkRamLoad load);
+    static void SetRamSampling(std::uint32_t periodMs, std::uint32_t window);
+    static std::uint32_t GetCpuLoad(SysClkCpuCore core);
     static SysClkSocType GetSocType();
 
   protected:
-    static void FetchHardwareInfos();
-    static PcvModule GetPcvModule(SysClkModule sysclkModule);
-    static PcvModuleId GetPcvModuleId(SysClkModule sysclkModule);
+    static BoardBackend* backend;
 };
@@ -0,0 +1,52 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdint>
+#include <switch.h>
+#include <sysclk.h>
+
+// one fuel gauge read, power and battery values come from the same sample
+typedef struct
+{
+    std::int32_t powerMw[SysClkPowerSensor_EnumMax];
+    std::int32_t values[SysClkBatteryValue_EnumMax];
+} BoardBattery;
+
+/*
+ * Everything sys-clk reads from or writes to the console goes through one of
+ * these, selected once by Board::Initialize. Enums are validated by Board
+ * before reaching a backend.
+ */
+class BoardBackend
+{
+  public:
+    virtual ~BoardBackend() {}
+
+    virtual void Initialize() = 0;
+    virtual void Exit() = 0;
+    virtual Result ResetToStock() = 0;
+    virtual Result GetProfile(SysClkProfile* out_profile) = 0;
+    virtual Result GetApplicationId(std::uint64_t* out_tid) = 0;
+    virtual Result SetHz(SysClkModule module, std::uint32_t hz) = 0;
+    virtual Result GetHz(SysClkModule module, std::uint32_t* out_hz) = 0;
+    virtual std::uint32_t GetRealHz(SysClkModule module) = 0;
+    virtual Result GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount) = 0;
+    virtual std::uint32_t GetTemperatureMilli(SysClkThermalSensor sensor) = 0;
+    virtual void GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb) = 0;
+    virtual std::uint32_t GetFanLevel() = 0;
+    virtual void GetBattery(BoardBattery* out_battery) = 0;
+    virtual std::uint32_t GetChargerPowerMw() = 0;
+    virtual std::uint32_t GetRamLoad(SysClkRamLoad load) = 0;
+    virtual std::uint32_t GetRamBandwidth(SysClkRamLoad load) = 0;
+    virtual void SetRamSampling(std::uint32_t periodMs, std::uint32_t window) = 0;
+    virtual std::uint32_t GetCpuLoad(SysClkCpuCore core) = 0;
+    virtual SysClkSocType GetSocType() = 0;
+};
@@ -0,0 +1,678 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "board_hos.h"
+#include <algorithm>
+#include <cstring>
+#include "board.h"
+#include "metrics.h"
+#include "file_utils.h"
+#include "process_management.h"
+
+HosBoard::HosBoard()
+{
+    this->socType = SysClkSocType_Erista;
+    memset(this->telemetryOpen, 0, sizeof(this->telemetryOpen));
+    memset(this->cpuLoadLastTicks, 0, sizeof(this->cpuLoadLastTicks));
+    memset(this->cpuLoadLastIdleTicks, 0, sizeof(this->cpuLoadLastIdleTicks));
+    for(unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+    {
+        this->cpuLoadSamplers[core].ticks = 0;
+        this->cpuLoadSamplers[core].idleTicks = 0;
+        this->cpuLoadSamplers[core].running = false;
+    }
+}
+
+HosBoard* HosBoard::CreateDefault()
+{
+    if(HOSSVC_HAS_CLKRST)
+    {
+        return new ClkrstBoard();
+    }
+
+    return new PcvBoard();
+}
+
+PcvModule HosBoard::GetPcvModule(SysClkModule module)
+{
+    switch(module)
+    {
+        case SysClkModule_CPU:
+            return PcvModule_CpuBus;
+        case SysClkModule_GPU:
+            return PcvModule_GPU;
+        case SysClkModule_MEM:
+            return PcvModule_EMC;
+        default:
+            ASSERT_ENUM_VALID(SysClkModule, module);
+    }
+
+    return (PcvModule)0;
+}
+
+Result HosBoard::CheckFreqListType(SysClkModule module, PcvClockRatesListType type)
+{
+    if(type != PcvClockRatesListType_Discrete)
+    {
+        FileUtils::LogLine("[brd] Unexpected PcvClockRatesListType: %u (module = %s)", type, Board::GetModuleName(module, false));
+        return SYSCLK_ERROR(Generic);
+    }
+
+    return 0;
+}
+
+void HosBoard::Initialize()
+{
+    Result rc = apmExtInitialize();
+    ASSERT_RESULT_OK(rc, "apmExtInitialize");
+
+    rc = psmInitialize();
+    ASSERT_RESULT_OK(rc, "psmInitialize");
+
+    this->FetchHardwareInfos();
+    this->StartCpuLoadSamplers();
+}
+
+void HosBoard::Exit()
+{
+    this->StopCpuLoadSamplers();
+    apmExtExit();
+    psmExit();
+    this->CloseTelemetry();
+}
+
+// telemetry services are only opened on first read, they are not needed to apply clocks
+Result HosBoard::OpenTelemetry(ErrorService service)
+{
+    std::scoped_lock lock{this->telemetryMutex};
+
+    if(this->telemetryOpen[service])
+    {
+        return 0;
+    }
+
+    Result rc = Errors::ServiceReady(service);
+    if(R_FAILED(rc))
+    {
+        return rc;
+    }
+
+    switch(service)
+    {
+        case ErrorService_Tc:
+            rc = Errors::ServiceResult(service, tcInitialize(), "tcInitialize");
+            break;
+        case ErrorService_Max17050:
+            rc = Errors::ServiceResult(service, max17050Initialize(), "max17050Initialize");
+            break;
+        case ErrorService_Tmp451:
+            rc = Errors::ServiceResult(service, tmp451Initialize(), "tmp451Initialize");
+            break;
+        case ErrorService_Fan:
+            rc = Errors::ServiceResult(service, fanInitialize(), "fanInitialize");
+            if(R_SUCCEEDED(rc))
+            {
+                rc = Errors::ServiceResult(service, fanOpenController(&this->fanController, HOS_FAN_DEVICE_CODE), "fanOpenController");
+                if(R_FAILED(rc))
+                {
+                    fanExit();
+                }
+            }
+            break;
+        default:
+            return SYSCLK_ERROR(Generic);
+    }
+
+    this->telemetryOpen[service] = R_SUCCEEDED(rc);
+    return rc;
+}
+
+void HosBoard::CloseTelemetry()
+{
+    std::scoped_lock lock{this->telemetryMutex};
+
+    if(this->telemetryOpen[ErrorService_Tc])
+    {
+        tcExit();
+    }
+
+    if(this->telemetryOpen[ErrorService_Max17050])
+    {
+        max17050Exit();
+    }
+
+    if(this->telemetryOpen[ErrorService_Tmp451])
+    {
+        tmp451Exit();
+    }
+
+    if(this->telemetryOpen[ErrorService_Fan])
+    {
+        fanControllerClose(&this->fanController);
+        fanExit();
+    }
+
+    memset(this->telemetryOpen, 0, sizeof(this->telemetryOpen));
+    memset(this->cpuLoadLastTicks, 0, sizeof(this->cpuLoadLastTicks));
+    memset(this->cpuLoadLastIdleTicks, 0, sizeof(this->cpuLoadLastIdleTicks));
+}
+
+Result HosBoard::GetProfile(SysClkProfile* out_profile)
+{
+    std::uint32_t mode = 0;
+    Metrics::Increment(SysClkMetricCounter_ApmCalls);
+    SERVICE_TRY(ErrorService_Apm, apmExtGetPerformanceMode(&mode));
+
+    if(mode)
+    {
+        *out_profile = SysClkProfile_Docked;
+        return 0;
+    }
+
+    PsmChargerType chargerType;
+
+    Metrics::Increment(SysClkMetricCounter_PsmCalls);
+    SERVICE_TRY(ErrorService_Psm, psmGetChargerType(&chargerType));
+
+    if(chargerType == PsmChargerType_EnoughPower)
+    {
+        *out_profile = SysClkProfile_HandheldChargingOfficial;
+    }
+    else if(chargerType == PsmChargerType_LowPower)
+    {
+        *out_profile = SysClkProfile_HandheldChargingUSB;
+    }
+    else
+    {
+        *out_profile = SysClkProfile_Handheld;
+    }
+
+    return 0;
+}
+
+Result HosBoard::GetApplicationId(std::uint64_t* out_tid)
+{
+    return ProcessManagement::GetCurrentApplicationId(out_tid);
+}
+
+Result HosBoard::ResetToStock()
+{
+    if(hosversionAtLeast(9,0,0))
+    {
+        std::uint32_t confId = 0;
+        Metrics::Increment(SysClkMetricCounter_ApmCalls);
+        SERVICE_TRY(ErrorService_Apm, apmExtGetCurrentPerformanceConfiguration(&confId));
+
+        SysClkApmConfiguration* apmConfiguration = NULL;
+        for(size_t i = 0; sysclk_g_apm_configurations[i].id; i++)
+        {
+            if(sysclk_g_apm_configurations[i].id == confId)
+            {
+                apmConfiguration = &sysclk_g_apm_configurations[i];
+                break;
+            }
+        }
+
+        if(!apmConfiguration)
+        {
+            FileUtils::LogLine("[brd] Unknown apm configuration: %x", confId);
+            return SYSCLK_ERROR(Generic);
+        }
+
+        Result rc = this->SetHz(SysClkModule_CPU, apmConfiguration->cpu_hz);
+        if(R_SUCCEEDED(rc))
+        {
+            rc = this->SetHz(SysClkModule_GPU, apmConfiguration->gpu_hz);
+        }
+        if(R_SUCCEEDED(rc))
+        {
+            rc = this->SetHz(SysClkModule_MEM, apmConfiguration->mem_hz);
+        }
+
+        return rc;
+    }
+
+    std::uint32_t mode = 0;
+    Metrics::Increment(SysClkMetricCounter_ApmCalls, 2);
+    SERVICE_TRY(ErrorService_Apm, apmExtGetPerformanceMode(&mode));
+    SERVICE_TRY(ErrorService_Apm, apmExtSysRequestPerformanceMode(mode));
+
+    return 0;
+}
+
+std::uint32_t HosBoard::GetRealHz(SysClkModule module)
+{
+    switch(module)
+    {
+        case SysClkModule_CPU:
+            return t210ClkCpuFreq();
+        case SysClkModule_GPU:
+            return t210ClkGpuFreq();
+        case SysClkModule_MEM:
+            return t210ClkMemFreq();
+        default:
+            ASSERT_ENUM_VALID(SysClkModule, module);
+    }
+
+    return 0;
+}
+
+std::uint32_t HosBoard::GetTemperatureMilli(SysClkThermalSensor sensor)
+{
+    std::int32_t millis = 0;
+
+    if(sensor == SysClkThermalSensor_SOC)
+    {
+        if(R_SUCCEEDED(this->OpenTelemetry(ErrorService_Tmp451)))
+        {
+            millis = tmp451TempSoc();
+        }
+    }
+    else if(sensor == SysClkThermalSensor_PCB)
+    {
+        if(R_SUCCEEDED(this->OpenTelemetry(ErrorService_Tmp451)))
+        {
+            millis = tmp451TempPcb();
+        }
+    }
+    else if(sensor == SysClkThermalSensor_Skin)
+    {
+        // unknown reads as 0, same as the i2c sensors
+        if(HOSSVC_HAS_TC && R_SUCCEEDED(this->OpenTelemetry(ErrorService_Tc)) && R_SUCCEEDED(Errors::ServiceReady(ErrorService_Tc)))
+        {
+            Metrics::Increment(SysClkMetricCounter_TcCalls);
+            if(R_FAILED(Errors::ServiceResult(ErrorService_Tc, tcGetSkinTemperatureMilliC(&millis), "tcGetSkinTemperatureMilliC")))
+            {
+                millis = 0;
+            }
+        }
+    }
+    else
+    {
+        ASSERT_ENUM_VALID(SysClkThermalSensor, sensor);
+    }
+
+    return std::max(0, millis);
+}
+
+void HosBoard::GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb)
+{
+    std::int32_t soc = 0;
+    std::int32_t pcb = 0;
+
+    if(R_SUCCEEDED(this->OpenTelemetry(ErrorService_Tmp451)))
+    {
+        tmp451GetTemps(&soc, &pcb);
+    }
+
+    *out_soc = std::max(0, soc);
+    *out_pcb = std::max(0, pcb);
+}
+
+std::uint32_t HosBoard::GetFanLevel()
+{
+    float level = 0;
+
+    // unknown reads as 0, same as the temperatures
+    if(HOSSVC_HAS_FAN && R_SUCCEEDED(this->OpenTelemetry(ErrorService_Fan)) && R_SUCCEEDED(Errors::ServiceReady(ErrorService_Fan)))
+    {
+        Metrics::Increment(SysClkMetricCounter_FanCalls);
+        if(R_FAILED(Errors::ServiceResult(ErrorService_Fan, fanControllerGetRotationSpeedLevel(&this->fanController, &level), "fanControllerGetRotationSpeedLevel")))
+        {
+            level = 0;
+        }
+    }
+
+    return std::clamp((std::int32_t)(level * 1000), 0, 1000);
+}
+
+std::uint32_t HosBoard::GetChargerPowerMw()
+{
+    PsmBatteryChargeInfoFields info;
+
+    // unknown reads as 0, caps then only depend on the charger type
+    if(!HOSSVC_HAS_CHARGE_INFO || R_FAILED(Errors::ServiceReady(ErrorService_Psm)))
+    {
+        return 0;
+    }
+
+    Metrics::Increment(SysClkMetricCounter_PsmCalls);
+    if(R_FAILED(Errors::ServiceResult(ErrorService_Psm, psmGetBatteryChargeInfoFields(&info), "psmGetBatteryChargeInfoFields")))
+    {
+        return 0;
+    }
+
+    return (std::uint64_t)info.charger_voltage_limit * info.charger_current_limit / 1000;
+}
+
+void HosBoard::GetBattery(BoardBattery* out_battery)
+{
+    memset(out_battery, 0, sizeof(*out_battery));
+    if(R_FAILED(this->OpenTelemetry(ErrorService_Max17050)))
+    {
+        return;
+    }
+
+    Max17050Status status;
+    max17050GetStatus(&status);
+    out_battery->powerMw[SysClkPowerSensor_Now] = status.power_now_mw;
+    out_battery->powerMw[SysClkPowerSensor_Avg] = status.power_avg_mw;
+    out_battery->values[SysClkBatteryValue_ChargePermille] = status.charge_permille;
+    out_battery->values[SysClkBatteryValue_TempMilli] = status.temp_milli;
+    out_battery->values[SysClkBatteryValue_RemainingMah] = status.remaining_mah;
+    out_battery->values[SysClkBatteryValue_FullMah] = status.full_mah;
+    out_battery->values[SysClkBatteryValue_AvgCurrentMa] = status.avg_current_ma;
+}
+
+std::uint32_t HosBoard::GetRamLoad(SysClkRamLoad loadSource)
+{
+    switch(loadSource)
+    {
+        case SysClkRamLoad_All:
+            return t210EmcLoadAll();
+        case SysClkRamLoad_Cpu:
+            return t210EmcLoadCpu();
+        default:
+            ASSERT_ENUM_VALID(SysClkRamLoad, loadSource);
+    }
+
+    return 0;
+}
+
+std::uint32_t HosBoard::GetRamBandwidth(SysClkRamLoad loadSource)
+{
+    switch(loadSource)
+    {
+        case SysClkRamLoad_All:
+            return t210EmcBandwidthAll();
+        case SysClkRamLoad_Cpu:
+            return t210EmcBandwidthCpu();
+        default:
+            ASSERT_ENUM_VALID(SysClkRamLoad, loadSource);
+    }
+
+    return 0;
+}
+
+void HosBoard::SetRamSampling(std::uint32_t periodMs, std::uint32_t window)
+{
+    // actmon averages over 2^(K+1) samples, window is validated as a power of two
+    t210EmcSetActmonSampling(periodMs, __builtin_ctz(window) - 1);
+}
+
+void HosBoard::StartCpuLoadSamplers()
+{
+    for(unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+    {
+        HosCpuLoadSampler* sampler = &this->cpuLoadSamplers[core];
+        ueventCreate(&sampler->request, true);
+        if(R_FAILED(threadCreate(&sampler->thread, &HosBoard::CpuLoadThreadFunc, sampler, NULL, 0x1000, HOS_CPU_LOAD_PRIORITY, core)))
+        {
+            continue;
+        }
+
+        sampler->running = true;
+        if(R_FAILED(threadStart(&sampler->thread)))
+        {
+            sampler->running = false;
+            threadClose(&sampler->thread);
+        }
+    }
+}
+
+void HosBoard::StopCpuLoadSamplers()
+{
+    for(unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+    {
+        HosCpuLoadSampler* sampler = &this->cpuLoadSamplers[core];
+        if(sampler->running)
+        {
+            sampler->running = false;
+            ueventSignal(&sampler->request);
+            threadWaitForExit(&sampler->thread);
+            threadClose(&sampler->thread);
+        }
+    }
+}
+
+void HosBoard::CpuLoadThreadFunc(void* arg)
+{
+    HosCpuLoadSampler* sampler = (HosCpuLoadSampler*)arg;
+    while(true)
+    {
+        waitSingle(waiterForUEvent(&sampler->request), UINT64_MAX);
+        if(!sampler->running)
+        {
+            break;
+        }
+
+        std::uint64_t idleTicks = 0;
+        if(R_SUCCEEDED(svcGetInfo(&idleTicks, InfoType_IdleTickCount, INVALID_HANDLE, (u64)-1)))
+        {
+            std::scoped_lock lock{sampler->mutex};
+            sampler->ticks = armGetSystemTick();
+            sampler->idleTicks = idleTicks;
+        }
+    }
+}
+
+std::uint32_t HosBoard::GetCpuLoad(SysClkCpuCore core)
+{
+    // returns the read requested at the previous sample, the sampler ran whenever its core had time for it
+    HosCpuLoadSampler* sampler = &this->cpuLoadSamplers[core];
+    if(!sampler->running)
+    {
+        return 0;
+    }
+
+    std::uint64_t ticks = 0;
+    std::uint64_t idleTicks = 0;
+    {
+        std::scoped_lock lock{sampler->mutex};
+        ticks = sampler->ticks;
+        idleTicks = sampler->idleTicks;
+    }
+    ueventSignal(&sampler->request);
+
+    if(!ticks)
+    {
+        return 0;
+    }
+
+    // nothing above the lowest priority left the core idle long enough to run the sampler
+    if(this->cpuLoadLastTicks[core] && ticks == this->cpuLoadLastTicks[core])
+    {
+        return 1000;
+    }
+
+    // busy share of the time between the last two reads of this core
+    std::uint32_t permille = 0;
+    std::uint64_t elapsed = ticks - this->cpuLoadLastTicks[core];
+    std::uint64_t idle = idleTicks - this->cpuLoadLastIdleTicks[core];
+    if(this->cpuLoadLastTicks[core] && elapsed)
+    {
+        permille = 1000 - std::min(idle * 1000 / elapsed, (std::uint64_t)1000);
+    }
+
+    this->cpuLoadLastTicks[core] = ticks;
+    this->cpuLoadLastIdleTicks[core] = idleTicks;
+    return permille;
+}
+
+SysClkSocType HosBoard::GetSocType()
+{
+    return this->socType;
+}
+
+void HosBoard::FetchHardwareInfos()
+{
+    u64 sku = 0;
+    Result rc = splInitialize();
+    ASSERT_RESULT_OK(rc, "splInitialize");
+
+    rc = splGetConfig(SplConfigItem_HardwareType, &sku);
+    ASSERT_RESULT_OK(rc, "splGetConfig");
+
+    splExit();
+
+    switch(sku)
+    {
+        case 2 ... 5:
+            this->socType = SysClkSocType_Mariko;
+            break;
+        default:
+            this->socType = SysClkSocType_Erista;
+    }
+}
+
+void ClkrstBoard::Initialize()
+{
+    Result rc = clkrstInitialize();
+    ASSERT_RESULT_OK(rc, "clkrstInitialize");
+
+    HosBoard::Initialize();
+}
+
+void ClkrstBoard::Exit()
+{
+    clkrstExit();
+    HosBoard::Exit();
+}
+
+Result ClkrstBoard::OpenSession(SysClkModule module, ClkrstSession* out_session)
+{
+    PcvModuleId moduleId;
+
+    Result rc = pcvGetModuleId(&moduleId, HosBoard::GetPcvModule(module));
+    if(R_FAILED(rc))
+    {
+        return rc;
+    }
+
+    SERVICE_TRY(ErrorService_Clkrst, clkrstOpenSession(out_session, moduleId, 3));
+
+    return 0;
+}
+
+Result ClkrstBoard::SetHz(SysClkModule module, std::uint32_t hz)
+{
+    ClkrstSession session = {0};
+
+    Result rc = this->OpenSession(module, &session);
+    if(R_FAILED(rc))
+    {
+        return rc;
+    }
+
+    rc = Errors::ServiceResult(ErrorService_Clkrst, clkrstSetClockRate(&session, hz), "clkrstSetClockRate");
+
+    clkrstCloseSession(&session);
+    Metrics::Increment(SysClkMetricCounter_ClkrstCalls, 3);
+
+    return rc;
+}
+
+Result ClkrstBoard::GetHz(SysClkModule module, std::uint32_t* out_hz)
+{
+    ClkrstSession session = {0};
+
+    Result rc = this->OpenSession(module, &session);
+    if(R_FAILED(rc))
+    {
+        return rc;
+    }
+
+    rc = Errors::ServiceResult(ErrorService_Clkrst, clkrstGetClockRate(&session, out_hz), "clkrstGetClockRate");
+
+    clkrstCloseSession(&session);
+    Metrics::Increment(SysClkMetricCounter_ClkrstCalls, 3);
+
+    return rc;
+}
+
+Result ClkrstBoard::GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount)
+{
+    PcvClockRatesListType type;
+    s32 tmpInMaxCount = maxCount;
+    s32 tmpOutCount = 0;
+    ClkrstSession session = {0};
+
+    Result rc = this->OpenSession(module, &session);
+    if(R_FAILED(rc))
+    {
+        return rc;
+    }
+
+    rc = Errors::ServiceResult(ErrorService_Clkrst, clkrstGetPossibleClockRates(&session, outList, tmpInMaxCount, &type, &tmpOutCount), "clkrstGetPossibleClockRates");
+
+    clkrstCloseSession(&session);
+    Metrics::Increment(SysClkMetricCounter_ClkrstCalls, 3);
+
+    if(R_FAILED(rc))
+    {
+        return rc;
+    }
+
+    rc = HosBoard::CheckFreqListType(module, type);
+    if(R_SUCCEEDED(rc))
+    {
+        *outCount = tmpOutCount;
+    }
+
+    return rc;
+}
+
+void PcvBoard::Initialize()
+{
+    Result rc = pcvInitialize();
+    ASSERT_RESULT_OK(rc, "pcvInitialize");
+
+    HosBoard::Initialize();
+}
+
+void PcvBoard::Exit()
+{
+    pcvExit();
+    HosBoard::Exit();
+}
+
+Result PcvBoard::SetHz(SysClkModule module, std::uint32_t hz)
+{
+    Metrics::Increment(SysClkMetricCounter_PcvCalls);
+    SERVICE_TRY(ErrorService_Pcv, pcvSetClockRate(HosBoard::GetPcvModule(module), hz));
+
+    return 0;
+}
+
+Result PcvBoard::GetHz(SysClkModule module, std::uint32_t* out_hz)
+{
+    Metrics::Increment(SysClkMetricCounter_PcvCalls);
+    SERVICE_TRY(ErrorService_Pcv, pcvGetClockRate(HosBoard::GetPcvModule(module), out_hz));
+
+    return 0;
+}
+
+Result PcvBoard::GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount)
+{
+    PcvClockRatesListType type;
+    s32 tmpInMaxCount = maxCount;
+    s32 tmpOutCount = 0;
+
+    Metrics::Increment(SysClkMetricCounter_PcvCalls);
+    SERVICE_TRY(ErrorService_Pcv, pcvGetPossibleClockRates(HosBoard::GetPcvModule(module), outList, tmpInMaxCount, &type, &tmpOutCount));
+
+    Result rc = HosBoard::CheckFreqListType(module, type);
+    if(R_SUCCEEDED(rc))
+    {
+        *outCount = tmpOutCount;
+    }
+
+    return rc;
+}
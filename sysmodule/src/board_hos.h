@@ -0,0 +1,105 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdint>
+#include <switch.h>
+#include <nxExt.h>
+#include <sysclk.h>
+#include "board_backend.h"
+#include "errors.h"
+
+#define HOSSVC_HAS_CLKRST (hosversionAtLeast(8,0,0))
+#define HOSSVC_HAS_TC (hosversionAtLeast(5,0,0))
+#define HOSSVC_HAS_FAN (hosversionAtLeast(7,0,0))
+#define HOSSVC_HAS_CHARGE_INFO (hosversionAtLeast(17,0,0))
+#define HOS_FAN_DEVICE_CODE 0x3D000001
+// lowest priority granted in perms.json, game threads always preempt the samplers
+#define HOS_CPU_LOAD_PRIORITY 0x3F
+
+// parked on its core, idle ticks are only readable from the core itself
+struct HosCpuLoadSampler
+{
+    Thread thread;
+    UEvent request;
+    LockableMutex mutex;
+    std::uint64_t ticks;
+    std::uint64_t idleTicks;
+    bool running;
+};
+
+// apm, psm, pm, spl, tc, fan and the i2c sensors, shared by both clock backends
+class HosBoard : public BoardBackend
+{
+  public:
+    HosBoard();
+
+    static HosBoard* CreateDefault();
+
+    virtual void Initialize() override;
+    virtual void Exit() override;
+    virtual Result ResetToStock() override;
+    virtual Result GetProfile(SysClkProfile* out_profile) override;
+    virtual Result GetApplicationId(std::uint64_t* out_tid) override;
+    virtual std::uint32_t GetRealHz(SysClkModule module) override;
+    virtual std::uint32_t GetTemperatureMilli(SysClkThermalSensor sensor) override;
+    virtual void GetBoardTemperatureMilli(std::uint32_t* out_soc, std::uint32_t* out_pcb) override;
+    virtual std::uint32_t GetFanLevel() override;
+    virtual void GetBattery(BoardBattery* out_battery) override;
+    virtual std::uint32_t GetChargerPowerMw() override;
+    virtual std::uint32_t GetRamLoad(SysClkRamLoad load) override;
+    virtual std::uint32_t GetRamBandwidth(SysClkRamLoad load) override;
+    virtual void SetRamSampling(std::uint32_t periodMs, std::uint32_t window) override;
+    virtual std::uint32_t GetCpuLoad(SysClkCpuCore core) override;
+    virtual SysClkSocType GetSocType() override;
+
+  protected:
+    static PcvModule GetPcvModule(SysClkModule module);
+    static Result CheckFreqListType(SysClkModule module, PcvClockRatesListType type);
+    void FetchHardwareInfos();
+    Result OpenTelemetry(ErrorService service);
+    void CloseTelemetry();
+    void StartCpuLoadSamplers();
+    void StopCpuLoadSamplers();
+    static void CpuLoadThreadFunc(void* arg);
+
+    SysClkSocType socType;
+    LockableMutex telemetryMutex;
+    bool telemetryOpen[ErrorService_EnumMax];
+    FanController fanController;
+    std::uint64_t cpuLoadLastTicks[SysClkCpuCore_EnumMax];
+    std::uint64_t cpuLoadLastIdleTicks[SysClkCpuCore_EnumMax];
+    HosCpuLoadSampler cpuLoadSamplers[SysClkCpuCore_EnumMax];
+};
+
+// 8.0.0+, one clkrst session per call
+class ClkrstBoard : public HosBoard
+{
+  public:
+    virtual void Initialize() override;
+    virtual void Exit() override;
+    virtual Result SetHz(SysClkModule module, std::uint32_t hz) override;
+    virtual Result GetHz(SysClkModule module, std::uint32_t* out_hz) override;
+    virtual Result GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount) override;
+
+  protected:
+    Result OpenSession(SysClkModule module, ClkrstSession* out_session);
+};
+
+// up to 8.0.0
+class PcvBoard : public HosBoard
+{
+  public:
+    virtual void Initialize() override;
+    virtual void Exit() override;
+    virtual Result SetHz(SysClkModule module, std::uint32_t hz) override;
+    virtual Result GetHz(SysClkModule module, std::uint32_t* out_hz) override;
+    virtual Result GetFreqList(SysClkModule module, std::uint32_t* outList, std::uint32_t maxCount, std::uint32_t* outCount) override;
+};
@@ -12,40 +12,82 @@
 #include <cstring>
 #include "file_utils.h"
 #include "board.h"
-#include "process_management.h"
 #include "errors.h"
+#include "metrics.h"
+#include "trace.h"
+#include "flight_recorder.h"
+#include "freq_cache.h"
+#include "input_recorder.h"
 
 ClockManager::ClockManager()
 {
     this->config = Config::CreateDefault();
 
-    this->context = new SysClkContext;
-    this->context->applicationId = 0;
-    this->context->profile = SysClkProfile_Handheld;
-    this->context->enabled = false;
+    this->context.applicationId = 0;
+    this->context.profile = SysClkProfile_Handheld;
+    this->context.enabled = false;
     for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
     {
-        this->context->freqs[module] = 0;
-        this->context->realFreqs[module] = 0;
-        this->context->overrideFreqs[module] = 0;
-        this->RefreshFreqTableRow((SysClkModule)module);
+        this->context.freqs[module] = 0;
+        this->context.realFreqs[module] = 0;
+        this->context.overrideFreqs[module] = 0;
+        this->throttle[module].divergentMs = 0;
+        this->throttle[module].minRealHz = 0;
+        this->throttle[module].throttled = false;
     }
+    this->LoadFreqTable();
+
+    this->stats = Stats::CreateDefault();
+    for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        this->stats->SetFreqTable((SysClkModule)module, &this->freqTable[module].list[0], this->freqTable[module].count);
+    }
+    this->stats->Load();
+
+    this->sessions = Sessions::CreateDefault();
+    this->sampler = new SensorSampler(this->config);
 
     this->running = false;
     this->lastTempLogNs = 0;
     this->lastCsvWriteNs = 0;
+    this->lastStatsTick = 0;
+    this->lastStatsSaveNs = 0;
+    this->lastTickStart = 0;
+    this->watchdogTripped = false;
+    this->retryApply = false;
+    this->gpuCapHz = 0;
+    this->pollingBackoff = 1;
+    Metrics::SetThreadHandle(SysClkThread_Tick, envGetMainThreadHandle());
+    for(unsigned int path = 0; path < SysClkMetricHistogram_EnumMax; path++)
+    {
+        this->applyOrigins[path] = 0;
+    }
 }
 
 ClockManager::~ClockManager()
 {
+    delete this->sampler;
+    delete this->sessions;
+    delete this->stats;
     delete this->config;
-    delete this->context;
 }
 
 SysClkContext ClockManager::GetCurrentContext()
 {
     std::scoped_lock lock{this->contextMutex};
-    return *this->context;
+    return this->context;
+}
+
+void ClockManager::GetContextExt(SysClkContextExt* out_context)
+{
+    std::scoped_lock lock{this->contextMutex};
+    this->FillContextExt(out_context);
+}
+
+void ClockManager::FillContextExt(SysClkContextExt* out_context)
+{
+    out_context->context = this->context;
+    this->sampler->GetSampleInfo(out_context);
 }
 
 Config* ClockManager::GetConfig()
@@ -53,6 +95,16 @@ Config* ClockManager::GetConfig()
     return this->config;
 }
 
+Stats* ClockManager::GetStats()
+{
+    return this->stats;
+}
+
+Sessions* ClockManager::GetSessions()
+{
+    return this->sessions;
+}
+
 void ClockManager::SetRunning(bool running)
 {
     this->running = running;
@@ -84,21 +136,64 @@ bool ClockManager::IsAssignableHz(SysClkModule module, std::uint32_t hz)
     }
 }
 
+/*
+ * Default GPU caps, the row with the most watts the charger supplies wins.
+ * 0 W is what an unknown charger reads as and keeps the charger type caps,
+ * a known charger too weak to cover the draw gets the battery cap. Profiles
+ * without a row (official charger, docked) are not capped.
+ */
+static const ConfigGpuCap g_gpu_caps[] = {
+    { SysClkSocType_Erista, SysClkProfile_Handheld, 0, 460800000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldCharging, 0, 768000000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldCharging, 1, 460800000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldCharging, 10, 768000000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldCharging, 18, 921600000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldCharging, 30, 0 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldChargingUSB, 0, 768000000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldChargingUSB, 1, 460800000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldChargingUSB, 10, 768000000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldChargingUSB, 18, 921600000 },
+    { SysClkSocType_Erista, SysClkProfile_HandheldChargingUSB, 30, 0 },
+    { SysClkSocType_Mariko, SysClkProfile_Handheld, 0, 614400000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldCharging, 0, 768000000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldCharging, 1, 614400000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldCharging, 10, 768000000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldCharging, 18, 921600000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldCharging, 30, 0 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldChargingUSB, 0, 768000000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldChargingUSB, 1, 614400000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldChargingUSB, 10, 768000000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldChargingUSB, 18, 921600000 },
+    { SysClkSocType_Mariko, SysClkProfile_HandheldChargingUSB, 30, 0 },
+};
+
 std::uint32_t ClockManager::GetMaxAllowedHz(SysClkModule module, SysClkProfile profile)
 {
-    if(module == SysClkModule_GPU)
+    if(module != SysClkModule_GPU)
     {
-        if(profile < SysClkProfile_HandheldCharging)
-        {
-            return Board::GetSocType() == SysClkSocType_Mariko ? 614400000 : 460800000;
-        }
-        else if(profile <= SysClkProfile_HandheldChargingUSB)
+        return 0;
+    }
+
+    SysClkSocType soc = Board::GetSocType();
+    std::uint32_t chargerMw = this->sampler->GetChargerPowerMw();
+    const ConfigGpuCap* best = NULL;
+
+    for(const ConfigGpuCap& cap : g_gpu_caps)
+    {
+        if(cap.soc == soc && cap.profile == profile && (std::uint64_t)cap.watts * 1000 <= chargerMw && (!best || cap.watts > best->watts))
         {
-            return 768000000;
+            best = &cap;
         }
     }
 
-    return 0;
+    // [gpu_caps] rows replace the default with the same watts
+    ConfigGpuCap configCap;
+    if(this->config->FindGpuCap(soc, profile, chargerMw, &configCap) && (!best || configCap.watts >= best->watts))
+    {
+        return configCap.hz;
+    }
+
+    return best ? best->hz : 0;
 }
 
 std::uint32_t ClockManager::GetNearestHz(SysClkModule module, std::uint32_t inHz, std::uint32_t maxHz)
@@ -138,15 +233,47 @@ bool ClockManager::ConfigIntervalTimeout(SysClkConfigValue intervalMsConfigValue
     return shouldLog;
 }
 
-void ClockManager::RefreshFreqTableRow(SysClkModule module)
+void ClockManager::LoadFreqTable()
 {
-    std::scoped_lock lock{this->contextMutex};
+    std::uint32_t lists[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX];
+    std::uint32_t counts[SysClkModule_EnumMax];
+
+    if (FreqCache::Load(FILE_FREQ_CACHE_PATH, lists, counts))
+    {
+        for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            FileUtils::LogEvent(SysClkLogEvent_MgrFreqListCached, module, counts[module]);
+            this->RefreshFreqTableRow((SysClkModule)module, &lists[module][0], counts[module], false);
+        }
+        return;
+    }
+
+    bool complete = true;
+    for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        if (R_FAILED(Board::GetFreqList((SysClkModule)module, &lists[module][0], SYSCLK_FREQ_LIST_MAX, &counts[module])))
+        {
+            counts[module] = 0;
+        }
 
-    std::uint32_t freqs[SYSCLK_FREQ_LIST_MAX];
-    std::uint32_t count;
+        complete = complete && counts[module];
+        this->RefreshFreqTableRow((SysClkModule)module, &lists[module][0], counts[module], true);
+    }
 
-    FileUtils::LogLine("[mgr] %s freq list refresh", Board::GetModuleName(module, true));
-    Board::GetFreqList(module, &freqs[0], SYSCLK_FREQ_LIST_MAX, &count);
+    if (complete)
+    {
+        FreqCache::Save(FILE_FREQ_CACHE_PATH, lists, counts);
+    }
+}
+
+void ClockManager::RefreshFreqTableRow(SysClkModule module, const std::uint32_t* freqs, std::uint32_t count, bool verbose)
+{
+    std::scoped_lock lock{this->contextMutex};
+
+    if (verbose)
+    {
+        FileUtils::LogEvent(SysClkLogEvent_MgrFreqListRefresh, module);
+    }
 
     std::uint32_t* hz = &this->freqTable[module].list[0];
     this->freqTable[module].count = 0;
@@ -158,84 +285,353 @@ void ClockManager::RefreshFreqTableRow(SysClkModule module)
         }
 
         *hz = freqs[i];
-        FileUtils::LogLine("[mgr] %02u - %u - %u.%u MHz", this->freqTable[module].count, *hz, *hz/1000000, *hz/100000 - *hz/1000000*10);
+        if (verbose)
+        {
+            FileUtils::LogEvent(SysClkLogEvent_MgrFreqListEntry, this->freqTable[module].count, *hz, *hz);
+        }
 
         this->freqTable[module].count++;
         hz++;
     }
 
-    FileUtils::LogLine("[mgr] count = %u", this->freqTable[module].count);
+    if (verbose)
+    {
+        FileUtils::LogEvent(SysClkLogEvent_MgrFreqListCount, this->freqTable[module].count);
+    }
+}
+
+std::uint32_t ClockManager::GetFreqSlot(SysClkModule module, std::uint32_t hz)
+{
+    std::uint32_t count = this->freqTable[module].count;
+    std::uint32_t slot = count;
+
+    if(!hz)
+    {
+        return count;
+    }
+
+    // firmware may run clocks we filtered out of the table, account them to the nearest slot
+    std::uint32_t bestDelta = UINT32_MAX;
+    for(std::uint32_t i = 0; i < count; i++)
+    {
+        std::uint32_t freq = this->freqTable[module].list[i];
+        std::uint32_t delta = freq > hz ? freq - hz : hz - freq;
+        if(delta < bestDelta)
+        {
+            bestDelta = delta;
+            slot = i;
+        }
+    }
+
+    return slot;
+}
+
+void ClockManager::UpdateStats()
+{
+    std::uint64_t tick = armGetSystemTick();
+
+    if(!this->lastStatsTick)
+    {
+        this->lastStatsTick = tick;
+        return;
+    }
+
+    // time since the last tick is accounted to the state the context was left in
+    std::uint64_t ms = armTicksToNs(tick - this->lastStatsTick) / 1000000ULL;
+    if(ms)
+    {
+        std::uint32_t slots[SysClkModule_EnumMax];
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            slots[module] = this->GetFreqSlot((SysClkModule)module, this->context.freqs[module]);
+        }
+
+        this->stats->AddTime(this->context.applicationId, this->context.profile, slots, (std::uint32_t)ms);
+        this->sessions->Sample(&this->context, (std::uint32_t)ms);
+        this->UpdateThrottle((std::uint32_t)ms);
+        this->lastStatsTick += armNsToTicks(ms * 1000000ULL);
+    }
+
+    if(this->ConfigIntervalTimeout(SysClkConfigValue_StatsSaveIntervalMs, armTicksToNs(tick), &this->lastStatsSaveNs))
+    {
+        if(!this->stats->Save())
+        {
+            FileUtils::LogLine("[mgr] Could not save stats");
+        }
+    }
+}
+
+void ClockManager::UpdateThrottle(std::uint32_t ms)
+{
+    std::uint64_t tolerancePct = this->GetConfig()->GetConfigValue(SysClkConfigValue_ThrottleTolerancePct);
+    std::uint64_t sustainMs = this->GetConfig()->GetConfigValue(SysClkConfigValue_ThrottleSustainMs);
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        std::uint32_t targetHz = this->context.freqs[module];
+        std::uint32_t realHz = this->context.realFreqs[module];
+        std::uint32_t deltaHz = realHz > targetHz ? realHz - targetHz : targetHz - realHz;
+
+        // unknown clocks cannot be compared, treat them as on target
+        bool divergent = tolerancePct && targetHz && realHz && (std::uint64_t)deltaHz * 100 > tolerancePct * targetHz;
+
+        if (divergent)
+        {
+            this->throttle[module].divergentMs += ms;
+
+            if (!this->throttle[module].throttled && this->throttle[module].divergentMs >= sustainMs)
+            {
+                FileUtils::LogEvent(SysClkLogEvent_MgrThrottleStart, module, realHz, targetHz);
+                this->throttle[module].throttled = true;
+                this->throttle[module].minRealHz = realHz;
+                this->stats->AddThrottledTime(this->context.applicationId, (SysClkModule)module, this->throttle[module].divergentMs, true);
+            }
+            else if (this->throttle[module].throttled)
+            {
+                this->throttle[module].minRealHz = std::min(this->throttle[module].minRealHz, realHz);
+                this->stats->AddThrottledTime(this->context.applicationId, (SysClkModule)module, ms, false);
+            }
+        }
+        else
+        {
+            if (this->throttle[module].throttled)
+            {
+                FileUtils::LogEvent(SysClkLogEvent_MgrThrottleEnd, module, this->throttle[module].divergentMs, this->throttle[module].minRealHz);
+                this->throttle[module].throttled = false;
+            }
+
+            this->throttle[module].divergentMs = 0;
+        }
+    }
 }
 
 void ClockManager::Tick()
 {
+    TRACE_SCOPE("ClockManager::Tick");
     std::scoped_lock lock{this->contextMutex};
-    if (this->RefreshContext() || this->config->Refresh())
+    std::uint64_t startTick = armGetSystemTick();
+    Metrics::Wakeup(SysClkThread_Tick);
+    FlightRecord* record = FlightRecorder::Begin(startTick);
+    if (InputRecorder::BeginTick(startTick))
+    {
+        // recordings can start at any time, each carries its own freq table
+        for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+        {
+            InputRecorder::RecordEvent(InputRecordType_FreqList, module, &this->freqTable[module].list[0], this->freqTable[module].count * sizeof(std::uint32_t));
+        }
+    }
+    this->UpdateStats();
+    bool contextChanged = this->RefreshContext();
+    bool configChanged = !contextChanged && this->config->Refresh();
+    bool retryApply = this->retryApply;
+    this->retryApply = false;
+    record->refreshUs = Metrics::ElapsedUs(startTick);
+    if (configChanged)
+    {
+        // external edits are only noticed when polled
+        this->MarkApplyOrigin(SysClkMetricHistogram_ConfigApply, this->lastTickStart ? this->lastTickStart : startTick);
+    }
+
+    if (contextChanged || configChanged || retryApply)
     {
         std::uint32_t targetHz = 0;
         std::uint32_t maxHz = 0;
         std::uint32_t nearestHz = 0;
         for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
         {
-            targetHz = this->context->overrideFreqs[module];
+            targetHz = this->context.overrideFreqs[module];
 
             if(!targetHz)
             {
-                targetHz = this->config->GetAutoClockHz(this->context->applicationId, (SysClkModule)module, this->context->profile);
+                targetHz = this->config->GetAutoClockHz(this->context.applicationId, (SysClkModule)module, this->context.profile);
             }
 
-            if (targetHz)
+            record->targetHz[module] = targetHz;
+
+            if (targetHz && this->freqTable[module].count)
             {
-                maxHz = this->GetMaxAllowedHz((SysClkModule)module, this->context->profile);
+                maxHz = this->GetMaxAllowedHz((SysClkModule)module, this->context.profile);
                 nearestHz = this->GetNearestHz((SysClkModule)module, targetHz, maxHz);
 
-                if (nearestHz != this->context->freqs[module] && this->context->enabled)
+                if (nearestHz != this->context.freqs[module] && this->context.enabled)
                 {
-                    FileUtils::LogLine(
-                        "[mgr] %s clock set : %u.%u MHz (target = %u.%u MHz)",
-                        Board::GetModuleName((SysClkModule)module, true),
-                        nearestHz/1000000, nearestHz/100000 - nearestHz/1000000*10,
-                        targetHz/1000000, targetHz/100000 - targetHz/1000000*10
-                    );
-
-                    Board::SetHz((SysClkModule)module, nearestHz);
-                    this->context->freqs[module] = nearestHz;
+                    FileUtils::LogEvent(SysClkLogEvent_MgrClockSet, module, nearestHz, targetHz);
+
+                    // a failed set is retried on the next tick
+                    if (R_FAILED(Board::SetHz((SysClkModule)module, nearestHz)))
+                    {
+                        this->retryApply = true;
+                        continue;
+                    }
+
+                    this->context.freqs[module] = nearestHz;
                 }
             }
         }
     }
+
+    std::uint32_t firstApplyMs = 0;
+    std::uint32_t readyMs = 0;
+    if ((contextChanged || configChanged || retryApply) && this->context.enabled && !this->retryApply && Metrics::MarkFirstApply(&firstApplyMs, &readyMs))
+    {
+        FileUtils::LogEvent(SysClkLogEvent_MgrFirstApply, firstApplyMs, readyMs);
+    }
+
+    this->CompleteApplyLatencies(startTick, contextChanged || configChanged);
+    this->lastTickStart = startTick;
+
+    std::uint64_t tickUs = Metrics::ElapsedUs(startTick);
+    Metrics::Record(SysClkMetricHistogram_Tick, tickUs);
+
+    record->applicationId = this->context.applicationId;
+    record->profile = this->context.profile;
+    record->flags = (this->context.enabled ? FLIGHT_RECORD_FLAG_ENABLED : 0)
+        | (contextChanged ? FLIGHT_RECORD_FLAG_CONTEXT_CHANGED : 0)
+        | (configChanged ? FLIGHT_RECORD_FLAG_CONFIG_CHANGED : 0);
+    memcpy(record->appliedHz, this->context.freqs, sizeof(record->appliedHz));
+    memcpy(record->realHz, this->context.realFreqs, sizeof(record->realHz));
+    memcpy(record->temps, this->context.temps, sizeof(record->temps));
+    record->durationUs = std::min(tickUs, (std::uint64_t)UINT32_MAX);
+    FlightRecorder::End();
+
+    this->CheckWatchdog(tickUs);
+    this->UpdatePollingBackoff();
+}
+
+void ClockManager::UpdatePollingBackoff()
+{
+    std::uint32_t permille = 0;
+    if(!Metrics::SampleSelfUsage(&permille))
+    {
+        return;
+    }
+
+    std::uint32_t budget = this->config->GetConfigValue(SysClkConfigValue_CpuBudgetPermille);
+    std::uint32_t backoff = this->pollingBackoff;
+
+    // double the interval while over budget, halve it back once well under
+    if(budget && permille > budget)
+    {
+        backoff = std::min(backoff * 2, (std::uint32_t)CLOCK_MANAGER_MAX_BACKOFF);
+    }
+    else if(!budget || permille * 2 < budget)
+    {
+        backoff = std::max(backoff / 2, (std::uint32_t)1);
+    }
+
+    if(backoff != this->pollingBackoff)
+    {
+        FileUtils::LogEvent(SysClkLogEvent_MgrPollingBackoff, permille, budget, backoff);
+        this->pollingBackoff = backoff;
+    }
+}
+
+std::uint32_t ClockManager::GetPollingBackoff()
+{
+    return this->pollingBackoff;
+}
+
+std::uint32_t ClockManager::GetPollingIntervalMs()
+{
+    return this->GetConfig()->GetConfigValue(SysClkConfigValue_PollingIntervalMs) * this->pollingBackoff;
+}
+
+void ClockManager::CheckWatchdog(std::uint64_t tickUs)
+{
+    std::uint64_t watchdogMs = this->config->GetConfigValue(SysClkConfigValue_TickWatchdogMs);
+    bool overrun = watchdogMs && tickUs > watchdogMs * 1000ULL;
+
+    // dump once per stall, not on every slow tick of it
+    if(overrun && !this->watchdogTripped)
+    {
+        FlightRecorder::Dump(FILE_FLIGHT_RECORDER_PATH, "tick watchdog");
+        FileUtils::LogEvent(SysClkLogEvent_MgrTickOverrun, (std::uint32_t)std::min(tickUs, (std::uint64_t)UINT32_MAX), (std::uint32_t)watchdogMs);
+    }
+
+    this->watchdogTripped = overrun;
+}
+
+void ClockManager::MarkApplyOrigin(SysClkMetricHistogram path, std::uint64_t tick)
+{
+    // keep the earliest pending origin, the apply that follows covers all of them
+    std::uint64_t expected = 0;
+    this->applyOrigins[path].compare_exchange_strong(expected, tick);
+}
+
+void ClockManager::CompleteApplyLatencies(std::uint64_t startTick, bool applied)
+{
+    std::uint64_t budgetMs = this->config->GetConfigValue(SysClkConfigValue_ApplyLatencyBudgetMs);
+
+    for(unsigned int path = 0; path < SysClkMetricHistogram_EnumMax; path++)
+    {
+        std::uint64_t origin = this->applyOrigins[path];
+
+        // marked while this tick was running, handled by the next one
+        if(!origin || origin > startTick)
+        {
+            continue;
+        }
+
+        this->applyOrigins[path] = 0;
+
+        // nothing changed (e.g. same override set twice), no sample
+        if(!applied)
+        {
+            continue;
+        }
+
+        std::uint64_t us = Metrics::ElapsedUs(origin);
+        Metrics::Record((SysClkMetricHistogram)path, us);
+
+        if(budgetMs && us > budgetMs * 1000ULL)
+        {
+            FileUtils::LogEvent(SysClkLogEvent_MgrApplyOverBudget, path, (std::uint32_t)std::min(us, (std::uint64_t)UINT32_MAX), (std::uint32_t)budgetMs);
+        }
+    }
 }
 
 void ClockManager::WaitForNextTick()
 {
-    svcSleepThread(this->GetConfig()->GetConfigValue(SysClkConfigValue_PollingIntervalMs) * 1000000ULL);
+    svcSleepThread(this->GetPollingIntervalMs() * 1000000ULL);
 }
 
 bool ClockManager::RefreshContext()
 {
+    TRACE_SCOPE("ClockManager::RefreshContext");
     bool hasChanged = false;
 
     bool enabled = this->GetConfig()->Enabled();
-    if(enabled != this->context->enabled)
+    InputRecorder::RecordValue(InputRecordType_Enabled, 0, enabled);
+    if(enabled != this->context.enabled)
     {
-        this->context->enabled = enabled;
-        FileUtils::LogLine("[mgr] " TARGET " status: %s", enabled ? "enabled" : "disabled");
+        this->context.enabled = enabled;
+        FileUtils::LogEvent(enabled ? SysClkLogEvent_MgrEnabled : SysClkLogEvent_MgrDisabled);
         hasChanged = true;
     }
 
-    std::uint64_t applicationId = ProcessManagement::GetCurrentApplicationId();
-    if (applicationId != this->context->applicationId)
+    // on service errors keep the previous values, the call is retried with backoff
+    std::uint64_t applicationId = this->context.applicationId;
+    Board::GetApplicationId(&applicationId);
+    if (applicationId != this->context.applicationId)
     {
-        FileUtils::LogLine("[mgr] TitleID change: %016lX", applicationId);
-        this->context->applicationId = applicationId;
+        FileUtils::LogEvent(SysClkLogEvent_MgrTitleChange, applicationId);
+        // launches are only noticed when polled, count from the previous tick
+        this->MarkApplyOrigin(SysClkMetricHistogram_AppLaunchApply, this->lastTickStart ? this->lastTickStart : armGetSystemTick());
+        this->sessions->End();
+        this->sessions->Begin(applicationId);
+        this->context.applicationId = applicationId;
         hasChanged = true;
     }
 
-    SysClkProfile profile = Board::GetProfile();
-    if (profile != this->context->profile)
+    SysClkProfile profile = this->context.profile;
+    Board::GetProfile(&profile);
+    if (profile != this->context.profile)
     {
-        FileUtils::LogLine("[mgr] Profile change: %s", Board::GetProfileName(profile, true));
-        this->context->profile = profile;
+        FileUtils::LogEvent(SysClkLogEvent_MgrProfileChange, profile);
+        this->MarkApplyOrigin(SysClkMetricHistogram_ProfileChangeApply, this->lastTickStart ? this->lastTickStart : armGetSystemTick());
+        this->context.profile = profile;
+        // the charger is read right away, its caps may differ from the previous one
+        this->sampler->Invalidate(SysClkSensor_Power);
         hasChanged = true;
     }
 
@@ -243,87 +639,83 @@ bool ClockManager::RefreshContext()
     if(hasChanged)
     {
         Board::ResetToStock();
-        this->WaitForNextTick();
+        svcSleepThread(this->GetConfig()->GetConfigValue(SysClkConfigValue_PollingIntervalMs) * 1000000ULL);
     }
 
     std::uint32_t hz = 0;
     for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
     {
-        hz = Board::GetHz((SysClkModule)module);
-        if (hz != 0 && hz != this->context->freqs[module])
+        hz = 0;
+        Board::GetHz((SysClkModule)module, &hz);
+        if (hz != 0 && hz != this->context.freqs[module])
         {
-            FileUtils::LogLine("[mgr] %s clock change: %u.%u MHz", Board::GetModuleName((SysClkModule)module, true), hz/1000000, hz/100000 - hz/1000000*10);
-            this->context->freqs[module] = hz;
+            FileUtils::LogEvent(SysClkLogEvent_MgrClockChange, module, hz);
+            this->context.freqs[module] = hz;
             hasChanged = true;
         }
 
         hz = this->GetConfig()->GetOverrideHz((SysClkModule)module);
-        if (hz != this->context->overrideFreqs[module])
+        InputRecorder::RecordValue(InputRecordType_Override, module, hz);
+        if (hz != this->context.overrideFreqs[module])
         {
             if(hz)
             {
-                FileUtils::LogLine("[mgr] %s override change: %u.%u MHz", Board::GetModuleName((SysClkModule)module, true), hz/1000000, hz/100000 - hz/1000000*10);
+                FileUtils::LogEvent(SysClkLogEvent_MgrOverrideChange, module, hz);
             }
             else
             {
-                FileUtils::LogLine("[mgr] %s override disabled", Board::GetModuleName((SysClkModule)module, true));
+                FileUtils::LogEvent(SysClkLogEvent_MgrOverrideDisabled, module);
             }
-            this->context->overrideFreqs[module] = hz;
+            this->context.overrideFreqs[module] = hz;
             hasChanged = true;
         }
     }
 
     std::uint64_t ns = armTicksToNs(armGetSystemTick());
 
-    // temperatures do not and should not force a refresh, hasChanged untouched
-    std::uint32_t millis = 0;
-    bool shouldLogTemp = this->ConfigIntervalTimeout(SysClkConfigValue_TempLogIntervalMs, ns, &this->lastTempLogNs);
-    for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+    // sensors do not and should not force a refresh, hasChanged untouched
+    this->sampler->Sample(&this->context);
+
+    // except the charger when it moves the GPU cap, the clocks are applied again without a reset
+    std::uint32_t gpuCapHz = this->GetMaxAllowedHz(SysClkModule_GPU, this->context.profile);
+    if (gpuCapHz != this->gpuCapHz)
     {
-        millis = Board::GetTemperatureMilli((SysClkThermalSensor)sensor);
-        if(shouldLogTemp)
-        {
-            FileUtils::LogLine("[mgr] %s temp: %u.%u °C", Board::GetThermalSensorName((SysClkThermalSensor)sensor, true), millis/1000, (millis - millis/1000*1000) / 100);
-        }
-        this->context->temps[sensor] = millis;
+        FileUtils::LogEvent(SysClkLogEvent_MgrGpuCap, gpuCapHz, this->sampler->GetChargerPowerMw());
+        this->gpuCapHz = gpuCapHz;
+        hasChanged = true;
     }
 
-    // power stats do not and should not force a refresh, hasChanged untouched
-    std::int32_t mw = 0;
-    bool shouldLogPower = this->ConfigIntervalTimeout(SysClkConfigValue_PowerLogIntervalMs, ns, &this->lastPowerLogNs);
-    for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+    bool shouldLogTemp = this->ConfigIntervalTimeout(SysClkConfigValue_TempLogIntervalMs, ns, &this->lastTempLogNs);
+    for (unsigned int sensor = 0; shouldLogTemp && sensor < SysClkThermalSensor_EnumMax; sensor++)
     {
-        mw = Board::GetPowerMw((SysClkPowerSensor)sensor);
-        if(shouldLogPower)
-        {
-            FileUtils::LogLine("[mgr] Power %s: %d mW", Board::GetPowerSensorName((SysClkPowerSensor)sensor, false), mw);
-        }
-        this->context->power[sensor] = mw;
+        FileUtils::LogEvent(SysClkLogEvent_MgrTemp, sensor, this->context.temps[sensor]);
     }
 
-    // real freqs do not and should not force a refresh, hasChanged untouched
-    std::uint32_t realHz = 0;
-    bool shouldLogFreq = this->ConfigIntervalTimeout(SysClkConfigValue_FreqLogIntervalMs, ns, &this->lastFreqLogNs);
-    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    bool shouldLogPower = this->ConfigIntervalTimeout(SysClkConfigValue_PowerLogIntervalMs, ns, &this->lastPowerLogNs);
+    for (unsigned int sensor = 0; shouldLogPower && sensor < SysClkPowerSensor_EnumMax; sensor++)
     {
-        realHz = Board::GetRealHz((SysClkModule)module);
-        if(shouldLogFreq)
-        {
-            FileUtils::LogLine("[mgr] %s real freq: %u.%u MHz", Board::GetModuleName((SysClkModule)module, true), realHz/1000000, realHz/100000 - realHz/1000000*10);
-        }
-        this->context->realFreqs[module] = realHz;
+        FileUtils::LogEvent(SysClkLogEvent_MgrPower, sensor, this->context.power[sensor]);
     }
 
-    // ram load do not and should not force a refresh, hasChanged untouched
-    for (unsigned int loadSource = 0; loadSource < SysClkRamLoad_EnumMax; loadSource++)
+    bool shouldLogFreq = this->ConfigIntervalTimeout(SysClkConfigValue_FreqLogIntervalMs, ns, &this->lastFreqLogNs);
+    for (unsigned int module = 0; shouldLogFreq && module < SysClkModule_EnumMax; module++)
     {
-        this->context->ramLoad[loadSource] = Board::GetRamLoad((SysClkRamLoad)loadSource);
+        FileUtils::LogEvent(SysClkLogEvent_MgrRealFreq, module, this->context.realFreqs[module]);
     }
 
     if(this->ConfigIntervalTimeout(SysClkConfigValue_CsvWriteIntervalMs, ns, &this->lastCsvWriteNs))
     {
-        FileUtils::WriteContextToCsv(this->context);
+        SysClkContextExt contextExt;
+        this->FillContextExt(&contextExt);
+        FileUtils::WriteContextToCsv(&contextExt);
     }
 
+    FileUtils::SetRotationLimits(
+        this->GetConfig()->GetConfigValue(SysClkConfigValue_LogMaxSizeKb),
+        this->GetConfig()->GetConfigValue(SysClkConfigValue_CsvMaxSizeKb),
+        this->GetConfig()->GetConfigValue(SysClkConfigValue_FileRotateCount)
+    );
+    FileUtils::FlushLogEvents(false);
+
     return hasChanged;
 }
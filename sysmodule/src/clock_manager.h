@@ -14,9 +14,14 @@
 #include <sysclk.h>
 
 #include "config.h"
+#include "stats.h"
+#include "sessions.h"
 #include "board.h"
+#include "sensor_sampler.h"
 #include <nxExt/cpp/lockable_mutex.h>
 
+#define CLOCK_MANAGER_MAX_BACKOFF 8
+
 class ClockManager
 {
   public:
@@ -24,20 +29,34 @@ class ClockManager
     virtual ~ClockManager();
 
     SysClkContext GetCurrentContext();
+    void GetContextExt(SysClkContextExt* out_context);
     Config* GetConfig();
+    Stats* GetStats();
+    Sessions* GetSessions();
     void SetRunning(bool running);
     bool Running();
     void GetFreqList(SysClkModule module, std::uint32_t* list, std::uint32_t maxCount, std::uint32_t* outCount);
     void Tick();
     void WaitForNextTick();
+    std::uint32_t GetPollingIntervalMs();
+    std::uint32_t GetPollingBackoff();
+    void MarkApplyOrigin(SysClkMetricHistogram path, std::uint64_t tick);
 
   protected:
     bool IsAssignableHz(SysClkModule module, std::uint32_t hz);
     std::uint32_t GetMaxAllowedHz(SysClkModule module, SysClkProfile profile);
     std::uint32_t GetNearestHz(SysClkModule module, std::uint32_t inHz, std::uint32_t maxHz);
     bool ConfigIntervalTimeout(SysClkConfigValue intervalMsConfigValue, std::uint64_t ns, std::uint64_t* lastLogNs);
-    void RefreshFreqTableRow(SysClkModule module);
+    void LoadFreqTable();
+    void RefreshFreqTableRow(SysClkModule module, const std::uint32_t* freqs, std::uint32_t count, bool verbose);
+    std::uint32_t GetFreqSlot(SysClkModule module, std::uint32_t hz);
+    void UpdateStats();
+    void UpdateThrottle(std::uint32_t ms);
     bool RefreshContext();
+    void FillContextExt(SysClkContextExt* out_context);
+    void CompleteApplyLatencies(std::uint64_t startTick, bool applied);
+    void CheckWatchdog(std::uint64_t tickUs);
+    void UpdatePollingBackoff();
 
     std::atomic_bool running;
     LockableMutex contextMutex;
@@ -45,10 +64,26 @@ class ClockManager
       std::uint32_t count;
       std::uint32_t list[SYSCLK_FREQ_LIST_MAX];
     } freqTable[SysClkModule_EnumMax];
+    struct {
+      std::uint32_t divergentMs;
+      std::uint32_t minRealHz;
+      bool throttled;
+    } throttle[SysClkModule_EnumMax];
     Config* config;
-    SysClkContext* context;
+    Stats* stats;
+    Sessions* sessions;
+    SensorSampler* sampler;
+    SysClkContext context;
     std::uint64_t lastTempLogNs;
     std::uint64_t lastFreqLogNs;
     std::uint64_t lastPowerLogNs;
     std::uint64_t lastCsvWriteNs;
+    std::uint64_t lastStatsTick;
+    std::uint64_t lastStatsSaveNs;
+    std::uint64_t lastTickStart;
+    bool watchdogTripped;
+    bool retryApply;
+    std::uint32_t gpuCapHz;
+    std::atomic_uint32_t pollingBackoff;
+    std::atomic_uint64_t applyOrigins[SysClkMetricHistogram_EnumMax];
 };
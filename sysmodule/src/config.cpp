@@ -12,19 +12,30 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <unistd.h>
-#include <sstream>
 #include <algorithm>
 #include <cstring>
 #include "errors.h"
 #include "file_utils.h"
+#include "metrics.h"
+#include "signal_filter.h"
+#include "trace.h"
+#include "arena.h"
 
-Config::Config(std::string path)
+Config::Config(const char* path)
 {
-    this->path = path;
+    snprintf(this->path, sizeof(this->path), "%s", path);
     this->loaded = false;
-    this->profileMHzMap = std::map<std::tuple<std::uint64_t, SysClkProfile, SysClkModule>, std::uint32_t>();
-    this->profileCountMap = std::map<std::uint64_t, std::uint8_t>();
+    this->titleCount = 0;
+    this->titles = Arena::AllocateArray<ConfigTitleProfiles>(CONFIG_TITLES_MAX);
+    if(!this->titles)
+    {
+        ERROR_FATAL("Cannot allocate config profile table");
+    }
     this->mtime = 0;
+    this->lastCheckNs = 0;
+    this->written = false;
+    this->adoptMtime = false;
+    this->reloadRequested = false;
     this->enabled = false;
     for(unsigned int i = 0; i < SysClkModule_EnumMax; i++)
     {
@@ -35,6 +46,9 @@ Config::Config(std::string path)
     {
         this->configValues[i] = sysclkDefaultConfigValue((SysClkConfigValue)i);
     }
+
+    memset(this->filterSpecs, 0, sizeof(this->filterSpecs));
+    this->gpuCapCount = 0;
 }
 
 Config::~Config()
@@ -50,17 +64,19 @@ Config* Config::CreateDefault()
 
 void Config::Load()
 {
-    FileUtils::LogLine("[cfg] Reading %s", this->path.c_str());
+    TRACE_SCOPE("Config::Load");
+    FileUtils::LogLine("[cfg] Reading %s", this->path);
 
     this->Close();
     this->mtime = this->CheckModificationTime();
+    this->adoptMtime = false;
     if(!this->mtime)
     {
-        FileUtils::LogLine("[cfg] Error finding file");
+        FileUtils::LogEvent(SysClkLogEvent_CfgFileNotFound);
     }
-    else if (!ini_browse(&BrowseIniFunc, this, this->path.c_str()))
+    else if (!ini_browse(&BrowseIniFunc, this, this->path))
     {
-        FileUtils::LogLine("[cfg] Error loading file");
+        FileUtils::LogEvent(SysClkLogEvent_CfgFileLoadError);
     }
 
     this->loaded = true;
@@ -69,24 +85,61 @@ void Config::Load()
 void Config::Close()
 {
     this->loaded = false;
-    this->profileMHzMap.clear();
-    this->profileCountMap.clear();
+    this->titleCount = 0;
 
     for(unsigned int i = 0; i < SysClkConfigValue_EnumMax; i++)
     {
         this->configValues[i] = sysclkDefaultConfigValue((SysClkConfigValue)i);
     }
+
+    memset(this->filterSpecs, 0, sizeof(this->filterSpecs));
+    this->gpuCapCount = 0;
 }
 
 bool Config::Refresh()
 {
     std::scoped_lock lock{this->configMutex};
-    if (!this->loaded || this->mtime != this->CheckModificationTime())
+    std::uint64_t ns = armTicksToNs(armGetSystemTick());
+    std::uint64_t checkIntervalNs = this->configValues[SysClkConfigValue_ConfigCheckIntervalMs] * 1000000ULL;
+    bool reload = !this->loaded || this->reloadRequested.exchange(false);
+
+    // the sd card is shared with the running title, external edits are only looked for now and then
+    if (!reload && checkIntervalNs && ns - this->lastCheckNs >= checkIntervalNs)
+    {
+        this->lastCheckNs = ns;
+        time_t mtime = this->CheckModificationTime();
+        Metrics::Increment(SysClkMetricCounter_ConfigChecks);
+
+        // our own write is taken as the new baseline, an edit made before this check goes unnoticed
+        if (this->adoptMtime)
+        {
+            this->mtime = mtime;
+            this->adoptMtime = false;
+        }
+        else
+        {
+            reload = this->mtime != mtime;
+        }
+    }
+
+    if (reload)
     {
         this->Load();
+        this->lastCheckNs = ns;
+        this->written = false;
+        Metrics::Increment(SysClkMetricCounter_ConfigReloads);
         return true;
     }
-    return false;
+
+    // our own writes are already applied in memory
+    bool written = this->written;
+    this->written = false;
+    return written;
+}
+
+void Config::RequestReload()
+{
+    this->reloadRequested = true;
 }
 
 bool Config::HasProfilesLoaded()
@@ -99,7 +152,7 @@ time_t Config::CheckModificationTime()
 {
     time_t mtime = 0;
     struct stat st;
-    if (stat(this->path.c_str(), &st) == 0)
+    if (stat(this->path, &st) == 0)
     {
         mtime = st.st_mtime;
     }
@@ -107,14 +160,55 @@ time_t Config::CheckModificationTime()
     return mtime;
 }
 
+void Config::MarkWritten()
+{
+    // no stat here, the next tick check adopts the new mtime instead of reading our own write back
+    this->adoptMtime = true;
+    this->written = true;
+}
+
+ConfigTitleProfiles* Config::FindTitle(std::uint64_t tid, bool create)
+{
+    for(std::uint32_t i = 0; i < this->titleCount; i++)
+    {
+        if(this->titles[i].tid == tid)
+        {
+            return &this->titles[i];
+        }
+    }
+
+    if(!create)
+    {
+        return NULL;
+    }
+
+    if(this->titleCount >= CONFIG_TITLES_MAX)
+    {
+        FileUtils::LogLine("[cfg] Skipping %016lX: too many titles (max %u)", tid, CONFIG_TITLES_MAX);
+        return NULL;
+    }
+
+    ConfigTitleProfiles* title = &this->titles[this->titleCount++];
+    memset(title, 0, sizeof(ConfigTitleProfiles));
+    title->tid = tid;
+
+    return title;
+}
+
+void Config::RemoveTitle(ConfigTitleProfiles* title)
+{
+    // order does not matter, the last entry takes the freed slot
+    *title = this->titles[--this->titleCount];
+}
+
 std::uint32_t Config::FindClockMHz(std::uint64_t tid, SysClkModule module, SysClkProfile profile)
 {
     if (this->loaded)
     {
-        std::map<std::tuple<std::uint64_t, SysClkProfile, SysClkModule>, std::uint32_t>::const_iterator it = this->profileMHzMap.find(std::make_tuple(tid, profile, module));
-        if (it != this->profileMHzMap.end())
+        ConfigTitleProfiles* title = this->FindTitle(tid, false);
+        if (title)
         {
-            return it->second;
+            return title->mhz[profile][module];
         }
     }
 
@@ -156,7 +250,7 @@ std::uint32_t Config::GetAutoClockHz(std::uint64_t tid, SysClkModule module, Sys
         case SysClkProfile_Docked:
             return FindClockHzFromProfiles(tid, module, {SysClkProfile_Docked});
         default:
-            ERROR_THROW("Unhandled SysClkProfile: %u", profile);
+            ERROR_FATAL("Unhandled SysClkProfile: %u", profile);
     }
 
     return 0;
@@ -228,7 +322,15 @@ bool Config::SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles, bo
     *ik = NULL;
     *iv = NULL;
 
-    if(!ini_putsection(section, (const char**)iniKeys, (const char**)iniValues, this->path.c_str()))
+    // a new title must fit the table, the file and memory would disagree otherwise
+    if(immediate && numProfiles && !this->FindTitle(tid, false) && this->titleCount >= CONFIG_TITLES_MAX)
+    {
+        FileUtils::LogLine("[cfg] Cannot save %016lX: too many titles (max %u)", tid, CONFIG_TITLES_MAX);
+        return false;
+    }
+
+    Metrics::Increment(SysClkMetricCounter_SdWrites);
+    if(!ini_putsection(section, (const char**)iniKeys, (const char**)iniValues, this->path))
     {
         return false;
     }
@@ -236,22 +338,16 @@ bool Config::SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles, bo
     // Only actually apply changes in memory after a succesful save
     if(immediate)
     {
-        mhz = &profiles->mhz[0];
-        this->profileCountMap[tid] = numProfiles;
-        for(unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
+        this->MarkWritten();
+        ConfigTitleProfiles* title = this->FindTitle(tid, numProfiles != 0);
+        if(title && numProfiles)
         {
-            for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
-            {
-                if(*mhz)
-                {
-                    this->profileMHzMap[std::make_tuple(tid, (SysClkProfile)profile, (SysClkModule)module)] = *mhz;
-                }
-                else
-                {
-                    this->profileMHzMap.erase(std::make_tuple(tid, (SysClkProfile)profile, (SysClkModule)module));
-                }
-                mhz++;
-            }
+            memcpy(title->mhz, profiles->mhz, sizeof(title->mhz));
+            title->count = numProfiles;
+        }
+        else if(title)
+        {
+            this->RemoveTitle(title);
         }
     }
 
@@ -260,13 +356,74 @@ bool Config::SetProfiles(std::uint64_t tid, SysClkTitleProfileList* profiles, bo
 
 std::uint8_t Config::GetProfileCount(std::uint64_t tid)
 {
-    std::map<std::uint64_t, std::uint8_t>::iterator it = this->profileCountMap.find(tid);
-    if (it == this->profileCountMap.end())
+    ConfigTitleProfiles* title = this->FindTitle(tid, false);
+    if (!title)
     {
         return 0;
     }
 
-    return it->second;
+    return title->count;
+}
+
+// key is <soc>_<profile>_<watts>w, value in MHz
+bool Config::ParseGpuCap(const char* key, const char* value)
+{
+    ConfigGpuCap cap;
+    const char* sep = strchr(key, '_');
+    const char* last = strrchr(key, '_');
+    if(!sep || sep == last)
+    {
+        return false;
+    }
+
+    cap.soc = SysClkSocType_EnumMax;
+    for(unsigned int soc = 0; soc < SysClkSocType_EnumMax; soc++)
+    {
+        const char* socCode = sysclkFormatSocType((SysClkSocType)soc, false);
+        if((std::size_t)(sep - key) == strlen(socCode) && !strncmp(key, socCode, sep - key))
+        {
+            cap.soc = (SysClkSocType)soc;
+        }
+    }
+
+    cap.profile = SysClkProfile_EnumMax;
+    for(unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
+    {
+        const char* profileCode = Board::GetProfileName((SysClkProfile)profile, false);
+        if((std::size_t)(last - sep - 1) == strlen(profileCode) && !strncmp(sep + 1, profileCode, last - sep - 1))
+        {
+            cap.profile = (SysClkProfile)profile;
+        }
+    }
+
+    char* end = NULL;
+    cap.watts = strtoul(last + 1, &end, 10);
+    if(cap.soc == SysClkSocType_EnumMax || cap.profile == SysClkProfile_EnumMax || end == last + 1 || strcmp(end, "w"))
+    {
+        return false;
+    }
+
+    cap.hz = strtoul(value, &end, 10) * 1000000;
+    if(end == value || *end)
+    {
+        return false;
+    }
+
+    // a later key for the same row wins
+    std::uint32_t i = 0;
+    while(i < this->gpuCapCount && (this->gpuCaps[i].soc != cap.soc || this->gpuCaps[i].profile != cap.profile || this->gpuCaps[i].watts != cap.watts))
+    {
+        i++;
+    }
+
+    if(i >= CONFIG_GPU_CAPS_MAX)
+    {
+        return false;
+    }
+
+    this->gpuCaps[i] = cap;
+    this->gpuCapCount = std::max(this->gpuCapCount, i + 1);
+    return true;
 }
 
 int Config::BrowseIniFunc(const char* section, const char* key, const char* value, void* userdata)
@@ -294,6 +451,35 @@ int Config::BrowseIniFunc(const char* section, const char* key, const char* valu
         return 1;
     }
 
+    if(!strcmp(section, CONFIG_FILTER_SECTION))
+    {
+        for(unsigned int signal = 0; signal < SysClkSignal_EnumMax; signal++)
+        {
+            if(!strcmp(key, sysclkFormatSignal((SysClkSignal)signal, false)))
+            {
+                if(strlen(value) >= CONFIG_FILTER_SPEC_MAX || !SignalFilter::Validate(value))
+                {
+                    FileUtils::LogLine("[cfg] Invalid filter for key '%s' in section '%s': not filtered", key, section);
+                    return 1;
+                }
+                snprintf(config->filterSpecs[signal], CONFIG_FILTER_SPEC_MAX, "%s", value);
+                return 1;
+            }
+        }
+
+        FileUtils::LogLine("[cfg] Skipping key '%s' in section '%s': Unrecognized signal", key, section);
+        return 1;
+    }
+
+    if(!strcmp(section, CONFIG_GPU_CAP_SECTION))
+    {
+        if(!config->ParseGpuCap(key, value))
+        {
+            FileUtils::LogLine("[cfg] Skipping key '%s' in section '%s': Invalid GPU cap", key, section);
+        }
+        return 1;
+    }
+
     std::uint64_t tid = strtoul(section, NULL, 16);
 
     if(!tid || strlen(section) != 16)
@@ -340,17 +526,15 @@ int Config::BrowseIniFunc(const char* section, const char* key, const char* valu
         return 1;
     }
 
-    config->profileMHzMap[std::make_tuple(tid, parsedProfile, parsedModule)] = mhz;
-    std::map<std::uint64_t, std::uint8_t>::iterator it = config->profileCountMap.find(tid);
-    if (it == config->profileCountMap.end())
+    ConfigTitleProfiles* title = config->FindTitle(tid, true);
+    if(!title)
     {
-        config->profileCountMap[tid] = 1;
-    }
-    else
-    {
-        it->second++;
+        return 1;
     }
 
+    title->mhz[parsedProfile][parsedModule] = mhz;
+    title->count++;
+
     return 1;
 }
 
@@ -448,7 +632,8 @@ bool Config::SetConfigValues(SysClkConfigValueList* configValues, bool immediate
     *ik = NULL;
     *iv = NULL;
 
-    if(!ini_putsection(CONFIG_VAL_SECTION, (const char**)iniKeys, (const char**)iniValues, this->path.c_str()))
+    Metrics::Increment(SysClkMetricCounter_SdWrites);
+    if(!ini_putsection(CONFIG_VAL_SECTION, (const char**)iniKeys, (const char**)iniValues, this->path))
     {
         return false;
     }
@@ -456,6 +641,7 @@ bool Config::SetConfigValues(SysClkConfigValueList* configValues, bool immediate
     // Only actually apply changes in memory after a succesful save
     if(immediate)
     {
+        this->MarkWritten();
         for(unsigned int kval = 0; kval < SysClkConfigValue_EnumMax; kval++)
         {
             if(sysclkValidConfigValue((SysClkConfigValue)kval, configValues->values[kval]))
@@ -471,3 +657,29 @@ bool Config::SetConfigValues(SysClkConfigValueList* configValues, bool immediate
 
     return true;
 }
+
+void Config::GetFilterSpec(SysClkSignal signal, char* out_spec, std::size_t size)
+{
+    ASSERT_ENUM_VALID(SysClkSignal, signal);
+
+    std::scoped_lock lock{this->configMutex};
+    snprintf(out_spec, size, "%s", this->filterSpecs[signal]);
+}
+
+bool Config::FindGpuCap(SysClkSocType soc, SysClkProfile profile, std::uint32_t chargerMw, ConfigGpuCap* out_cap)
+{
+    std::scoped_lock lock{this->configMutex};
+    bool found = false;
+
+    for(std::uint32_t i = 0; i < this->gpuCapCount; i++)
+    {
+        ConfigGpuCap* cap = &this->gpuCaps[i];
+        if(cap->soc == soc && cap->profile == profile && (std::uint64_t)cap->watts * 1000 <= chargerMw && (!found || cap->watts > out_cap->watts))
+        {
+            *out_cap = *cap;
+            found = true;
+        }
+    }
+
+    return found;
+}
@@ -11,26 +11,48 @@
 #pragma once
 #include <atomic>
 #include <ctime>
-#include <map>
 #include <mutex>
 #include <initializer_list>
-#include <string>
 #include <switch.h>
 #include <minIni.h>
 #include <nxExt.h>
 #include "board.h"
+#include "file_utils.h"
 
 #define CONFIG_VAL_SECTION "values"
+#define CONFIG_FILTER_SECTION "filters"
+#define CONFIG_FILTER_SPEC_MAX 64
+#define CONFIG_GPU_CAP_SECTION "gpu_caps"
+#define CONFIG_GPU_CAPS_MAX 32
+#define CONFIG_TITLES_MAX 128
+
+typedef struct
+{
+    std::uint64_t tid;
+    std::uint32_t mhz[SysClkProfile_EnumMax][SysClkModule_EnumMax];
+    std::uint8_t count;
+} ConfigTitleProfiles;
+
+// GPU cap for a charger of at least watts (0 also matches an unknown charger), hz 0 lifts the cap
+typedef struct
+{
+    SysClkSocType soc;
+    SysClkProfile profile;
+    std::uint32_t watts;
+    std::uint32_t hz;
+} ConfigGpuCap;
 
 class Config
 {
   public:
-    Config(std::string path);
+    Config(const char* path);
     virtual ~Config();
 
     static Config* CreateDefault();
 
+    // reloads on request or when an external edit is noticed, true if the config changed
     bool Refresh();
+    void RequestReload();
 
     bool HasProfilesLoaded();
 
@@ -48,23 +70,38 @@ class Config
     const char* GetConfigValueName(SysClkConfigValue val, bool pretty);
     void GetConfigValues(SysClkConfigValueList* out_configValues);
     bool SetConfigValues(SysClkConfigValueList* configValues, bool immediate);
+    // stage list of the signal from the [filters] section, "" if none
+    void GetFilterSpec(SysClkSignal signal, char* out_spec, std::size_t size);
+    // [gpu_caps] row with the most watts chargerMw can supply, false if none
+    bool FindGpuCap(SysClkSocType soc, SysClkProfile profile, std::uint32_t chargerMw, ConfigGpuCap* out_cap);
   protected:
     void Load();
     void Close();
 
     time_t CheckModificationTime();
+    void MarkWritten();
     std::uint32_t FindClockMHz(std::uint64_t tid, SysClkModule module, SysClkProfile profile);
     std::uint32_t FindClockHzFromProfiles(std::uint64_t tid, SysClkModule module, std::initializer_list<SysClkProfile> profiles);
+    ConfigTitleProfiles* FindTitle(std::uint64_t tid, bool create);
+    void RemoveTitle(ConfigTitleProfiles* title);
+    bool ParseGpuCap(const char* key, const char* value);
     static int BrowseIniFunc(const char* section, const char* key, const char* value, void* userdata);
 
-    std::map<std::tuple<std::uint64_t, SysClkProfile, SysClkModule>, std::uint32_t> profileMHzMap;
-    std::map<std::uint64_t, std::uint8_t> profileCountMap;
+    ConfigTitleProfiles* titles;
+    std::uint32_t titleCount;
     bool loaded;
-    std::string path;
+    char path[FILE_PATH_MAX];
     time_t mtime;
+    std::uint64_t lastCheckNs;
+    bool written;
+    bool adoptMtime;
+    std::atomic_bool reloadRequested;
     LockableMutex configMutex;
     LockableMutex overrideMutex;
     std::atomic_bool enabled;
     std::uint32_t overrideFreqs[SysClkModule_EnumMax];
     std::uint64_t configValues[SysClkConfigValue_EnumMax];
+    char filterSpecs[SysClkSignal_EnumMax][CONFIG_FILTER_SPEC_MAX];
+    ConfigGpuCap gpuCaps[CONFIG_GPU_CAPS_MAX];
+    std::uint32_t gpuCapCount;
 };
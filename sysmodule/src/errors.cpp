@@ -9,29 +9,104 @@
  */
 
 #include "errors.h"
-#include <cstdarg>
-#include <cstring>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <nxExt.h>
+#include "file_utils.h"
+#include "metrics.h"
 
-void Errors::ThrowException(const char* format, ...)
+static LockableMutex g_service_mutex;
+static char g_fatal_message[ERRORS_MESSAGE_MAX];
+
+static struct
+{
+    std::uint32_t failures;
+    std::uint64_t retryTick;
+    Result lastRc;
+} g_services[ErrorService_EnumMax];
+
+void Errors::Fatal(const char* format, ...)
 {
     va_list args;
     va_start(args, format);
-    const char* msg = Errors::FormatMessage(format, args);
+    vsnprintf(g_fatal_message, sizeof(g_fatal_message), format, args);
     va_end(args);
 
-    throw std::runtime_error(msg);
+    FileUtils::LogLine("[!] %s", g_fatal_message);
+    FlightRecorder::Dump(FILE_FLIGHT_RECORDER_PATH, g_fatal_message);
+    FileUtils::LogEvent(SysClkLogEvent_Exit);
+    svcSleepThread(1000000ULL);
+    FileUtils::Exit();
+
+    exit(1);
+}
+
+const char* Errors::GetServiceName(ErrorService service)
+{
+    switch(service)
+    {
+        case ErrorService_Clkrst:
+            return "clkrst";
+        case ErrorService_Pcv:
+            return "pcv";
+        case ErrorService_Apm:
+            return "apm";
+        case ErrorService_Psm:
+            return "psm";
+        case ErrorService_Tc:
+            return "tc";
+        case ErrorService_Pm:
+            return "pm";
+        case ErrorService_Max17050:
+            return "max17050";
+        case ErrorService_Tmp451:
+            return "tmp451";
+        case ErrorService_Fan:
+            return "fan";
+        default:
+            return "?";
+    }
+}
+
+Result Errors::ServiceReady(ErrorService service)
+{
+    std::scoped_lock lock{g_service_mutex};
+
+    if (g_services[service].failures && armGetSystemTick() < g_services[service].retryTick)
+    {
+        return g_services[service].lastRc;
+    }
+
+    return 0;
 }
 
-const char* Errors::FormatMessage(const char* format, va_list args)
+Result Errors::ServiceResult(ErrorService service, Result rc, const char* call)
 {
-    size_t len = vsnprintf(NULL, 0, format, args) * sizeof(char);
-    char* buf = (char*)malloc(len + 1);
-    if (buf == NULL)
+    std::scoped_lock lock{g_service_mutex};
+
+    if (R_SUCCEEDED(rc))
     {
-        return format;
+        if (g_services[service].failures)
+        {
+            FileUtils::LogLine("[svc] %s recovered after %u failures", Errors::GetServiceName(service), g_services[service].failures);
+            g_services[service].failures = 0;
+        }
+
+        return rc;
     }
 
-    vsnprintf(buf, len + 1, format, args);
+    // doubles on every consecutive failure, only one call gets through per window
+    std::uint32_t shift = std::min(g_services[service].failures, (std::uint32_t)16);
+    std::uint64_t backoffNs = std::min(ERRORS_BACKOFF_MIN_NS << shift, ERRORS_BACKOFF_MAX_NS);
+
+    g_services[service].failures++;
+    g_services[service].lastRc = rc;
+    g_services[service].retryTick = armGetSystemTick() + armNsToTicks(backoffNs);
+
+    Metrics::Increment(SysClkMetricCounter_ServiceErrors);
+    FlightRecorder::NoteResult(rc);
+    FileUtils::LogLine("[svc] %s: [0x%x] %04d-%04d, retrying in %lu ms", call, rc, R_MODULE(rc), R_DESCRIPTION(rc), backoffNs / 1000000ULL);
 
-    return buf;
+    return rc;
 }
@@ -10,26 +10,64 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstdarg>
 #include <switch.h>
-#include <stdexcept>
+#include "flight_recorder.h"
 
-#define ERROR_THROW(format, ...) Errors::ThrowException(format "\n  in %s:%u", ##__VA_ARGS__, __FILE__, __LINE__)
-#define ERROR_RESULT_THROW(rc, format, ...) ERROR_THROW(format "\n  RC: [0x%x] %04d-%04d", ##__VA_ARGS__, rc, R_MODULE(rc), R_DESCRIPTION(rc))
+#define ERRORS_MESSAGE_MAX 0x200
+#define ERRORS_BACKOFF_MIN_NS 100000000ULL
+#define ERRORS_BACKOFF_MAX_NS 30000000000ULL
+
+// unrecoverable: logs, dumps the flight recorder and exits the sysmodule
+#define ERROR_FATAL(format, ...) Errors::Fatal(format "\n  in %s:%u", ##__VA_ARGS__, __FILE__, __LINE__)
+#define ERROR_RESULT_FATAL(rc, format, ...) ERROR_FATAL(format "\n  RC: [0x%x] %04d-%04d", ##__VA_ARGS__, rc, R_MODULE(rc), R_DESCRIPTION(rc))
 #define ASSERT_RESULT_OK(rc, format, ...)                                   \
     if (R_FAILED(rc))                                                       \
     {                                                                       \
-        ERROR_RESULT_THROW(rc, "ASSERT_RESULT_OK: " format, ##__VA_ARGS__); \
+        FlightRecorder::NoteResult(rc);                                     \
+        ERROR_RESULT_FATAL(rc, "ASSERT_RESULT_OK: " format, ##__VA_ARGS__); \
     }
 #define ASSERT_ENUM_VALID(n, v)              \
     if(!SYSCLK_ENUM_VALID(n, v)) {           \
-        ERROR_THROW("No such %s: %u", #n, v); \
+        ERROR_FATAL("No such %s: %u", #n, v); \
+    }
+
+// runtime service call: skipped while the service backs off, returns the result on failure
+#define SERVICE_TRY(service, call)                                  \
+    {                                                               \
+        Result _serviceRc = Errors::ServiceReady(service);          \
+        if (R_SUCCEEDED(_serviceRc))                                \
+        {                                                           \
+            _serviceRc = Errors::ServiceResult(service, call, #call); \
+        }                                                           \
+        if (R_FAILED(_serviceRc))                                   \
+        {                                                           \
+            return _serviceRc;                                      \
+        }                                                           \
     }
 
+typedef enum
+{
+    ErrorService_Clkrst = 0,
+    ErrorService_Pcv,
+    ErrorService_Apm,
+    ErrorService_Psm,
+    ErrorService_Tc,
+    ErrorService_Pm,
+    ErrorService_Max17050,
+    ErrorService_Tmp451,
+    ErrorService_Fan,
+    ErrorService_EnumMax
+} ErrorService;
+
 class Errors
 {
   public:
-    static void ThrowException(const char* format, ...);
+    [[noreturn]] static void Fatal(const char* format, ...);
+    static Result ServiceReady(ErrorService service);
+    static Result ServiceResult(ErrorService service, Result rc, const char* call);
 
   protected:
-    static const char* FormatMessage(const char* format, va_list args);
+    static const char* GetServiceName(ErrorService service);
 };
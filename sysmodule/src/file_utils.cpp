@@ -9,13 +9,35 @@
  */
 
 #include "file_utils.h"
+#include "metrics.h"
 #include <nxExt.h>
+#include <cstring>
+#include <cstdio>
+#include <sys/stat.h>
 
 static LockableMutex g_log_mutex;
 static LockableMutex g_csv_mutex;
 static std::atomic_bool g_has_initialized = false;
 static bool g_log_enabled = false;
 static std::uint64_t g_last_flag_check = 0;
+static std::uint8_t g_log_bin_buffer[FILE_LOG_BIN_BUFFER_SIZE];
+static std::size_t g_log_bin_size = 0;
+static std::uint64_t g_log_bin_first_tick = 0;
+static bool g_log_bin_session_written = false;
+static char g_csv_header[FILE_CSV_HEADER_MAX] = {0};
+static std::atomic_uint64_t g_file_sizes[SysClkFile_EnumMax];
+static std::atomic_uint64_t g_file_max_sizes[SysClkFile_EnumMax];
+static std::atomic_bool g_file_rotation_pending[SysClkFile_EnumMax];
+static std::atomic_uint32_t g_file_rotate_count = 0;
+static std::atomic_bool g_rotation_running = false;
+static Thread g_rotation_thread;
+static UEvent g_rotation_event;
+
+static const char* g_file_paths[SysClkFile_EnumMax] = {
+    FILE_LOG_FILE_PATH,
+    FILE_LOG_BIN_PATH,
+    FILE_CONTEXT_CSV_PATH,
+};
 
 extern "C" void __libnx_init_time(void);
 
@@ -52,47 +74,192 @@ void FileUtils::LogLine(const char* format, ...)
                 fprintf(file, "[%04d-%02d-%02d %02d:%02d:%02d.%03ld] ", nowTm->tm_year+1900, nowTm->tm_mon+1, nowTm->tm_mday, nowTm->tm_hour, nowTm->tm_min, nowTm->tm_sec, now.tv_nsec / 1000000UL);
                 vfprintf(file, format, args);
                 fprintf(file, "\n");
+                FileUtils::TrackFileSize(SysClkFile_Log, file);
                 fclose(file);
+                Metrics::Increment(SysClkMetricCounter_SdWrites);
             }
         }
     }
     va_end(args);
 }
 
-void FileUtils::WriteContextToCsv(const SysClkContext* context)
+void FileUtils::LogEventRaw(SysClkLogEvent event, std::uint8_t argc, const std::uint32_t* argv)
 {
-    std::scoped_lock lock{g_csv_mutex};
+    std::scoped_lock lock{g_log_mutex};
 
-    FILE* file = fopen(FILE_CONTEXT_CSV_PATH, "a");
+    if (!g_has_initialized)
+    {
+        return;
+    }
 
-    if (file)
+    FileUtils::RefreshFlags(false);
+
+    if (!g_log_enabled)
     {
-        // Print header
-        if(!ftell(file))
-        {
-            fprintf(file, "timestamp,profile,app_tid");
+        return;
+    }
 
-            for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
-            {
-                fprintf(file, ",%s_hz", sysclkFormatModule((SysClkModule)module, false));
-            }
+    std::size_t argsSize = argc * sizeof(*argv);
+    std::size_t recordSize = sizeof(SysClkLogEventHeader) + argsSize;
 
-            for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
-            {
-                fprintf(file, ",%s_milliC", sysclkFormatThermalSensor((SysClkThermalSensor)sensor, false));
-            }
+    if (g_log_bin_size + recordSize > sizeof(g_log_bin_buffer))
+    {
+        FileUtils::FlushLogEventsLocked();
+    }
 
-            for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
-            {
-                fprintf(file, ",%s_real_hz", sysclkFormatModule((SysClkModule)module, false));
-            }
+    SysClkLogEventHeader header = {
+        .tick = armGetSystemTick(),
+        .event = (std::uint16_t)event,
+        .argc = argc,
+        .reserved = 0,
+    };
+
+    if (!g_log_bin_size)
+    {
+        g_log_bin_first_tick = header.tick;
+    }
 
-            for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+    memcpy(&g_log_bin_buffer[g_log_bin_size], &header, sizeof(header));
+    memcpy(&g_log_bin_buffer[g_log_bin_size + sizeof(header)], argv, argsSize);
+    g_log_bin_size += recordSize;
+}
+
+void FileUtils::FlushLogEvents(bool force)
+{
+    std::scoped_lock lock{g_log_mutex};
+
+    if (!g_log_bin_size)
+    {
+        return;
+    }
+
+    if (force || armTicksToNs(armGetSystemTick() - g_log_bin_first_tick) > FILE_LOG_BIN_FLUSH_INTERVAL_NS)
+    {
+        FileUtils::FlushLogEventsLocked();
+    }
+}
+
+void FileUtils::FlushLogEventsLocked()
+{
+    if (g_has_initialized && g_log_enabled)
+    {
+        FILE* file = fopen(FILE_LOG_BIN_PATH, "ab");
+
+        if (file)
+        {
+            // once per file and once per boot when appending to a previous one
+            if (!ftell(file) || !g_log_bin_session_written)
             {
-                fprintf(file, ",%s_mw", sysclkFormatPowerSensor((SysClkPowerSensor)sensor, false));
+                FileUtils::WriteLogSessionEvent(file);
+                g_log_bin_session_written = true;
             }
 
-            fprintf(file, "\n");
+            fwrite(g_log_bin_buffer, 1, g_log_bin_size, file);
+            FileUtils::TrackFileSize(SysClkFile_LogBin, file);
+            fclose(file);
+            Metrics::Increment(SysClkMetricCounter_SdWrites);
+        }
+    }
+
+    g_log_bin_size = 0;
+}
+
+static std::size_t _FileUtils_FormatCsvHeader(char* out, std::size_t size)
+{
+    std::size_t len = snprintf(out, size, "timestamp,profile,app_tid");
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        len += snprintf(out + len, size - len, ",%s_hz", sysclkFormatModule((SysClkModule)module, false));
+    }
+
+    for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+    {
+        len += snprintf(out + len, size - len, ",%s_milliC", sysclkFormatThermalSensor((SysClkThermalSensor)sensor, false));
+    }
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        len += snprintf(out + len, size - len, ",%s_real_hz", sysclkFormatModule((SysClkModule)module, false));
+    }
+
+    for (unsigned int sensor = 0; sensor < SysClkPowerSensor_EnumMax; sensor++)
+    {
+        len += snprintf(out + len, size - len, ",%s_mw", sysclkFormatPowerSensor((SysClkPowerSensor)sensor, false));
+    }
+
+    for (unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+    {
+        len += snprintf(out + len, size - len, ",cpu_%s_permille", sysclkFormatCpuCore((SysClkCpuCore)core, false));
+    }
+
+    for (unsigned int load = 0; load < SysClkRamLoad_EnumMax; load++)
+    {
+        len += snprintf(out + len, size - len, ",ram_%s_permille", sysclkFormatRamLoad((SysClkRamLoad)load, false));
+    }
+
+    for (unsigned int load = 0; load < SysClkRamLoad_EnumMax; load++)
+    {
+        len += snprintf(out + len, size - len, ",ram_%s_mbps", sysclkFormatRamLoad((SysClkRamLoad)load, false));
+    }
+
+    for (unsigned int value = 0; value < SysClkBatteryValue_EnumMax; value++)
+    {
+        len += snprintf(out + len, size - len, ",battery_%s", sysclkFormatBatteryValue((SysClkBatteryValue)value, false));
+    }
+
+    len += snprintf(out + len, size - len, ",battery_tte_min");
+
+    for (unsigned int signal = 0; signal < SysClkSignal_EnumMax; signal++)
+    {
+        len += snprintf(out + len, size - len, ",%s_filtered", sysclkFormatSignal((SysClkSignal)signal, false));
+    }
+
+    len += snprintf(out + len, size - len, ",fan_permille,charger_mw\n");
+
+    return len;
+}
+
+// a file left by an older build keeps its columns, appending rows to it would misalign them
+void FileUtils::CheckCsvHeader(const char* header)
+{
+    FILE* file = fopen(FILE_CONTEXT_CSV_PATH, "r");
+    if (!file)
+    {
+        return;
+    }
+
+    char line[FILE_CSV_HEADER_MAX];
+    bool matches = fgets(line, sizeof(line), file) && !strcmp(line, header);
+    bool empty = !matches && !ftell(file);
+    fclose(file);
+
+    if (!matches && !empty)
+    {
+        FileUtils::LogLine("[csv] Columns changed, rotating " FILE_CONTEXT_CSV_PATH);
+        FileUtils::RotateFile(SysClkFile_Csv);
+    }
+}
+
+void FileUtils::WriteContextToCsv(const SysClkContextExt* contextExt)
+{
+    const SysClkContext* context = &contextExt->context;
+    std::scoped_lock lock{g_csv_mutex};
+
+    // header and the check against the existing file are only done on the first write
+    if (!g_csv_header[0])
+    {
+        _FileUtils_FormatCsvHeader(g_csv_header, sizeof(g_csv_header));
+        FileUtils::CheckCsvHeader(g_csv_header);
+    }
+
+    FILE* file = fopen(FILE_CONTEXT_CSV_PATH, "a");
+
+    if (file)
+    {
+        if(!ftell(file))
+        {
+            fputs(g_csv_header, file);
         }
 
         struct timespec now;
@@ -120,8 +287,171 @@ void FileUtils::WriteContextToCsv(const SysClkContext* context)
             fprintf(file, ",%d", context->power[sensor]);
         }
 
+        for (unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+        {
+            fprintf(file, ",%u", contextExt->cpuLoad[core]);
+        }
+
+        for (unsigned int load = 0; load < SysClkRamLoad_EnumMax; load++)
+        {
+            fprintf(file, ",%u", context->ramLoad[load]);
+        }
+
+        for (unsigned int load = 0; load < SysClkRamLoad_EnumMax; load++)
+        {
+            fprintf(file, ",%u", contextExt->ramBandwidth[load]);
+        }
+
+        for (unsigned int value = 0; value < SysClkBatteryValue_EnumMax; value++)
+        {
+            fprintf(file, ",%d", contextExt->battery[value]);
+        }
+
+        fprintf(file, ",%u", contextExt->timeToEmptyMin);
+
+        for (unsigned int signal = 0; signal < SysClkSignal_EnumMax; signal++)
+        {
+            fprintf(file, ",%d", contextExt->filtered[signal]);
+        }
+
+        fprintf(file, ",%u,%u", contextExt->fanLevel, contextExt->chargerPowerMw);
+
         fprintf(file, "\n");
+        FileUtils::TrackFileSize(SysClkFile_Csv, file);
         fclose(file);
+        Metrics::Increment(SysClkMetricCounter_SdWrites);
+    }
+}
+
+void FileUtils::WriteLogSessionEvent(FILE* file)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    struct
+    {
+        SysClkLogEventHeader header;
+        std::uint32_t args[3];
+    } __attribute__((packed)) record = {
+        .header = {
+            .tick = armGetSystemTick(),
+            .event = SysClkLogEvent_Session,
+            .argc = 3,
+            .reserved = 0,
+        },
+        .args = {
+            (std::uint32_t)now.tv_sec,
+            (std::uint32_t)(now.tv_nsec / 1000000UL),
+            (std::uint32_t)armGetSystemTickFreq(),
+        },
+    };
+
+    fwrite(&record, 1, sizeof(record), file);
+}
+
+void FileUtils::SetRotationLimits(std::uint64_t logMaxKb, std::uint64_t csvMaxKb, std::uint32_t rotateCount)
+{
+    g_file_max_sizes[SysClkFile_Log] = logMaxKb * 1024;
+    g_file_max_sizes[SysClkFile_LogBin] = logMaxKb * 1024;
+    g_file_max_sizes[SysClkFile_Csv] = csvMaxKb * 1024;
+    g_file_rotate_count = rotateCount;
+}
+
+void FileUtils::GetFileSizes(SysClkFileSizes* out_sizes)
+{
+    for (unsigned int file = 0; file < SysClkFile_EnumMax; file++)
+    {
+        out_sizes->sizes[file] = g_file_sizes[file];
+    }
+}
+
+void FileUtils::TrackFileSize(SysClkFile file, FILE* handle)
+{
+    long size = ftell(handle);
+    if (size < 0)
+    {
+        return;
+    }
+
+    g_file_sizes[file] = size;
+
+    std::uint64_t maxSize = g_file_max_sizes[file];
+    if (!maxSize || (std::uint64_t)size < maxSize || g_file_rotation_pending[file].exchange(true))
+    {
+        return;
+    }
+
+    // renaming is left to the rotation thread so that writers never wait on it,
+    // it only happens inline if that thread could not be started
+    if (g_rotation_running)
+    {
+        ueventSignal(&g_rotation_event);
+    }
+    else
+    {
+        FileUtils::RotateFile(file);
+        g_file_rotation_pending[file] = false;
+    }
+}
+
+void FileUtils::GetRotatedPath(SysClkFile file, std::uint32_t generation, char* out, std::size_t size)
+{
+    const char* path = g_file_paths[file];
+    const char* ext = strrchr(path, '.');
+
+    snprintf(out, size, "%.*s.%u%s", (int)(ext - path), path, generation, ext);
+}
+
+void FileUtils::RotateFile(SysClkFile file)
+{
+    char from[FILE_PATH_MAX];
+    char to[FILE_PATH_MAX];
+    std::uint32_t count = g_file_rotate_count;
+
+    if (!count)
+    {
+        remove(g_file_paths[file]);
+        g_file_sizes[file] = 0;
+        return;
+    }
+
+    FileUtils::GetRotatedPath(file, count, to, sizeof(to));
+    remove(to);
+
+    for (std::uint32_t generation = count - 1; generation > 0; generation--)
+    {
+        FileUtils::GetRotatedPath(file, generation, from, sizeof(from));
+        rename(from, to);
+        strcpy(to, from);
+    }
+
+    // a writer may hold the file open for a short while, try again later if so
+    for (unsigned int i = 0; i < FILE_ROTATE_RETRY_COUNT; i++)
+    {
+        if (!rename(g_file_paths[file], to))
+        {
+            g_file_sizes[file] = 0;
+            return;
+        }
+
+        svcSleepThread(FILE_ROTATE_RETRY_DELAY_NS);
+    }
+}
+
+void FileUtils::RotationThreadFunc(void* arg)
+{
+    while (g_rotation_running)
+    {
+        waitSingle(waiterForUEvent(&g_rotation_event), UINT64_MAX);
+
+        for (unsigned int file = 0; file < SysClkFile_EnumMax; file++)
+        {
+            if (g_rotation_running && g_file_rotation_pending[file])
+            {
+                FileUtils::RotateFile((SysClkFile)file);
+                g_file_rotation_pending[file] = false;
+            }
+        }
     }
 }
 
@@ -176,6 +506,23 @@ Result FileUtils::Initialize()
 
     if (R_SUCCEEDED(rc))
     {
+        struct stat st;
+        for (unsigned int file = 0; file < SysClkFile_EnumMax; file++)
+        {
+            g_file_sizes[file] = stat(g_file_paths[file], &st) ? 0 : st.st_size;
+        }
+
+        ueventCreate(&g_rotation_event, true);
+        if (!g_rotation_running && R_SUCCEEDED(threadCreate(&g_rotation_thread, &FileUtils::RotationThreadFunc, NULL, NULL, 0x2000, 0x3F, -2)))
+        {
+            g_rotation_running = true;
+            if (R_FAILED(threadStart(&g_rotation_thread)))
+            {
+                g_rotation_running = false;
+                threadClose(&g_rotation_thread);
+            }
+        }
+
         FileUtils::RefreshFlags(true);
         g_has_initialized = true;
         FileUtils::LogLine("=== " TARGET " " TARGET_VERSION " ===");
@@ -191,6 +538,16 @@ void FileUtils::Exit()
         return;
     }
 
+    FileUtils::FlushLogEvents(true);
+
+    if (g_rotation_running)
+    {
+        g_rotation_running = false;
+        ueventSignal(&g_rotation_event);
+        threadWaitForExit(&g_rotation_thread);
+        threadClose(&g_rotation_thread);
+    }
+
     g_has_initialized = false;
     g_log_enabled = false;
 
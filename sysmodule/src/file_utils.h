@@ -16,12 +16,29 @@
 #include <atomic>
 #include <cstdarg>
 #include <sysclk.h>
+#include "log_events.h"
 
+// the host simulator runs against a relative work dir
+#ifndef FILE_CONFIG_DIR
 #define FILE_CONFIG_DIR "/config/" TARGET
+#endif
 #define FILE_FLAG_CHECK_INTERVAL_NS 5000000000ULL
 #define FILE_CONTEXT_CSV_PATH FILE_CONFIG_DIR "/context.csv"
 #define FILE_LOG_FLAG_PATH FILE_CONFIG_DIR "/log.flag"
 #define FILE_LOG_FILE_PATH FILE_CONFIG_DIR "/log.txt"
+#define FILE_LOG_BIN_PATH FILE_CONFIG_DIR "/log.bin"
+#define FILE_TRACE_PATH FILE_CONFIG_DIR "/trace.json"
+#define FILE_FLIGHT_RECORDER_PATH FILE_CONFIG_DIR "/flight.txt"
+#define FILE_FREQ_CACHE_PATH FILE_CONFIG_DIR "/freqs.bin"
+#define FILE_INPUT_RECORD_FLAG_PATH FILE_CONFIG_DIR "/record.flag"
+#define FILE_INPUT_RECORD_PATH FILE_CONFIG_DIR "/record.bin"
+#define FILE_INPUT_RECORD_OLD_PATH FILE_CONFIG_DIR "/record.old.bin"
+#define FILE_LOG_BIN_BUFFER_SIZE 0x1000
+#define FILE_LOG_BIN_FLUSH_INTERVAL_NS 5000000000ULL
+#define FILE_PATH_MAX 0x80
+#define FILE_CSV_HEADER_MAX 0x400
+#define FILE_ROTATE_RETRY_COUNT 5
+#define FILE_ROTATE_RETRY_DELAY_NS 20000000ULL
 
 class FileUtils
 {
@@ -32,7 +49,46 @@ class FileUtils
     static bool IsLogEnabled();
     static void InitializeAsync();
     static void LogLine(const char* format, ...);
-    static void WriteContextToCsv(const SysClkContext* context);
+    static void LogEventRaw(SysClkLogEvent event, std::uint8_t argc, const std::uint32_t* argv);
+    static void FlushLogEvents(bool force);
+    static void WriteContextToCsv(const SysClkContextExt* contextExt);
+    static void SetRotationLimits(std::uint64_t logMaxKb, std::uint64_t csvMaxKb, std::uint32_t rotateCount);
+    static void GetFileSizes(SysClkFileSizes* out_sizes);
+
+    template<typename... Args>
+    static void LogEvent(SysClkLogEvent event, Args... args)
+    {
+        constexpr std::size_t argc = ((sizeof(Args) > sizeof(std::uint32_t) ? 2 : 1) + ... + 0);
+        static_assert(argc <= SYSCLK_LOG_BIN_MAX_ARGS, "too many log event arguments");
+
+        std::uint32_t argv[argc ? argc : 1];
+        std::uint32_t* arg = &argv[0];
+        (PackLogEventArg(&arg, args), ...);
+
+        LogEventRaw(event, argc, argv);
+    }
+
   protected:
     static void RefreshFlags(bool force);
+    static void FlushLogEventsLocked();
+    static void WriteLogSessionEvent(FILE* file);
+    static void TrackFileSize(SysClkFile file, FILE* handle);
+    static void RotateFile(SysClkFile file);
+    static void CheckCsvHeader(const char* header);
+    static void GetRotatedPath(SysClkFile file, std::uint32_t generation, char* out, std::size_t size);
+    static void RotationThreadFunc(void* arg);
+
+    template<typename T>
+    static void PackLogEventArg(std::uint32_t** arg, T value)
+    {
+        if constexpr (sizeof(T) > sizeof(std::uint32_t))
+        {
+            *(*arg)++ = (std::uint64_t)value & 0xFFFFFFFF;
+            *(*arg)++ = (std::uint64_t)value >> 32;
+        }
+        else
+        {
+            *(*arg)++ = (std::uint32_t)value;
+        }
+    }
 };
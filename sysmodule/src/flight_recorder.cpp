@@ -0,0 +1,135 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "flight_recorder.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <nxExt.h>
+#include "metrics.h"
+
+static LockableMutex g_flight_recorder_mutex;
+
+FlightRecord FlightRecorder::buffer[FLIGHT_RECORDER_TICKS];
+std::uint32_t FlightRecorder::next = 0;
+std::uint32_t FlightRecorder::count = 0;
+bool FlightRecorder::inProgress = false;
+
+FlightRecord* FlightRecorder::Begin(std::uint64_t startTick)
+{
+    std::scoped_lock lock{g_flight_recorder_mutex};
+
+    FlightRecord* record = &FlightRecorder::buffer[FlightRecorder::next];
+    memset(record, 0, sizeof(FlightRecord));
+    record->startTick = startTick;
+    FlightRecorder::inProgress = true;
+
+    return record;
+}
+
+void FlightRecorder::End()
+{
+    std::scoped_lock lock{g_flight_recorder_mutex};
+
+    if (!FlightRecorder::inProgress)
+    {
+        return;
+    }
+
+    FlightRecorder::inProgress = false;
+    FlightRecorder::next = (FlightRecorder::next + 1) % FLIGHT_RECORDER_TICKS;
+    // one slot stays free for the tick being recorded
+    FlightRecorder::count = std::min(FlightRecorder::count + 1, (std::uint32_t)FLIGHT_RECORDER_TICKS - 1);
+}
+
+void FlightRecorder::NoteResult(Result rc)
+{
+    std::scoped_lock lock{g_flight_recorder_mutex};
+
+    if (FlightRecorder::inProgress)
+    {
+        FlightRecorder::buffer[FlightRecorder::next].result = rc;
+    }
+}
+
+static void WriteRecord(FILE* file, const FlightRecord* record, bool complete)
+{
+    std::uint64_t startMs = armTicksToNs(record->startTick) / 1000000ULL;
+
+    fprintf(file, "%lu.%03lu %016lX %s%s%s%s",
+        startMs / 1000, startMs % 1000,
+        record->applicationId,
+        sysclkFormatProfile((SysClkProfile)record->profile, false),
+        (record->flags & FLIGHT_RECORD_FLAG_ENABLED) ? "" : " disabled",
+        (record->flags & FLIGHT_RECORD_FLAG_CONTEXT_CHANGED) ? " ctx" : "",
+        (record->flags & FLIGHT_RECORD_FLAG_CONFIG_CHANGED) ? " cfg" : ""
+    );
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        fprintf(file, " %s=%u/%u/%u",
+            sysclkFormatModule((SysClkModule)module, false),
+            record->targetHz[module] / 100000,
+            record->appliedHz[module] / 100000,
+            record->realHz[module] / 100000
+        );
+    }
+
+    for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+    {
+        fprintf(file, " %s=%u", sysclkFormatThermalSensor((SysClkThermalSensor)sensor, false), record->temps[sensor]);
+    }
+
+    if (complete)
+    {
+        fprintf(file, " refresh=%uus tick=%uus", record->refreshUs, record->durationUs);
+    }
+    else
+    {
+        fprintf(file, " (in progress)");
+    }
+
+    if (R_FAILED(record->result))
+    {
+        fprintf(file, " rc=0x%x %04d-%04d", record->result, R_MODULE(record->result), R_DESCRIPTION(record->result));
+    }
+
+    fprintf(file, "\n");
+}
+
+Result FlightRecorder::Dump(const char* path, const char* reason)
+{
+    std::scoped_lock lock{g_flight_recorder_mutex};
+
+    FILE* file = fopen(path, "w");
+    if (!file)
+    {
+        return SYSCLK_ERROR(FileWriteFailed);
+    }
+
+    fprintf(file, "# sys-clk flight recorder, unix %lu, reason: %s\n", (std::uint64_t)time(NULL), reason);
+    fprintf(file, "# uptime.ms tid profile [flags] module=target/applied/real (100 kHz) sensor=millideg timings [rc]\n");
+
+    std::uint32_t first = (FlightRecorder::next + FLIGHT_RECORDER_TICKS - FlightRecorder::count) % FLIGHT_RECORDER_TICKS;
+    for (std::uint32_t i = 0; i < FlightRecorder::count; i++)
+    {
+        WriteRecord(file, &FlightRecorder::buffer[(first + i) % FLIGHT_RECORDER_TICKS], true);
+    }
+
+    if (FlightRecorder::inProgress)
+    {
+        WriteRecord(file, &FlightRecorder::buffer[FlightRecorder::next], false);
+    }
+
+    fclose(file);
+    Metrics::Increment(SysClkMetricCounter_SdWrites);
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdint>
+#include <switch.h>
+#include <sysclk.h>
+
+#define FLIGHT_RECORDER_TICKS 64
+
+#define FLIGHT_RECORD_FLAG_ENABLED (1 << 0)
+#define FLIGHT_RECORD_FLAG_CONTEXT_CHANGED (1 << 1)
+#define FLIGHT_RECORD_FLAG_CONFIG_CHANGED (1 << 2)
+
+typedef struct
+{
+    std::uint64_t startTick;
+    std::uint64_t applicationId;
+    std::uint32_t durationUs;
+    std::uint32_t refreshUs;
+    Result result;
+    std::uint8_t profile;
+    std::uint8_t flags;
+    std::uint16_t reserved;
+    std::uint32_t targetHz[SysClkModule_EnumMax];
+    std::uint32_t appliedHz[SysClkModule_EnumMax];
+    std::uint32_t realHz[SysClkModule_EnumMax];
+    std::uint32_t temps[SysClkThermalSensor_EnumMax];
+} FlightRecord;
+
+// always-on ring of the latest tick decisions, statically allocated
+class FlightRecorder
+{
+  public:
+    static FlightRecord* Begin(std::uint64_t startTick);
+    static void End();
+    static void NoteResult(Result rc);
+    static Result Dump(const char* path, const char* reason);
+
+  protected:
+    static FlightRecord buffer[FLIGHT_RECORDER_TICKS];
+    static std::uint32_t next;
+    static std::uint32_t count;
+    static bool inProgress;
+};
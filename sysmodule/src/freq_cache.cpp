@@ -0,0 +1,99 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "freq_cache.h"
+#include <cstdio>
+#include <cstring>
+#include "board.h"
+#include "file_utils.h"
+#include "metrics.h"
+
+std::uint32_t FreqCache::Checksum(const File* file)
+{
+    // FNV-1a over the tables, enough to catch a torn or hand edited file
+    std::uint32_t hash = 0x811C9DC5;
+    const std::uint8_t* data = (const std::uint8_t*)&file->count[0];
+    const std::uint8_t* end = (const std::uint8_t*)file + sizeof(File);
+
+    while (data < end)
+    {
+        hash = (hash ^ *data++) * 0x01000193;
+    }
+
+    return hash;
+}
+
+bool FreqCache::Load(const char* path, std::uint32_t lists[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX], std::uint32_t* counts)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    File file;
+    bool valid = fread(&file, sizeof(file), 1, fp) == 1
+        && file.magic == FREQ_CACHE_FILE_MAGIC
+        && file.version == FREQ_CACHE_FILE_VERSION
+        && file.socType == Board::GetSocType()
+        && file.hosVersion == hosversionGet()
+        && file.checksum == FreqCache::Checksum(&file);
+    fclose(fp);
+
+    // every list must be non empty and strictly ascending, as returned by the board
+    for (unsigned int module = 0; valid && module < SysClkModule_EnumMax; module++)
+    {
+        valid = file.count[module] > 0 && file.count[module] <= SYSCLK_FREQ_LIST_MAX && file.list[module][0];
+        for (std::uint32_t i = 1; valid && i < file.count[module]; i++)
+        {
+            valid = file.list[module][i] > file.list[module][i - 1];
+        }
+    }
+
+    if (!valid)
+    {
+        FileUtils::LogLine("[cache] Discarding %s (format, firmware or SoC mismatch)", path);
+        return false;
+    }
+
+    memcpy(counts, file.count, sizeof(file.count));
+    memcpy(lists, file.list, sizeof(file.list));
+    return true;
+}
+
+bool FreqCache::Save(const char* path, std::uint32_t lists[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX], std::uint32_t* counts)
+{
+    File file;
+    memset(&file, 0, sizeof(file));
+    file.magic = FREQ_CACHE_FILE_MAGIC;
+    file.version = FREQ_CACHE_FILE_VERSION;
+    file.socType = Board::GetSocType();
+    file.hosVersion = hosversionGet();
+    memcpy(file.count, counts, sizeof(file.count));
+    memcpy(file.list, lists, sizeof(file.list));
+    file.checksum = FreqCache::Checksum(&file);
+
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    bool ok = fwrite(&file, sizeof(file), 1, fp) == 1;
+    fclose(fp);
+    Metrics::Increment(SysClkMetricCounter_SdWrites);
+
+    if (!ok)
+    {
+        remove(path);
+    }
+
+    return ok;
+}
@@ -0,0 +1,39 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdint>
+#include <switch.h>
+#include <sysclk.h>
+
+#define FREQ_CACHE_FILE_MAGIC 0x51464B43 // "CKFQ"
+#define FREQ_CACHE_FILE_VERSION 1
+
+// raw pcv/clkrst frequency lists, only valid for the firmware and SoC they were read on
+class FreqCache
+{
+  public:
+    static bool Load(const char* path, std::uint32_t lists[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX], std::uint32_t* counts);
+    static bool Save(const char* path, std::uint32_t lists[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX], std::uint32_t* counts);
+
+  protected:
+    typedef struct
+    {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t socType;
+        std::uint32_t hosVersion;
+        std::uint32_t checksum;
+        std::uint32_t count[SysClkModule_EnumMax];
+        std::uint32_t list[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX];
+    } File;
+
+    static std::uint32_t Checksum(const File* file);
+};
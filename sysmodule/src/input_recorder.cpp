@@ -0,0 +1,228 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "input_recorder.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sys/stat.h>
+#include <nxExt.h>
+#include "board.h"
+#include "file_utils.h"
+#include "metrics.h"
+
+std::atomic_bool InputRecorder::active = false;
+
+static LockableMutex g_recorder_mutex;
+static std::uint8_t g_recorder_buffer[INPUT_RECORDER_BUFFER_SIZE];
+static std::size_t g_recorder_buffer_size = 0;
+static std::uint64_t g_recorder_first_buffered_ns = 0;
+static std::uint64_t g_recorder_last_flag_check_ns = 0;
+static std::uint64_t g_recorder_last_tick = 0;
+static std::size_t g_recorder_file_size = 0;
+static bool g_recorder_full = false;
+static bool g_recorder_known[InputRecordType_EnumMax][INPUT_RECORD_CHANNELS];
+static std::uint64_t g_recorder_last[InputRecordType_EnumMax][INPUT_RECORD_CHANNELS];
+
+bool InputRecorder::BeginTick(std::uint64_t tick)
+{
+    std::scoped_lock lock{g_recorder_mutex};
+
+    bool started = false;
+    std::uint64_t ns = armTicksToNs(tick);
+    if (!g_recorder_last_flag_check_ns || ns - g_recorder_last_flag_check_ns >= FILE_FLAG_CHECK_INTERVAL_NS)
+    {
+        g_recorder_last_flag_check_ns = ns;
+
+        struct stat st;
+        if (stat(FILE_INPUT_RECORD_FLAG_PATH, &st))
+        {
+            // removing the flag also rearms a recording that hit the size cap
+            g_recorder_full = false;
+            if (active)
+            {
+                InputRecorder::Stop();
+            }
+        }
+        else if (!active && !g_recorder_full)
+        {
+            InputRecorder::Start();
+            started = true;
+        }
+    }
+
+    if (!active)
+    {
+        return false;
+    }
+
+    std::uint32_t us = g_recorder_last_tick ? armTicksToNs(tick - g_recorder_last_tick) / 1000 : 0;
+    g_recorder_last_tick = tick;
+    InputRecorder::WriteLocked(InputRecordType_Tick, 0, &us, sizeof(us));
+
+    if (g_recorder_buffer_size && ns - g_recorder_first_buffered_ns >= INPUT_RECORDER_FLUSH_INTERVAL_NS)
+    {
+        InputRecorder::FlushLocked();
+    }
+
+    return started;
+}
+
+void InputRecorder::Exit()
+{
+    std::scoped_lock lock{g_recorder_mutex};
+
+    if (active)
+    {
+        InputRecorder::Stop();
+    }
+}
+
+void InputRecorder::WriteValue(InputRecordType type, std::uint8_t index, std::uint64_t value)
+{
+    std::scoped_lock lock{g_recorder_mutex};
+
+    if (!active || index >= INPUT_RECORD_CHANNELS)
+    {
+        return;
+    }
+
+    // decisions are always kept, inputs only when they change
+    if (type != InputRecordType_SetHz && g_recorder_known[type][index] && g_recorder_last[type][index] == value)
+    {
+        return;
+    }
+
+    g_recorder_known[type][index] = true;
+    g_recorder_last[type][index] = value;
+
+    if (type == InputRecordType_ApplicationId)
+    {
+        InputRecorder::WriteLocked(type, index, &value, sizeof(value));
+    }
+    else
+    {
+        std::uint32_t value32 = (std::uint32_t)value;
+        InputRecorder::WriteLocked(type, index, &value32, sizeof(value32));
+    }
+}
+
+void InputRecorder::WriteEvent(InputRecordType type, std::uint8_t index, const void* data, std::uint16_t size)
+{
+    std::scoped_lock lock{g_recorder_mutex};
+
+    if (active)
+    {
+        InputRecorder::WriteLocked(type, index, data, size);
+    }
+}
+
+void InputRecorder::WriteLocked(InputRecordType type, std::uint8_t index, const void* data, std::uint16_t size)
+{
+    InputRecordHeader header = {
+        .type = (std::uint8_t)type,
+        .index = index,
+        .size = size,
+    };
+
+    std::size_t recordSize = sizeof(header) + size;
+    if (recordSize > sizeof(g_recorder_buffer))
+    {
+        return;
+    }
+
+    if (g_recorder_buffer_size + recordSize > sizeof(g_recorder_buffer))
+    {
+        InputRecorder::FlushLocked();
+
+        if (!active)
+        {
+            return;
+        }
+    }
+
+    if (!g_recorder_buffer_size)
+    {
+        g_recorder_first_buffered_ns = armTicksToNs(armGetSystemTick());
+    }
+
+    memcpy(&g_recorder_buffer[g_recorder_buffer_size], &header, sizeof(header));
+    if (size)
+    {
+        memcpy(&g_recorder_buffer[g_recorder_buffer_size + sizeof(header)], data, size);
+    }
+    g_recorder_buffer_size += recordSize;
+}
+
+void InputRecorder::Start()
+{
+    // the previous recording is kept around, it is likely the one with the bug
+    remove(FILE_INPUT_RECORD_OLD_PATH);
+    rename(FILE_INPUT_RECORD_PATH, FILE_INPUT_RECORD_OLD_PATH);
+
+    memset(g_recorder_known, 0, sizeof(g_recorder_known));
+    g_recorder_buffer_size = 0;
+    g_recorder_file_size = 0;
+    g_recorder_last_tick = 0;
+    active = true;
+
+    InputRecordFileHeader header = {
+        .magic = INPUT_RECORD_MAGIC,
+        .version = INPUT_RECORD_VERSION,
+        .socType = (std::uint8_t)Board::GetSocType(),
+        .reserved = 0,
+        .startTime = (std::uint32_t)time(NULL),
+    };
+
+    g_recorder_first_buffered_ns = armTicksToNs(armGetSystemTick());
+    memcpy(g_recorder_buffer, &header, sizeof(header));
+    g_recorder_buffer_size = sizeof(header);
+
+    FileUtils::LogEvent(SysClkLogEvent_RecorderStart);
+}
+
+void InputRecorder::Stop()
+{
+    InputRecorder::FlushLocked();
+
+    if (active)
+    {
+        active = false;
+        FileUtils::LogEvent(SysClkLogEvent_RecorderStop, (std::uint32_t)g_recorder_file_size);
+    }
+}
+
+void InputRecorder::FlushLocked()
+{
+    if (!g_recorder_buffer_size)
+    {
+        return;
+    }
+
+    if (g_recorder_file_size + g_recorder_buffer_size > INPUT_RECORD_MAX_SIZE)
+    {
+        g_recorder_buffer_size = 0;
+        g_recorder_full = true;
+        active = false;
+        FileUtils::LogEvent(SysClkLogEvent_RecorderStop, (std::uint32_t)g_recorder_file_size);
+        return;
+    }
+
+    FILE* file = fopen(FILE_INPUT_RECORD_PATH, "ab");
+    if (file)
+    {
+        fwrite(g_recorder_buffer, 1, g_recorder_buffer_size, file);
+        fclose(file);
+        Metrics::Increment(SysClkMetricCounter_SdWrites);
+        g_recorder_file_size += g_recorder_buffer_size;
+    }
+
+    g_recorder_buffer_size = 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <switch.h>
+#include <sysclk.h>
+
+#define INPUT_RECORD_MAGIC 0x52494B43 // "CKIR"
+#define INPUT_RECORD_VERSION 1
+#define INPUT_RECORD_CHANNELS 8
+#define INPUT_RECORD_MAX_SIZE (8 * 1024 * 1024)
+#define INPUT_RECORDER_BUFFER_SIZE 0x1000
+#define INPUT_RECORDER_FLUSH_INTERVAL_NS 5000000000ULL
+
+/*
+ * record.bin layout: one InputRecordFileHeader, then a stream of
+ * InputRecordHeader + payload. Every tick starts with a Tick record, the
+ * inputs read during that tick follow. Values are only written when they
+ * differ from the previous read of the same channel, clock decisions and
+ * config writes made over ipc are always written.
+ */
+typedef enum
+{
+    InputRecordType_Tick = 0,       // u32 us since the previous tick
+    InputRecordType_FreqList,       // index = module, u32[count]
+    InputRecordType_ApplicationId,  // u64
+    InputRecordType_Profile,        // u32
+    InputRecordType_Hz,             // index = module, u32
+    InputRecordType_RealHz,         // index = module, u32
+    InputRecordType_Temp,           // index = sensor, u32 millidegrees
+    InputRecordType_Power,          // index = sensor, s32 mW
+    InputRecordType_RamLoad,        // index = load source, u32
+    InputRecordType_SetHz,          // index = module, u32, a clock decision
+    InputRecordType_ResetToStock,   // no payload
+    InputRecordType_Enabled,        // u32, read from the config
+    InputRecordType_Override,       // index = module, u32, read from the config
+    InputRecordType_Profiles,       // u64 tid + SysClkTitleProfileList, set over ipc
+    InputRecordType_ConfigValues,   // SysClkConfigValueList, set over ipc
+    InputRecordType_CpuLoad,        // index = core, u32 permille
+    InputRecordType_RamBandwidth,   // index = load source, u32 MB/s
+    InputRecordType_Battery,        // index = battery value, s32
+    InputRecordType_FanLevel,       // u32 permille
+    InputRecordType_ChargerPower,   // u32 mW
+    InputRecordType_EnumMax
+} InputRecordType;
+
+static_assert(SysClkModule_EnumMax <= INPUT_RECORD_CHANNELS, "too many modules for the input recorder");
+static_assert(SysClkThermalSensor_EnumMax <= INPUT_RECORD_CHANNELS, "too many thermal sensors for the input recorder");
+static_assert(SysClkPowerSensor_EnumMax <= INPUT_RECORD_CHANNELS, "too many power sensors for the input recorder");
+static_assert(SysClkRamLoad_EnumMax <= INPUT_RECORD_CHANNELS, "too many ram load sources for the input recorder");
+static_assert(SysClkCpuCore_EnumMax <= INPUT_RECORD_CHANNELS, "too many cpu cores for the input recorder");
+static_assert(SysClkBatteryValue_EnumMax <= INPUT_RECORD_CHANNELS, "too many battery values for the input recorder");
+
+typedef struct __attribute__((packed))
+{
+    std::uint32_t magic;
+    std::uint16_t version;
+    std::uint8_t socType;
+    std::uint8_t reserved;
+    std::uint32_t startTime;
+} InputRecordFileHeader;
+
+typedef struct __attribute__((packed))
+{
+    std::uint8_t type;
+    std::uint8_t index;
+    std::uint16_t size;
+} InputRecordHeader;
+
+// writes record.bin while record.flag exists, for host replay (see host/src/replay_board.h)
+class InputRecorder
+{
+  public:
+    static bool Active()
+    {
+        return __builtin_expect(active.load(std::memory_order_relaxed), false);
+    }
+
+    static bool BeginTick(std::uint64_t tick);
+    static void Exit();
+
+    static void RecordValue(InputRecordType type, std::uint8_t index, std::uint64_t value)
+    {
+        if (Active())
+        {
+            WriteValue(type, index, value);
+        }
+    }
+
+    static void RecordEvent(InputRecordType type, std::uint8_t index, const void* data, std::uint16_t size)
+    {
+        if (Active())
+        {
+            WriteEvent(type, index, data, size);
+        }
+    }
+
+  protected:
+    static void WriteValue(InputRecordType type, std::uint8_t index, std::uint64_t value);
+    static void WriteEvent(InputRecordType type, std::uint8_t index, const void* data, std::uint16_t size);
+    static void WriteLocked(InputRecordType type, std::uint8_t index, const void* data, std::uint16_t size);
+    static void Start();
+    static void Stop();
+    static void FlushLocked();
+
+    static std::atomic_bool active;
+};
@@ -13,6 +13,10 @@
 #include <switch.h>
 #include "file_utils.h"
 #include "errors.h"
+#include "metrics.h"
+#include "trace.h"
+#include "flight_recorder.h"
+#include "input_recorder.h"
 
 IpcService::IpcService(ClockManager* clockMgr)
 {
@@ -23,6 +27,8 @@ IpcService::IpcService(ClockManager* clockMgr)
     ASSERT_RESULT_OK(rc, "ipcServerInit");
     rc = threadCreate(&this->thread, &IpcService::ProcessThreadFunc, this, NULL, 0x2000, priority, -2);
     ASSERT_RESULT_OK(rc, "threadCreate");
+    Metrics::SetThreadHandle(SysClkThread_Ipc, this->thread.handle);
+    Metrics::SetThreadStack(SysClkThread_Ipc, this->thread.stack_mirror, this->thread.stack_sz);
 
     this->running = false;
     this->clockMgr = clockMgr;
@@ -53,10 +59,17 @@ void IpcService::SetRunning(bool running)
 IpcService::~IpcService()
 {
     this->SetRunning(false);
+    // shutting down anyway, a failure here is only worth a log line
     Result rc = threadClose(&this->thread);
-    ASSERT_RESULT_OK(rc, "threadClose");
+    if (R_FAILED(rc))
+    {
+        FileUtils::LogLine("[ipc] threadClose: [0x%x] %04d-%04d", rc, R_MODULE(rc), R_DESCRIPTION(rc));
+    }
     rc = ipcServerExit(&this->server);
-    ASSERT_RESULT_OK(rc, "ipcServerExit");
+    if (R_FAILED(rc))
+    {
+        FileUtils::LogLine("[ipc] ipcServerExit: [0x%x] %04d-%04d", rc, R_MODULE(rc), R_DESCRIPTION(rc));
+    }
 }
 
 void IpcService::ProcessThreadFunc(void* arg)
@@ -66,6 +79,7 @@ void IpcService::ProcessThreadFunc(void* arg)
     while(true)
     {
         rc = ipcServerProcess(&ipcSrv->server, &IpcService::ServiceHandlerFunc, arg);
+        Metrics::Wakeup(SysClkThread_Ipc);
         if(R_FAILED(rc))
         {
             if(rc == KERNELRESULT(Cancelled))
@@ -82,8 +96,16 @@ void IpcService::ProcessThreadFunc(void* arg)
 
 Result IpcService::ServiceHandlerFunc(void* arg, const IpcServerRequest* r, u8* out_data, size_t* out_dataSize)
 {
-    IpcService* ipcSrv = (IpcService*)arg;
+    TRACE_SCOPE_ARG("IpcService::Request", r->data.cmdId);
+    std::uint64_t startTick = armGetSystemTick();
+    Result rc = IpcService::DispatchRequest((IpcService*)arg, r, out_data, out_dataSize);
+    Metrics::RecordIpc(r->data.cmdId, Metrics::ElapsedUs(startTick));
+
+    return rc;
+}
 
+Result IpcService::DispatchRequest(IpcService* ipcSrv, const IpcServerRequest* r, u8* out_data, size_t* out_dataSize)
+{
     switch(r->data.cmdId)
     {
         case SysClkIpcCmd_GetApiVersion:
@@ -145,7 +167,7 @@ Result IpcService::ServiceHandlerFunc(void* arg, const IpcServerRequest* r, u8*
             break;
 
         case SysClkIpcCmd_GetConfigValues:
-            *out_dataSize = sizeof(SysClkTitleProfileList);
+            *out_dataSize = sizeof(SysClkConfigValueList);
             return ipcSrv->GetConfigValues((SysClkConfigValueList*)out_data);
 
         case SysClkIpcCmd_SetConfigValues:
@@ -167,6 +189,74 @@ Result IpcService::ServiceHandlerFunc(void* arg, const IpcServerRequest* r, u8*
                 );
             }
             break;
+
+        case SysClkIpcCmd_GetFileSizes:
+            *out_dataSize = sizeof(SysClkFileSizes);
+            return ipcSrv->GetFileSizes((SysClkFileSizes*)out_data);
+
+        case SysClkIpcCmd_GetTitleStats:
+            if(r->data.size >= sizeof(std::uint64_t) && r->hipc.meta.num_recv_buffers >= 1)
+            {
+                return ipcSrv->GetTitleStats(
+                    (std::uint64_t*)r->data.ptr,
+                    (SysClkTitleStats*)hipcGetBufferAddress(r->hipc.data.recv_buffers),
+                    hipcGetBufferSize(r->hipc.data.recv_buffers)
+                );
+            }
+            break;
+
+        case SysClkIpcCmd_GetSessions:
+            if(r->data.size >= sizeof(SysClkIpc_GetSessions_Args) && r->hipc.meta.num_recv_buffers >= 1)
+            {
+                *out_dataSize = sizeof(std::uint32_t);
+                return ipcSrv->GetSessions(
+                    (SysClkIpc_GetSessions_Args*)r->data.ptr,
+                    (SysClkSessionSummary*)hipcGetBufferAddress(r->hipc.data.recv_buffers),
+                    hipcGetBufferSize(r->hipc.data.recv_buffers),
+                    (std::uint32_t*)out_data
+                );
+            }
+            break;
+
+        case SysClkIpcCmd_GetMetrics:
+            if(r->hipc.meta.num_recv_buffers >= 1)
+            {
+                return ipcSrv->GetMetrics(
+                    (SysClkMetrics*)hipcGetBufferAddress(r->hipc.data.recv_buffers),
+                    hipcGetBufferSize(r->hipc.data.recv_buffers)
+                );
+            }
+            break;
+
+        case SysClkIpcCmd_SetTraceEnabled:
+            if(r->data.size >= sizeof(std::uint8_t))
+            {
+                return ipcSrv->SetTraceEnabled((std::uint8_t*)r->data.ptr);
+            }
+            break;
+
+        case SysClkIpcCmd_DumpTrace:
+            return ipcSrv->DumpTrace();
+
+        case SysClkIpcCmd_DumpFlightRecorder:
+            return ipcSrv->DumpFlightRecorder();
+
+        case SysClkIpcCmd_GetSelfUsage:
+            *out_dataSize = sizeof(SysClkSelfUsage);
+            return ipcSrv->GetSelfUsage((SysClkSelfUsage*)out_data);
+
+        case SysClkIpcCmd_ReloadConfig:
+            return ipcSrv->ReloadConfig();
+
+        case SysClkIpcCmd_GetContextExt:
+            if(r->hipc.meta.num_recv_buffers >= 1)
+            {
+                return ipcSrv->GetContextExt(
+                    (SysClkContextExt*)hipcGetBufferAddress(r->hipc.data.recv_buffers),
+                    hipcGetBufferSize(r->hipc.data.recv_buffers)
+                );
+            }
+            break;
     }
 
     return SYSCLK_ERROR(Generic);
@@ -239,11 +329,14 @@ Result IpcService::SetProfiles(SysClkIpc_SetProfiles_Args* args)
 
     SysClkTitleProfileList profiles = args->profiles;
 
+    this->clockMgr->MarkApplyOrigin(SysClkMetricHistogram_ConfigApply, armGetSystemTick());
     if(!config->SetProfiles(args->tid, &profiles, true))
     {
         return SYSCLK_ERROR(ConfigSaveFailed);
     }
 
+    InputRecorder::RecordEvent(InputRecordType_Profiles, 0, args, sizeof(*args));
+
     return 0;
 }
 
@@ -266,6 +359,7 @@ Result IpcService::SetOverride(SysClkIpc_SetOverride_Args* args)
     }
 
     Config* config = this->clockMgr->GetConfig();
+    this->clockMgr->MarkApplyOrigin(SysClkMetricHistogram_OverrideApply, armGetSystemTick());
     config->SetOverrideHz(module, hz);
 
     return 0;
@@ -294,11 +388,15 @@ Result IpcService::SetConfigValues(SysClkConfigValueList* configValues)
 
     SysClkConfigValueList configValuesCopy = *configValues;
 
+    this->clockMgr->MarkApplyOrigin(SysClkMetricHistogram_ConfigApply, armGetSystemTick());
+
     if(!config->SetConfigValues(&configValuesCopy, true))
     {
         return SYSCLK_ERROR(ConfigSaveFailed);
     }
 
+    InputRecorder::RecordEvent(InputRecordType_ConfigValues, 0, configValues, sizeof(*configValues));
+
     return 0;
 }
 
@@ -317,4 +415,92 @@ Result IpcService::GetFreqList(SysClkIpc_GetFreqList_Args* args, std::uint32_t*
     this->clockMgr->GetFreqList(args->module, out_list, args->maxCount, out_count);
 
     return 0;
-}
\ No newline at end of file
+}
+
+Result IpcService::GetFileSizes(SysClkFileSizes* out_sizes)
+{
+    FileUtils::GetFileSizes(out_sizes);
+
+    return 0;
+}
+
+Result IpcService::GetTitleStats(std::uint64_t* tid, SysClkTitleStats* out_stats, std::size_t size)
+{
+    if(size != sizeof(*out_stats))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    this->clockMgr->GetStats()->GetTitleStats(*tid, out_stats);
+
+    return 0;
+}
+
+Result IpcService::GetSessions(SysClkIpc_GetSessions_Args* args, SysClkSessionSummary* out_list, std::size_t size, std::uint32_t* out_count)
+{
+    if(args->maxCount != size/sizeof(*out_list))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    this->clockMgr->GetSessions()->GetSessions(args->tid, out_list, args->maxCount, out_count);
+
+    return 0;
+}
+
+Result IpcService::GetMetrics(SysClkMetrics* out_metrics, std::size_t size)
+{
+    if(size != sizeof(*out_metrics))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    Metrics::GetSnapshot(out_metrics);
+
+    return 0;
+}
+
+Result IpcService::SetTraceEnabled(std::uint8_t* enabled)
+{
+    return Trace::SetEnabled(*enabled);
+}
+
+Result IpcService::DumpTrace()
+{
+    return Trace::Dump(FILE_TRACE_PATH);
+}
+
+Result IpcService::DumpFlightRecorder()
+{
+    return FlightRecorder::Dump(FILE_FLIGHT_RECORDER_PATH, "ipc request");
+}
+
+Result IpcService::ReloadConfig()
+{
+    // read by the next tick, edits to the profiles are applied from there
+    this->clockMgr->MarkApplyOrigin(SysClkMetricHistogram_ConfigApply, armGetSystemTick());
+    this->clockMgr->GetConfig()->RequestReload();
+
+    return 0;
+}
+
+Result IpcService::GetSelfUsage(SysClkSelfUsage* out_usage)
+{
+    Metrics::GetSelfUsage(out_usage);
+    out_usage->pollingIntervalMs = this->clockMgr->GetPollingIntervalMs();
+    out_usage->backoff = this->clockMgr->GetPollingBackoff();
+
+    return 0;
+}
+
+Result IpcService::GetContextExt(SysClkContextExt* out_context, std::size_t size)
+{
+    if(size != sizeof(*out_context))
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    this->clockMgr->GetContextExt(out_context);
+
+    return 0;
+}
@@ -25,6 +25,7 @@ class IpcService
   protected:
     static void ProcessThreadFunc(void* arg);
     static Result ServiceHandlerFunc(void* arg, const IpcServerRequest* r, std::uint8_t* out_data, size_t* out_dataSize);
+    static Result DispatchRequest(IpcService* ipcSrv, const IpcServerRequest* r, std::uint8_t* out_data, size_t* out_dataSize);
 
     Result GetApiVersion(u32* out_version);
     Result GetVersionString(char* out_buf, size_t bufSize);
@@ -38,6 +39,16 @@ class IpcService
     Result GetConfigValues(SysClkConfigValueList* out_configValues);
     Result SetConfigValues(SysClkConfigValueList* configValues);
     Result GetFreqList(SysClkIpc_GetFreqList_Args* args, std::uint32_t* out_list, std::size_t size, std::uint32_t* out_count);
+    Result GetFileSizes(SysClkFileSizes* out_sizes);
+    Result GetTitleStats(std::uint64_t* tid, SysClkTitleStats* out_stats, std::size_t size);
+    Result GetSessions(SysClkIpc_GetSessions_Args* args, SysClkSessionSummary* out_list, std::size_t size, std::uint32_t* out_count);
+    Result GetMetrics(SysClkMetrics* out_metrics, std::size_t size);
+    Result SetTraceEnabled(std::uint8_t* enabled);
+    Result DumpTrace();
+    Result DumpFlightRecorder();
+    Result ReloadConfig();
+    Result GetSelfUsage(SysClkSelfUsage* out_usage);
+    Result GetContextExt(SysClkContextExt* out_context, std::size_t size);
 
     bool running;
     Thread thread;
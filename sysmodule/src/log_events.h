@@ -0,0 +1,82 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Binary log event table
+ *
+ * Events are written to log.bin as (tick, id, raw u32 args) and rendered on
+ * the host by scripts/decode_log.py, which parses this very table: ids are
+ * assigned in declaration order, so only ever append new entries.
+ *
+ * Format placeholders understood by the decoder:
+ *   %u %d %x %02u ...  one u32 argument, printf semantics
+ *   %016lX             one u64 argument (two u32, low word first)
+ *   %M %P %S %W        SysClkModule / Profile / ThermalSensor / PowerSensor
+ *   %L                 SysClkMetricHistogram
+ *   %H                 frequency in Hz, printed as MHz with one decimal
+ *   %C                 temperature in millidegrees, printed as °C
+ */
+#define SYSCLK_LOG_EVENTS(X) \
+    X(Session,              "=== session start (unix %u.%03u, tick freq %u) ===") \
+    X(Ready,                "Ready") \
+    X(Exit,                 "Exit") \
+    X(MgrEnabled,           "[mgr] sys-clk status: enabled") \
+    X(MgrDisabled,          "[mgr] sys-clk status: disabled") \
+    X(MgrTitleChange,       "[mgr] TitleID change: %016lX") \
+    X(MgrProfileChange,     "[mgr] Profile change: %P") \
+    X(MgrFreqListRefresh,   "[mgr] %M freq list refresh") \
+    X(MgrFreqListEntry,     "[mgr] %02u - %u - %H") \
+    X(MgrFreqListCount,     "[mgr] count = %u") \
+    X(MgrClockSet,          "[mgr] %M clock set : %H (target = %H)") \
+    X(MgrClockChange,       "[mgr] %M clock change: %H") \
+    X(MgrOverrideChange,    "[mgr] %M override change: %H") \
+    X(MgrOverrideDisabled,  "[mgr] %M override disabled") \
+    X(MgrTemp,              "[mgr] %S temp: %C") \
+    X(MgrPower,             "[mgr] Power %W: %d mW") \
+    X(MgrRealFreq,          "[mgr] %M real freq: %H") \
+    X(CfgFileNotFound,      "[cfg] Error finding file") \
+    X(CfgFileLoadError,     "[cfg] Error loading file") \
+    X(MgrSession,           "[mgr] Session end: %016lX, %u ms, %d mJ") \
+    X(MgrThrottleStart,     "[mgr] %M throttled: real %H (target = %H)") \
+    X(MgrThrottleEnd,       "[mgr] %M throttle end after %u ms (min real = %H)") \
+    X(MgrApplyOverBudget,   "[mgr] %L took %u us (budget = %u ms)") \
+    X(MgrTickOverrun,       "[mgr] Tick took %u us (watchdog = %u ms), flight recorder dumped") \
+    X(MgrPollingBackoff,    "[mgr] CPU use %u permille (budget = %u), polling interval x%u") \
+    X(MgrFreqListCached,    "[mgr] %M freq list loaded from cache, count = %u") \
+    X(MgrFirstApply,        "[mgr] First apply %u ms after start (ready after %u ms)") \
+    X(RecorderStart,        "[rec] Input recording started") \
+    X(RecorderStop,         "[rec] Input recording stopped, %u bytes written") \
+    X(MgrGpuCap,            "[mgr] GPU cap: %H with a %u mW charger (0 = uncapped)")
+
+#define SYSCLK_LOG_EVENT_ENUM(name, format) SysClkLogEvent_##name,
+
+typedef enum
+{
+    SYSCLK_LOG_EVENTS(SYSCLK_LOG_EVENT_ENUM)
+    SysClkLogEvent_EnumMax
+} SysClkLogEvent;
+
+#undef SYSCLK_LOG_EVENT_ENUM
+
+static_assert(SysClkLogEvent_EnumMax <= UINT16_MAX, "log event ids must fit in 16 bits");
+
+#define SYSCLK_LOG_BIN_MAX_ARGS 8
+
+typedef struct __attribute__((packed))
+{
+    std::uint64_t tick;
+    std::uint16_t event;
+    std::uint8_t argc;
+    std::uint8_t reserved;
+} SysClkLogEventHeader;
@@ -17,9 +17,15 @@
 #include "errors.h"
 #include "file_utils.h"
 #include "board.h"
+#include "board_hos.h"
 #include "process_management.h"
 #include "clock_manager.h"
 #include "ipc_service.h"
+#include "flight_recorder.h"
+#include "input_recorder.h"
+#include "metrics.h"
+#include "trace.h"
+#include "arena.h"
 
 #define INNER_HEAP_SIZE 0x30000
 
@@ -73,6 +79,9 @@ extern "C"
 
 int main(int argc, char** argv)
 {
+    Metrics::MarkStart();
+    Metrics::PaintCurrentStack(SysClkThread_Tick);
+
     Result rc = FileUtils::Initialize();
     if (R_FAILED(rc))
     {
@@ -80,45 +89,43 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    try
-    {
-        Board::Initialize();
-        ProcessManagement::Initialize();
+    // built without exceptions: unrecoverable errors go through Errors::Fatal,
+    // service failures are returned and retried by the callers
+    Board::Initialize(HosBoard::CreateDefault());
+    ProcessManagement::Initialize();
 
-        ProcessManagement::WaitForQLaunch();
+    // nothing here applies clocks, so it overlaps with the rest of the boot
+    Trace::Initialize();
+    ClockManager* clockMgr = new ClockManager();
 
-        ClockManager* clockMgr = new ClockManager();
-        IpcService* ipcSrv = new IpcService(clockMgr);
+    ProcessManagement::WaitForQLaunch();
 
-        FileUtils::LogLine("Ready");
+    IpcService* ipcSrv = new IpcService(clockMgr);
 
-        clockMgr->SetRunning(true);
-        clockMgr->GetConfig()->SetEnabled(true);
-        ipcSrv->SetRunning(true);
+    // runtime tables are all carved by now, the steady state does not allocate
+    Arena::Seal();
 
-        while (clockMgr->Running())
-        {
-            clockMgr->Tick();
-            clockMgr->WaitForNextTick();
-        }
+    Metrics::MarkReady();
+    FileUtils::LogEvent(SysClkLogEvent_Ready);
 
-        ipcSrv->SetRunning(false);
-        delete ipcSrv;
-        delete clockMgr;
-        ProcessManagement::Exit();
-        Board::Exit();
-    }
-    catch (const std::exception &ex)
-    {
-        FileUtils::LogLine("[!] %s", ex.what());
-    }
-    catch (...)
+    clockMgr->SetRunning(true);
+    clockMgr->GetConfig()->SetEnabled(true);
+    ipcSrv->SetRunning(true);
+
+    while (clockMgr->Running())
     {
-        std::exception_ptr p = std::current_exception();
-        FileUtils::LogLine("[!?] %s", p ? p.__cxa_exception_type()->name() : "...");
+        clockMgr->Tick();
+        clockMgr->WaitForNextTick();
     }
 
-    FileUtils::LogLine("Exit");
+    ipcSrv->SetRunning(false);
+    delete ipcSrv;
+    delete clockMgr;
+    InputRecorder::Exit();
+    ProcessManagement::Exit();
+    Board::Exit();
+
+    FileUtils::LogEvent(SysClkLogEvent_Exit);
     svcSleepThread(1000000ULL);
     FileUtils::Exit();
     return 0;
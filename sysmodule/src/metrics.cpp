@@ -0,0 +1,266 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "metrics.h"
+#include <cstring>
+#include <malloc.h>
+#include <nxExt.h>
+#include "arena.h"
+
+extern "C" char* fake_heap_start;
+extern "C" char* fake_heap_end;
+
+static LockableMutex g_histogram_mutex;
+static std::uint64_t g_counters[SysClkMetricCounter_EnumMax];
+static SysClkMetricsHistogram g_histograms[SysClkMetricHistogram_EnumMax];
+static SysClkMetricsHistogram g_ipc_histograms[SYSCLK_METRICS_IPC_CMD_MAX];
+
+static Handle g_thread_handles[SysClkThread_EnumMax];
+static std::uint64_t g_thread_wakeups[SysClkThread_EnumMax];
+static LockableMutex g_self_usage_mutex;
+static SysClkSelfUsage g_self_usage;
+static std::uint64_t g_self_usage_tick;
+static std::uint64_t g_self_usage_cpu_ticks[SysClkThread_EnumMax];
+static std::uint32_t* g_thread_stacks[SysClkThread_EnumMax];
+static std::uint64_t g_start_tick;
+
+void Metrics::Increment(SysClkMetricCounter counter, std::uint64_t n)
+{
+    if (SYSCLK_ENUM_VALID(SysClkMetricCounter, counter))
+    {
+        __atomic_fetch_add(&g_counters[counter], n, __ATOMIC_RELAXED);
+    }
+}
+
+void Metrics::RecordLocked(SysClkMetricsHistogram* histogram, std::uint64_t us)
+{
+    std::uint32_t bucket = us ? 64 - __builtin_clzll(us) : 0;
+
+    std::uint32_t clampedUs = std::min(us, (std::uint64_t)UINT32_MAX);
+
+    histogram->buckets[std::min(bucket, (std::uint32_t)SYSCLK_METRICS_BUCKETS - 1)]++;
+    histogram->minUs = histogram->count ? std::min(histogram->minUs, clampedUs) : clampedUs;
+    histogram->count++;
+    histogram->sumUs += us;
+    histogram->maxUs = std::max(histogram->maxUs, clampedUs);
+}
+
+void Metrics::Record(SysClkMetricHistogram histogram, std::uint64_t us)
+{
+    if (SYSCLK_ENUM_VALID(SysClkMetricHistogram, histogram))
+    {
+        std::scoped_lock lock{g_histogram_mutex};
+        Metrics::RecordLocked(&g_histograms[histogram], us);
+    }
+}
+
+void Metrics::RecordIpc(std::uint32_t cmdId, std::uint64_t us)
+{
+    if (cmdId < SYSCLK_METRICS_IPC_CMD_MAX)
+    {
+        std::scoped_lock lock{g_histogram_mutex};
+        Metrics::RecordLocked(&g_ipc_histograms[cmdId], us);
+    }
+}
+
+void Metrics::GetSnapshot(SysClkMetrics* out_metrics)
+{
+    out_metrics->uptimeMs = armTicksToNs(armGetSystemTick()) / 1000000ULL;
+
+    for (unsigned int counter = 0; counter < SysClkMetricCounter_EnumMax; counter++)
+    {
+        out_metrics->counters[counter] = __atomic_load_n(&g_counters[counter], __ATOMIC_RELAXED);
+    }
+
+    // transactions are issued from nxExt drivers which have no access to the registry
+    out_metrics->counters[SysClkMetricCounter_I2cCalls] += i2cExtGetTransactionCount();
+
+    std::scoped_lock lock{g_histogram_mutex};
+    memcpy(out_metrics->histograms, g_histograms, sizeof(out_metrics->histograms));
+    memcpy(out_metrics->ipc, g_ipc_histograms, sizeof(out_metrics->ipc));
+}
+
+std::uint64_t Metrics::GetCallCount()
+{
+    std::uint64_t count = i2cExtGetTransactionCount();
+
+    for (unsigned int counter = SysClkMetricCounter_ClkrstCalls; counter <= SysClkMetricCounter_FanCalls; counter++)
+    {
+        count += __atomic_load_n(&g_counters[counter], __ATOMIC_RELAXED);
+    }
+
+    return count;
+}
+
+void Metrics::SetThreadHandle(SysClkThread thread, Handle handle)
+{
+    if (SYSCLK_ENUM_VALID(SysClkThread, thread))
+    {
+        g_thread_handles[thread] = handle;
+    }
+}
+
+void Metrics::SetThreadStack(SysClkThread thread, void* stack, std::size_t size)
+{
+    if (!SYSCLK_ENUM_VALID(SysClkThread, thread))
+    {
+        return;
+    }
+
+    // the thread must not be running yet, the whole stack gets painted
+    std::uint32_t* words = (std::uint32_t*)stack;
+    for (std::size_t i = 0; i < size / sizeof(std::uint32_t); i++)
+    {
+        words[i] = METRICS_STACK_PAINT;
+    }
+
+    g_thread_stacks[thread] = words;
+    g_self_usage.stackSize[thread] = size;
+}
+
+void Metrics::PaintCurrentStack(SysClkThread thread)
+{
+    MemoryInfo info;
+    u32 pageInfo;
+    std::uint8_t marker;
+
+    if (!SYSCLK_ENUM_VALID(SysClkThread, thread) || R_FAILED(svcQueryMemory(&info, &pageInfo, (u64)&marker)))
+    {
+        return;
+    }
+
+    // stacks grow down, paint from the bottom up to a bit below this frame
+    std::uint32_t* words = (std::uint32_t*)info.addr;
+    std::uint32_t* end = (std::uint32_t*)((std::uintptr_t)&marker - METRICS_STACK_PAINT_MARGIN);
+    for (std::uint32_t* word = words; word < end; word++)
+    {
+        *word = METRICS_STACK_PAINT;
+    }
+
+    g_thread_stacks[thread] = words;
+    g_self_usage.stackSize[thread] = info.size;
+}
+
+void Metrics::SampleMemoryLocked()
+{
+    struct mallinfo heap = mallinfo();
+
+    g_self_usage.heapSize = fake_heap_end - fake_heap_start;
+    g_self_usage.heapUsed = heap.uordblks;
+    // newlib only grows the break, this is the high-water of the heap footprint
+    g_self_usage.heapPeak = std::max(g_self_usage.heapPeak, (std::uint32_t)heap.arena);
+    g_self_usage.arenaSize = ARENA_SIZE;
+    g_self_usage.arenaUsed = Arena::GetUsed();
+
+    for (unsigned int thread = 0; thread < SysClkThread_EnumMax; thread++)
+    {
+        std::uint32_t* words = g_thread_stacks[thread];
+        std::size_t count = g_self_usage.stackSize[thread] / sizeof(std::uint32_t);
+        std::size_t untouched = 0;
+
+        if (!words)
+        {
+            continue;
+        }
+
+        while (untouched < count && words[untouched] == METRICS_STACK_PAINT)
+        {
+            untouched++;
+        }
+
+        g_self_usage.stackPeak[thread] = (count - untouched) * sizeof(std::uint32_t);
+    }
+}
+
+void Metrics::Wakeup(SysClkThread thread)
+{
+    if (SYSCLK_ENUM_VALID(SysClkThread, thread))
+    {
+        __atomic_fetch_add(&g_thread_wakeups[thread], 1, __ATOMIC_RELAXED);
+    }
+}
+
+bool Metrics::SampleSelfUsage(std::uint32_t* out_totalPermille)
+{
+    std::uint64_t tick = armGetSystemTick();
+    std::uint64_t windowTicks = tick - g_self_usage_tick;
+
+    if (g_self_usage_tick && armTicksToNs(windowTicks) < METRICS_SELF_USAGE_WINDOW_NS)
+    {
+        return false;
+    }
+
+    std::scoped_lock lock{g_self_usage_mutex};
+    std::uint32_t totalPermille = 0;
+
+    for (unsigned int thread = 0; thread < SysClkThread_EnumMax; thread++)
+    {
+        std::uint64_t cpuTicks = 0;
+        std::uint64_t wakeups = __atomic_load_n(&g_thread_wakeups[thread], __ATOMIC_RELAXED);
+
+        // total across cores, the kernel counts time while the thread is scheduled
+        if (!g_thread_handles[thread] || R_FAILED(svcGetInfo(&cpuTicks, InfoType_ThreadTickCount, g_thread_handles[thread], UINT64_MAX)))
+        {
+            cpuTicks = g_self_usage_cpu_ticks[thread];
+        }
+
+        if (g_self_usage_tick && windowTicks)
+        {
+            g_self_usage.cpuPermille[thread] = (cpuTicks - g_self_usage_cpu_ticks[thread]) * 1000 / windowTicks;
+            g_self_usage.wakeupsPerMin[thread] = (wakeups - g_self_usage.wakeups[thread]) * 60000000000ULL / armTicksToNs(windowTicks);
+            totalPermille += g_self_usage.cpuPermille[thread];
+        }
+
+        g_self_usage.cpuTimeUs[thread] = armTicksToNs(cpuTicks) / 1000;
+        g_self_usage.wakeups[thread] = wakeups;
+        g_self_usage_cpu_ticks[thread] = cpuTicks;
+    }
+
+    Metrics::SampleMemoryLocked();
+
+    bool hasWindow = g_self_usage_tick != 0;
+    g_self_usage_tick = tick;
+    *out_totalPermille = totalPermille;
+
+    return hasWindow;
+}
+
+void Metrics::GetSelfUsage(SysClkSelfUsage* out_usage)
+{
+    std::scoped_lock lock{g_self_usage_mutex};
+    memcpy(out_usage, &g_self_usage, sizeof(SysClkSelfUsage));
+}
+
+void Metrics::MarkStart()
+{
+    g_start_tick = armGetSystemTick();
+}
+
+void Metrics::MarkReady()
+{
+    std::scoped_lock lock{g_self_usage_mutex};
+    g_self_usage.startupReadyMs = Metrics::ElapsedUs(g_start_tick) / 1000;
+}
+
+bool Metrics::MarkFirstApply(std::uint32_t* out_firstApplyMs, std::uint32_t* out_readyMs)
+{
+    std::scoped_lock lock{g_self_usage_mutex};
+
+    if (g_self_usage.startupFirstApplyMs)
+    {
+        return false;
+    }
+
+    // never 0, it doubles as the already marked flag
+    g_self_usage.startupFirstApplyMs = std::max((std::uint64_t)1, Metrics::ElapsedUs(g_start_tick) / 1000);
+    *out_firstApplyMs = g_self_usage.startupFirstApplyMs;
+    *out_readyMs = g_self_usage.startupReadyMs;
+    return true;
+}
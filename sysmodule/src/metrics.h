@@ -0,0 +1,48 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdint>
+#include <switch.h>
+#include <sysclk.h>
+
+#define METRICS_SELF_USAGE_WINDOW_NS 5000000000ULL
+#define METRICS_STACK_PAINT 0x5A5A5A5AU
+// left untouched below the current frame when painting a live stack
+#define METRICS_STACK_PAINT_MARGIN 0x400
+
+class Metrics
+{
+  public:
+    static void Increment(SysClkMetricCounter counter, std::uint64_t n = 1);
+    static void Record(SysClkMetricHistogram histogram, std::uint64_t us);
+    static void RecordIpc(std::uint32_t cmdId, std::uint64_t us);
+    static void GetSnapshot(SysClkMetrics* out_metrics);
+    // service calls and i2c transactions issued so far, for per-operation deltas
+    static std::uint64_t GetCallCount();
+    static void SetThreadHandle(SysClkThread thread, Handle handle);
+    static void SetThreadStack(SysClkThread thread, void* stack, std::size_t size);
+    static void PaintCurrentStack(SysClkThread thread);
+    static void Wakeup(SysClkThread thread);
+    static bool SampleSelfUsage(std::uint32_t* out_totalPermille);
+    static void GetSelfUsage(SysClkSelfUsage* out_usage);
+    static void MarkStart();
+    static void MarkReady();
+    static bool MarkFirstApply(std::uint32_t* out_firstApplyMs, std::uint32_t* out_readyMs);
+
+    static std::uint64_t ElapsedUs(std::uint64_t startTick)
+    {
+        return armTicksToNs(armGetSystemTick() - startTick) / 1000;
+    }
+
+  protected:
+    static void RecordLocked(SysClkMetricsHistogram* histogram, std::uint64_t us);
+    static void SampleMemoryLocked();
+};
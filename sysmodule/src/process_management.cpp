@@ -11,6 +11,7 @@
 #include "process_management.h"
 #include "file_utils.h"
 #include "errors.h"
+#include "metrics.h"
 
 void ProcessManagement::Initialize()
 {
@@ -25,39 +26,51 @@ void ProcessManagement::Initialize()
 
 void ProcessManagement::WaitForQLaunch()
 {
-    Result rc = 0;
+    // pm:dmnt launch hooks hold the hooked process until a debugger starts it,
+    // so there is no event to wait on: poll, but finely and without a trailing sleep
     std::uint64_t pid = 0;
-    do
+    while (R_FAILED(pmdmntGetProcessId(&pid, PROCESS_MANAGEMENT_QLAUNCH_TID)))
     {
-        rc = pmdmntGetProcessId(&pid, PROCESS_MANAGEMENT_QLAUNCH_TID);
-        svcSleepThread(500000000ULL);
-    } while (R_FAILED(rc));
+        svcSleepThread(PROCESS_MANAGEMENT_QLAUNCH_POLL_NS);
+    }
 }
 
-std::uint64_t ProcessManagement::GetCurrentApplicationId()
+Result ProcessManagement::GetCurrentApplicationId(std::uint64_t* out_tid)
 {
-    Result rc = 0;
+    Result rc = Errors::ServiceReady(ErrorService_Pm);
     std::uint64_t pid = 0;
-    std::uint64_t tid = 0;
+
+    if (R_FAILED(rc))
+    {
+        return rc;
+    }
+
     rc = pmdmntGetApplicationProcessId(&pid);
+    Metrics::Increment(SysClkMetricCounter_PmCalls);
 
     if (rc == 0x20f)
     {
-        return PROCESS_MANAGEMENT_QLAUNCH_TID;
+        *out_tid = PROCESS_MANAGEMENT_QLAUNCH_TID;
+        return 0;
     }
 
-    ASSERT_RESULT_OK(rc, "pmdmntGetApplicationProcessId");
+    rc = Errors::ServiceResult(ErrorService_Pm, rc, "pmdmntGetApplicationProcessId");
+    if (R_FAILED(rc))
+    {
+        return rc;
+    }
 
-    rc = pminfoGetProgramId(&tid, pid);
+    rc = pminfoGetProgramId(out_tid, pid);
+    Metrics::Increment(SysClkMetricCounter_PmCalls);
 
+    // the application exited in between
     if (rc == 0x20f)
     {
-        return PROCESS_MANAGEMENT_QLAUNCH_TID;
+        *out_tid = PROCESS_MANAGEMENT_QLAUNCH_TID;
+        return 0;
     }
 
-    ASSERT_RESULT_OK(rc, "pminfoGetProgramId");
-
-    return tid;
+    return Errors::ServiceResult(ErrorService_Pm, rc, "pminfoGetProgramId");
 }
 
 void ProcessManagement::Exit()
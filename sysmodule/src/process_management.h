@@ -13,12 +13,13 @@
 #include <cstdint>
 
 #define PROCESS_MANAGEMENT_QLAUNCH_TID 0x0100000000001000ULL
+#define PROCESS_MANAGEMENT_QLAUNCH_POLL_NS 50000000ULL
 
 class ProcessManagement
 {
   public:
     static void Initialize();
     static void WaitForQLaunch();
-    static std::uint64_t GetCurrentApplicationId();
+    static Result GetCurrentApplicationId(std::uint64_t* out_tid);
     static void Exit();
 };
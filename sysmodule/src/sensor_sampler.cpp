@@ -0,0 +1,285 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "sensor_sampler.h"
+#include <algorithm>
+#include <cstring>
+#include "board.h"
+#include "errors.h"
+#include "metrics.h"
+
+SensorSampler::SensorSampler(Config* config)
+{
+    this->config = config;
+    for(unsigned int sensor = 0; sensor < SysClkSensor_EnumMax; sensor++)
+    {
+        this->sampleTicks[sensor] = 0;
+        this->sampleCalls[sensor] = 0;
+        this->sampleUs[sensor] = 0;
+    }
+    for(unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+    {
+        this->cpuLoad[core] = 0;
+    }
+    for(unsigned int loadSource = 0; loadSource < SysClkRamLoad_EnumMax; loadSource++)
+    {
+        this->ramBandwidth[loadSource] = 0;
+    }
+    for(unsigned int value = 0; value < SysClkBatteryValue_EnumMax; value++)
+    {
+        this->battery[value] = 0;
+    }
+    this->fanLevel = 0;
+    this->drainUa = 0;
+    this->drainTick = 0;
+    this->timeToEmptyMin = 0;
+    this->chargerPowerMw = 0;
+    memset(this->filterSpecs, 0, sizeof(this->filterSpecs));
+    memset(this->raw, 0, sizeof(this->raw));
+    memset(this->filtered, 0, sizeof(this->filtered));
+}
+
+std::uint32_t SensorSampler::GetPeriodMs(SysClkSensor sensor)
+{
+    switch(sensor)
+    {
+        case SysClkSensor_BoardTemp:
+            return this->config->GetConfigValue(SysClkConfigValue_BoardTempSampleMs);
+        case SysClkSensor_SkinTemp:
+            return this->config->GetConfigValue(SysClkConfigValue_SkinTempSampleMs);
+        case SysClkSensor_Power:
+            return this->config->GetConfigValue(SysClkConfigValue_PowerSampleMs);
+        case SysClkSensor_RealFreq:
+            return this->config->GetConfigValue(SysClkConfigValue_RealFreqSampleMs);
+        case SysClkSensor_RamLoad:
+            return this->config->GetConfigValue(SysClkConfigValue_RamLoadSampleMs);
+        case SysClkSensor_CpuLoad:
+            return this->config->GetConfigValue(SysClkConfigValue_CpuLoadSampleMs);
+        default:
+            ASSERT_ENUM_VALID(SysClkSensor, sensor);
+    }
+
+    return 0;
+}
+
+void SensorSampler::UpdateTimeToEmpty(std::uint64_t tick)
+{
+    std::int32_t currentMa = this->battery[SysClkBatteryValue_AvgCurrentMa];
+    std::int32_t remainingMah = this->battery[SysClkBatteryValue_RemainingMah];
+
+    // charging or no fuel gauge, the next discharge starts from scratch
+    if(currentMa >= 0 || remainingMah <= 0)
+    {
+        this->drainUa = 0;
+        this->drainTick = 0;
+        this->timeToEmptyMin = 0;
+        return;
+    }
+
+    std::int64_t drainUa = -(std::int64_t)currentMa * 1000;
+    if(!this->drainTick)
+    {
+        this->drainUa = drainUa;
+    }
+    else
+    {
+        // moving average weighted by elapsed / (time constant + elapsed), whatever the sample period
+        std::int64_t elapsedMs = armTicksToNs(tick - this->drainTick) / 1000000;
+        this->drainUa += (drainUa - this->drainUa) * elapsedMs / (SENSOR_SAMPLER_TTE_SMOOTHING_MS + elapsedMs);
+    }
+
+    this->drainTick = tick;
+    this->timeToEmptyMin = this->drainUa > 0 ? (std::int64_t)remainingMah * 60 * 1000 / this->drainUa : 0;
+}
+
+SysClkSensor SensorSampler::GetSignalSensor(SysClkSignal signal)
+{
+    switch(signal)
+    {
+        case SysClkSignal_PowerNow:
+        case SysClkSignal_PowerAvg:
+            return SysClkSensor_Power;
+        case SysClkSignal_RamLoadAll:
+        case SysClkSignal_RamLoadCpu:
+        case SysClkSignal_RamBandwidthAll:
+        case SysClkSignal_RamBandwidthCpu:
+            return SysClkSensor_RamLoad;
+        default:
+            ASSERT_ENUM_VALID(SysClkSignal, signal);
+    }
+
+    return SysClkSensor_EnumMax;
+}
+
+std::int32_t SensorSampler::GetRawSignal(SysClkSignal signal, SysClkContext* context)
+{
+    switch(signal)
+    {
+        case SysClkSignal_PowerNow:
+            return context->power[SysClkPowerSensor_Now];
+        case SysClkSignal_PowerAvg:
+            return context->power[SysClkPowerSensor_Avg];
+        case SysClkSignal_RamLoadAll:
+            return context->ramLoad[SysClkRamLoad_All];
+        case SysClkSignal_RamLoadCpu:
+            return context->ramLoad[SysClkRamLoad_Cpu];
+        case SysClkSignal_RamBandwidthAll:
+            return this->ramBandwidth[SysClkRamLoad_All];
+        case SysClkSignal_RamBandwidthCpu:
+            return this->ramBandwidth[SysClkRamLoad_Cpu];
+        default:
+            ASSERT_ENUM_VALID(SysClkSignal, signal);
+    }
+
+    return 0;
+}
+
+void SensorSampler::Filter(SysClkSensor sensor, SysClkContext* context, std::uint32_t elapsedMs)
+{
+    char spec[CONFIG_FILTER_SPEC_MAX];
+
+    for(unsigned int signal = 0; signal < SysClkSignal_EnumMax; signal++)
+    {
+        if(SensorSampler::GetSignalSensor((SysClkSignal)signal) != sensor)
+        {
+            continue;
+        }
+
+        // specs are validated when the config is loaded, a changed one starts over
+        this->config->GetFilterSpec((SysClkSignal)signal, spec, sizeof(spec));
+        if(strcmp(spec, this->filterSpecs[signal]) && this->filters[signal].Configure(spec))
+        {
+            memcpy(this->filterSpecs[signal], spec, sizeof(spec));
+        }
+
+        this->raw[signal] = this->GetRawSignal((SysClkSignal)signal, context);
+        this->filtered[signal] = this->filters[signal].Apply(this->raw[signal], elapsedMs);
+    }
+}
+
+bool SensorSampler::IsDue(SysClkSensor sensor, std::uint64_t tick)
+{
+    if(!this->sampleTicks[sensor])
+    {
+        return true;
+    }
+
+    return armTicksToNs(tick - this->sampleTicks[sensor]) >= this->GetPeriodMs(sensor) * 1000000ULL;
+}
+
+void SensorSampler::Read(SysClkSensor sensor, SysClkContext* context)
+{
+    switch(sensor)
+    {
+        case SysClkSensor_BoardTemp:
+            Board::GetBoardTemperatureMilli(&context->temps[SysClkThermalSensor_SOC], &context->temps[SysClkThermalSensor_PCB]);
+            this->fanLevel = Board::GetFanLevel();
+            break;
+        case SysClkSensor_SkinTemp:
+            context->temps[SysClkThermalSensor_Skin] = Board::GetTemperatureMilli(SysClkThermalSensor_Skin);
+            break;
+        case SysClkSensor_Power:
+        {
+            BoardBattery battery;
+            Board::GetBattery(&battery);
+            memcpy(context->power, battery.powerMw, sizeof(context->power));
+            memcpy(this->battery, battery.values, sizeof(this->battery));
+            this->UpdateTimeToEmpty(armGetSystemTick());
+            this->chargerPowerMw = Board::GetChargerPowerMw();
+            break;
+        }
+        case SysClkSensor_RealFreq:
+            for(unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+            {
+                context->realFreqs[module] = Board::GetRealHz((SysClkModule)module);
+            }
+            break;
+        case SysClkSensor_RamLoad:
+            Board::SetRamSampling(
+                this->config->GetConfigValue(SysClkConfigValue_RamActmonPeriodMs),
+                this->config->GetConfigValue(SysClkConfigValue_RamActmonWindow)
+            );
+            for(unsigned int loadSource = 0; loadSource < SysClkRamLoad_EnumMax; loadSource++)
+            {
+                context->ramLoad[loadSource] = Board::GetRamLoad((SysClkRamLoad)loadSource);
+                this->ramBandwidth[loadSource] = Board::GetRamBandwidth((SysClkRamLoad)loadSource);
+            }
+            break;
+        case SysClkSensor_CpuLoad:
+            for(unsigned int core = 0; core < SysClkCpuCore_EnumMax; core++)
+            {
+                this->cpuLoad[core] = Board::GetCpuLoad((SysClkCpuCore)core);
+            }
+            break;
+        default:
+            ASSERT_ENUM_VALID(SysClkSensor, sensor);
+    }
+}
+
+std::uint32_t SensorSampler::Sample(SysClkContext* context)
+{
+    std::uint32_t sampled = 0;
+    std::uint64_t tick = armGetSystemTick();
+
+    for(unsigned int sensor = 0; sensor < SysClkSensor_EnumMax; sensor++)
+    {
+        if(!this->IsDue((SysClkSensor)sensor, tick))
+        {
+            continue;
+        }
+
+        std::uint64_t calls = Metrics::GetCallCount();
+        std::uint64_t startTick = armGetSystemTick();
+        this->Read((SysClkSensor)sensor, context);
+        this->sampleCalls[sensor] = Metrics::GetCallCount() - calls;
+        this->sampleUs[sensor] = Metrics::ElapsedUs(startTick);
+
+        std::uint32_t elapsedMs = this->sampleTicks[sensor] ? armTicksToNs(tick - this->sampleTicks[sensor]) / 1000000 : 0;
+        this->Filter((SysClkSensor)sensor, context, elapsedMs);
+        this->sampleTicks[sensor] = tick;
+        sampled |= 1 << sensor;
+    }
+
+    return sampled;
+}
+
+void SensorSampler::Invalidate(SysClkSensor sensor)
+{
+    ASSERT_ENUM_VALID(SysClkSensor, sensor);
+    this->sampleTicks[sensor] = 0;
+}
+
+std::uint32_t SensorSampler::GetChargerPowerMw()
+{
+    return this->chargerPowerMw;
+}
+
+void SensorSampler::GetSampleInfo(SysClkContextExt* out_context)
+{
+    std::uint64_t tick = armGetSystemTick();
+    memcpy(out_context->cpuLoad, this->cpuLoad, sizeof(out_context->cpuLoad));
+    out_context->fanLevel = this->fanLevel;
+    memcpy(out_context->ramBandwidth, this->ramBandwidth, sizeof(out_context->ramBandwidth));
+    memcpy(out_context->battery, this->battery, sizeof(out_context->battery));
+    out_context->timeToEmptyMin = this->timeToEmptyMin;
+    out_context->chargerPowerMw = this->chargerPowerMw;
+    memcpy(out_context->raw, this->raw, sizeof(out_context->raw));
+    memcpy(out_context->filtered, this->filtered, sizeof(out_context->filtered));
+    for(unsigned int sensor = 0; sensor < SysClkSensor_EnumMax; sensor++)
+    {
+        out_context->sampleTicks[sensor] = this->sampleTicks[sensor];
+        out_context->sampleAgeMs[sensor] = this->sampleTicks[sensor]
+            ? (std::uint32_t)std::min(armTicksToNs(tick - this->sampleTicks[sensor]) / 1000000, (std::uint64_t)UINT32_MAX)
+            : UINT32_MAX;
+        out_context->samplePeriodMs[sensor] = this->GetPeriodMs((SysClkSensor)sensor);
+        out_context->sampleCalls[sensor] = this->sampleCalls[sensor];
+        out_context->sampleUs[sensor] = this->sampleUs[sensor];
+    }
+}
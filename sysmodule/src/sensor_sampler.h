@@ -0,0 +1,66 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdint>
+#include <switch.h>
+#include <sysclk.h>
+#include "config.h"
+#include "signal_filter.h"
+
+// time constant of the discharge current behind the time-to-empty estimate
+#define SENSOR_SAMPLER_TTE_SMOOTHING_MS 30000
+
+/*
+ * Reads every sensor of the context, each group at its own configured period
+ * (0 = every tick). Values of a group are read together since they come from
+ * the same device, the sample tick is kept per group so clients can tell how
+ * fresh a value is, along with the round-trips and time the read took.
+ * Not thread safe, used under the clock manager context lock.
+ */
+class SensorSampler
+{
+  public:
+    SensorSampler(Config* config);
+
+    // refreshes the groups that are due into context, returns a mask of SysClkSensor bits
+    std::uint32_t Sample(SysClkContext* context);
+    // makes the group due on the next Sample
+    void Invalidate(SysClkSensor sensor);
+    std::uint32_t GetChargerPowerMw();
+    // fills everything in the extended context but the context itself
+    void GetSampleInfo(SysClkContextExt* out_context);
+
+  protected:
+    bool IsDue(SysClkSensor sensor, std::uint64_t tick);
+    void Read(SysClkSensor sensor, SysClkContext* context);
+    std::uint32_t GetPeriodMs(SysClkSensor sensor);
+    void UpdateTimeToEmpty(std::uint64_t tick);
+    void Filter(SysClkSensor sensor, SysClkContext* context, std::uint32_t elapsedMs);
+    static SysClkSensor GetSignalSensor(SysClkSignal signal);
+    std::int32_t GetRawSignal(SysClkSignal signal, SysClkContext* context);
+
+    Config* config;
+    std::uint32_t cpuLoad[SysClkCpuCore_EnumMax];
+    std::uint32_t fanLevel;
+    std::uint32_t ramBandwidth[SysClkRamLoad_EnumMax];
+    std::int32_t battery[SysClkBatteryValue_EnumMax];
+    std::int64_t drainUa;
+    std::uint64_t drainTick;
+    std::uint32_t timeToEmptyMin;
+    std::uint32_t chargerPowerMw;
+    SignalFilter filters[SysClkSignal_EnumMax];
+    char filterSpecs[SysClkSignal_EnumMax][CONFIG_FILTER_SPEC_MAX];
+    std::int32_t raw[SysClkSignal_EnumMax];
+    std::int32_t filtered[SysClkSignal_EnumMax];
+    std::uint64_t sampleTicks[SysClkSensor_EnumMax];
+    std::uint32_t sampleCalls[SysClkSensor_EnumMax];
+    std::uint32_t sampleUs[SysClkSensor_EnumMax];
+};
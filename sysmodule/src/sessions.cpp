@@ -0,0 +1,190 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "sessions.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sys/stat.h>
+#include "file_utils.h"
+#include "metrics.h"
+
+Sessions::Sessions(std::string dir)
+{
+    this->dir = dir;
+    this->active = false;
+    this->tid = 0;
+}
+
+Sessions::~Sessions()
+{
+    this->End();
+}
+
+Sessions* Sessions::CreateDefault()
+{
+    return new Sessions(FILE_CONFIG_DIR "/sessions");
+}
+
+void Sessions::GetPath(std::uint64_t tid, char* out, std::size_t size)
+{
+    snprintf(out, size, "%s/%016lX.bin", this->dir.c_str(), tid);
+}
+
+void Sessions::Begin(std::uint64_t tid)
+{
+    std::scoped_lock lock{this->sessionsMutex};
+
+    // no application running, nothing to report
+    this->active = tid != 0;
+    this->tid = tid;
+    this->startTime = time(NULL);
+    this->durationMs = 0;
+    this->energyUj = 0;
+    this->profileMask = 0;
+    memset(this->tempSums, 0, sizeof(this->tempSums));
+    memset(this->peakTemps, 0, sizeof(this->peakTemps));
+    memset(this->freqSums, 0, sizeof(this->freqSums));
+    memset(this->freqMs, 0, sizeof(this->freqMs));
+}
+
+void Sessions::Sample(const SysClkContext* context, std::uint32_t ms)
+{
+    std::scoped_lock lock{this->sessionsMutex};
+
+    if (!this->active || context->applicationId != this->tid)
+    {
+        return;
+    }
+
+    this->durationMs += ms;
+    this->energyUj += (std::int64_t)context->power[SysClkPowerSensor_Now] * ms;
+    this->profileMask |= 1 << context->profile;
+
+    for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+    {
+        this->tempSums[sensor] += (std::uint64_t)context->temps[sensor] * ms;
+        this->peakTemps[sensor] = std::max(this->peakTemps[sensor], context->temps[sensor]);
+    }
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        if (context->freqs[module])
+        {
+            this->freqSums[module] += (std::uint64_t)context->freqs[module] * ms;
+            this->freqMs[module] += ms;
+        }
+    }
+}
+
+void Sessions::End()
+{
+    std::scoped_lock lock{this->sessionsMutex};
+
+    if (!this->active || !this->durationMs)
+    {
+        this->active = false;
+        return;
+    }
+
+    SysClkSessionSummary summary;
+    memset(&summary, 0, sizeof(summary));
+    summary.tid = this->tid;
+    summary.startTime = this->startTime;
+    summary.durationMs = std::min(this->durationMs, (std::uint64_t)UINT32_MAX);
+    summary.energyMj = this->energyUj / 1000;
+    summary.profileMask = this->profileMask;
+
+    for (unsigned int sensor = 0; sensor < SysClkThermalSensor_EnumMax; sensor++)
+    {
+        summary.avgTemps[sensor] = this->tempSums[sensor] / this->durationMs;
+        summary.peakTemps[sensor] = this->peakTemps[sensor];
+    }
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        summary.avgFreqs[module] = this->freqMs[module] ? this->freqSums[module] / this->freqMs[module] : 0;
+    }
+
+    FileUtils::LogEvent(SysClkLogEvent_MgrSession, summary.tid, summary.durationMs, summary.energyMj);
+
+    if (!this->Append(&summary))
+    {
+        FileUtils::LogLine("[mgr] Could not save session for %016lX", summary.tid);
+    }
+
+    this->active = false;
+}
+
+bool Sessions::Append(const SysClkSessionSummary* summary)
+{
+    char path[FILE_PATH_MAX];
+    this->GetPath(summary->tid, path, sizeof(path));
+
+    mkdir(this->dir.c_str(), 0777);
+
+    FILE* file = fopen(path, "ab");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool ok = true;
+    if (!ftell(file))
+    {
+        FileHeader header = {
+            .magic = SESSIONS_FILE_MAGIC,
+            .version = SESSIONS_FILE_VERSION,
+            .recordSize = sizeof(SysClkSessionSummary),
+        };
+        ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+
+    ok = ok && fwrite(summary, sizeof(*summary), 1, file) == 1;
+    fclose(file);
+    Metrics::Increment(SysClkMetricCounter_SdWrites);
+
+    return ok;
+}
+
+void Sessions::GetSessions(std::uint64_t tid, SysClkSessionSummary* out_list, std::uint32_t maxCount, std::uint32_t* out_count)
+{
+    std::scoped_lock lock{this->sessionsMutex};
+
+    *out_count = 0;
+
+    char path[FILE_PATH_MAX];
+    this->GetPath(tid, path, sizeof(path));
+
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+        return;
+    }
+
+    FileHeader header;
+    if (fread(&header, sizeof(header), 1, file) == 1
+        && header.magic == SESSIONS_FILE_MAGIC
+        && header.version == SESSIONS_FILE_VERSION
+        && header.recordSize == sizeof(SysClkSessionSummary)
+        && !fseek(file, 0, SEEK_END))
+    {
+        // most recent records are at the end, return them oldest first
+        long records = (ftell(file) - (long)sizeof(header)) / (long)sizeof(SysClkSessionSummary);
+        long first = records > maxCount ? records - maxCount : 0;
+
+        if (!fseek(file, sizeof(header) + first * sizeof(SysClkSessionSummary), SEEK_SET))
+        {
+            *out_count = fread(out_list, sizeof(SysClkSessionSummary), records - first, file);
+        }
+    }
+
+    fclose(file);
+}
@@ -0,0 +1,56 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <string>
+#include <switch.h>
+#include <nxExt.h>
+#include <sysclk.h>
+
+#define SESSIONS_FILE_MAGIC 0x53534B43 // "CKSS"
+#define SESSIONS_FILE_VERSION 1
+
+class Sessions
+{
+  public:
+    Sessions(std::string dir);
+    virtual ~Sessions();
+
+    static Sessions* CreateDefault();
+
+    void Begin(std::uint64_t tid);
+    void End();
+    void Sample(const SysClkContext* context, std::uint32_t ms);
+    void GetSessions(std::uint64_t tid, SysClkSessionSummary* out_list, std::uint32_t maxCount, std::uint32_t* out_count);
+
+  protected:
+    typedef struct
+    {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t recordSize;
+    } FileHeader;
+
+    void GetPath(std::uint64_t tid, char* out, std::size_t size);
+    bool Append(const SysClkSessionSummary* summary);
+
+    std::string dir;
+    LockableMutex sessionsMutex;
+    bool active;
+    std::uint64_t tid;
+    std::uint32_t startTime;
+    std::uint64_t durationMs;
+    std::int64_t energyUj;
+    std::uint32_t profileMask;
+    std::uint64_t tempSums[SysClkThermalSensor_EnumMax];
+    std::uint32_t peakTemps[SysClkThermalSensor_EnumMax];
+    std::uint64_t freqSums[SysClkModule_EnumMax];
+    std::uint64_t freqMs[SysClkModule_EnumMax];
+};
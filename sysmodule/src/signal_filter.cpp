@@ -0,0 +1,209 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "signal_filter.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+// keeps slew steps within 64 bits, longer gaps just release the limit
+#define SIGNAL_FILTER_ELAPSED_MAX_MS 3600000
+#define SIGNAL_FILTER_SLEW_MAX 1000000
+
+static const char* g_stage_names[SignalFilterStageType_EnumMax] = { "ema", "median", "slew" };
+
+SignalFilter::SignalFilter()
+{
+    this->stageCount = 0;
+    this->Reset();
+}
+
+bool SignalFilter::Parse(const char* spec, Stage* out_stages, std::uint32_t* out_count)
+{
+    std::uint32_t count = 0;
+    const char* p = spec;
+
+    while(*p == ' ')
+    {
+        p++;
+    }
+
+    while(*p)
+    {
+        if(count >= SIGNAL_FILTER_STAGES_MAX)
+        {
+            return false;
+        }
+
+        const char* colon = strchr(p, ':');
+        if(!colon)
+        {
+            return false;
+        }
+
+        Stage* stage = &out_stages[count];
+        stage->type = SignalFilterStageType_EnumMax;
+        for(unsigned int type = 0; type < SignalFilterStageType_EnumMax; type++)
+        {
+            std::size_t len = strlen(g_stage_names[type]);
+            if((std::size_t)(colon - p) == len && !strncmp(p, g_stage_names[type], len))
+            {
+                stage->type = (SignalFilterStageType)type;
+            }
+        }
+
+        char* end = NULL;
+        long param = strtol(colon + 1, &end, 10);
+        if(stage->type == SignalFilterStageType_EnumMax || end == colon + 1)
+        {
+            return false;
+        }
+
+        long paramMax = stage->type == SignalFilterStageType_Ema ? 1000
+            : (stage->type == SignalFilterStageType_Median ? SIGNAL_FILTER_MEDIAN_MAX : SIGNAL_FILTER_SLEW_MAX);
+        long paramMin = stage->type == SignalFilterStageType_Median ? 2 : 1;
+        if(param < paramMin || param > paramMax)
+        {
+            return false;
+        }
+        stage->param = param;
+        count++;
+
+        p = end;
+        while(*p == ' ')
+        {
+            p++;
+        }
+
+        if(*p == ',')
+        {
+            p++;
+            while(*p == ' ')
+            {
+                p++;
+            }
+        }
+        else if(*p)
+        {
+            return false;
+        }
+    }
+
+    *out_count = count;
+    return true;
+}
+
+bool SignalFilter::Validate(const char* spec)
+{
+    Stage stages[SIGNAL_FILTER_STAGES_MAX];
+    std::uint32_t count;
+    return SignalFilter::Parse(spec, stages, &count);
+}
+
+bool SignalFilter::Configure(const char* spec)
+{
+    Stage stages[SIGNAL_FILTER_STAGES_MAX];
+    std::uint32_t count;
+    if(!SignalFilter::Parse(spec, stages, &count))
+    {
+        return false;
+    }
+
+    memcpy(this->stages, stages, sizeof(this->stages));
+    this->stageCount = count;
+    this->Reset();
+    return true;
+}
+
+void SignalFilter::Reset()
+{
+    for(std::uint32_t i = 0; i < SIGNAL_FILTER_STAGES_MAX; i++)
+    {
+        this->stages[i].primed = false;
+        this->stages[i].state = 0;
+        this->stages[i].windowCount = 0;
+        this->stages[i].windowPos = 0;
+    }
+}
+
+std::int32_t SignalFilter::ToInt(std::int64_t fixed)
+{
+    return (fixed + (1LL << (SIGNAL_FILTER_FRAC_BITS - 1))) >> SIGNAL_FILTER_FRAC_BITS;
+}
+
+std::int32_t SignalFilter::ApplyStage(Stage* stage, std::int32_t value, std::uint32_t elapsedMs)
+{
+    std::int64_t fixed = (std::int64_t)value << SIGNAL_FILTER_FRAC_BITS;
+
+    switch(stage->type)
+    {
+        case SignalFilterStageType_Ema:
+            if(!stage->primed)
+            {
+                stage->state = fixed;
+                stage->primed = true;
+            }
+            else
+            {
+                stage->state += (fixed - stage->state) * stage->param / 1000;
+            }
+            return SignalFilter::ToInt(stage->state);
+        case SignalFilterStageType_Median:
+        {
+            stage->window[stage->windowPos] = value;
+            stage->windowPos = (stage->windowPos + 1) % stage->param;
+            if(stage->windowCount < stage->param)
+            {
+                stage->windowCount++;
+            }
+
+            // insertion sort, the window is tiny
+            std::int32_t sorted[SIGNAL_FILTER_MEDIAN_MAX];
+            for(std::uint8_t i = 0; i < stage->windowCount; i++)
+            {
+                std::uint8_t j = i;
+                for(; j > 0 && sorted[j - 1] > stage->window[i]; j--)
+                {
+                    sorted[j] = sorted[j - 1];
+                }
+                sorted[j] = stage->window[i];
+            }
+
+            // lower middle for an even window
+            return sorted[(stage->windowCount - 1) / 2];
+        }
+        case SignalFilterStageType_Slew:
+        {
+            if(!stage->primed)
+            {
+                stage->state = fixed;
+                stage->primed = true;
+                return value;
+            }
+
+            std::int64_t maxStep = ((std::int64_t)stage->param << SIGNAL_FILTER_FRAC_BITS)
+                * std::min(elapsedMs, (std::uint32_t)SIGNAL_FILTER_ELAPSED_MAX_MS) / 1000;
+            stage->state += std::clamp(fixed - stage->state, -maxStep, maxStep);
+            return SignalFilter::ToInt(stage->state);
+        }
+        default:
+            return value;
+    }
+}
+
+std::int32_t SignalFilter::Apply(std::int32_t value, std::uint32_t elapsedMs)
+{
+    for(std::uint32_t i = 0; i < this->stageCount; i++)
+    {
+        value = this->ApplyStage(&this->stages[i], value, elapsedMs);
+    }
+
+    return value;
+}
@@ -0,0 +1,65 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <cstdint>
+
+#define SIGNAL_FILTER_STAGES_MAX 4
+#define SIGNAL_FILTER_MEDIAN_MAX 9
+#define SIGNAL_FILTER_FRAC_BITS 16
+
+typedef enum
+{
+    SignalFilterStageType_Ema = 0, // ema:<weight of the new sample, permille>
+    SignalFilterStageType_Median,  // median:<samples, 2 to SIGNAL_FILTER_MEDIAN_MAX>
+    SignalFilterStageType_Slew,    // slew:<max change per second, in signal units>
+    SignalFilterStageType_EnumMax
+} SignalFilterStageType;
+
+/*
+ * Chain of filter stages for one sampled signal, written in the [filters]
+ * section as "<stage>:<param>" separated by commas, applied left to right:
+ *   power_now=median:5,ema:250
+ * Integer only, EMA and slew state are kept with SIGNAL_FILTER_FRAC_BITS of
+ * fraction so small weights and rates do not stall. No dependency on the
+ * board or the clock, so it can be fed recorded samples on the host.
+ */
+class SignalFilter
+{
+  public:
+    SignalFilter();
+
+    // false if spec is invalid, the filter is left unchanged then; "" means no stage
+    bool Configure(const char* spec);
+    static bool Validate(const char* spec);
+    void Reset();
+
+    // elapsedMs since the previous sample, 0 for the first one
+    std::int32_t Apply(std::int32_t value, std::uint32_t elapsedMs);
+
+  protected:
+    typedef struct
+    {
+        SignalFilterStageType type;
+        std::int32_t param;
+        bool primed;
+        std::int64_t state;
+        std::int32_t window[SIGNAL_FILTER_MEDIAN_MAX];
+        std::uint8_t windowCount;
+        std::uint8_t windowPos;
+    } Stage;
+
+    static bool Parse(const char* spec, Stage* out_stages, std::uint32_t* out_count);
+    static std::int32_t ToInt(std::int64_t fixed);
+    std::int32_t ApplyStage(Stage* stage, std::int32_t value, std::uint32_t elapsedMs);
+
+    Stage stages[SIGNAL_FILTER_STAGES_MAX];
+    std::uint32_t stageCount;
+};
@@ -0,0 +1,293 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "stats.h"
+#include <cstdio>
+#include <cstring>
+#include "errors.h"
+#include "file_utils.h"
+#include "metrics.h"
+
+Stats::Stats(std::string path)
+{
+    this->path = path;
+    this->currentEntry = NULL;
+    this->sequence = 0;
+    this->dirty = false;
+    memset(this->entries, 0, sizeof(this->entries));
+    memset(this->freqTable, 0, sizeof(this->freqTable));
+}
+
+Stats::~Stats()
+{
+    this->Save();
+}
+
+Stats* Stats::CreateDefault()
+{
+    return new Stats(FILE_CONFIG_DIR "/stats.bin");
+}
+
+void Stats::SetFreqTable(SysClkModule module, const std::uint32_t* list, std::uint32_t count)
+{
+    ASSERT_ENUM_VALID(SysClkModule, module);
+
+    std::scoped_lock lock{this->statsMutex};
+    this->freqTable[module].count = std::min(count, (std::uint32_t)SYSCLK_FREQ_LIST_MAX);
+    memcpy(this->freqTable[module].list, list, this->freqTable[module].count * sizeof(*list));
+}
+
+void Stats::Load()
+{
+    std::scoped_lock lock{this->statsMutex};
+
+    FILE* file = fopen(this->path.c_str(), "rb");
+    if (!file)
+    {
+        return;
+    }
+
+    FileHeader header;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1
+        && header.magic == STATS_FILE_MAGIC
+        && header.version == STATS_FILE_VERSION
+        && header.entryCount <= STATS_MAX_TITLES;
+
+    // slots are only meaningful against the table they were recorded with
+    for (unsigned int module = 0; valid && module < SysClkModule_EnumMax; module++)
+    {
+        valid = header.freqCount[module] == this->freqTable[module].count
+            && !memcmp(header.freqList[module], this->freqTable[module].list, this->freqTable[module].count * sizeof(std::uint32_t));
+    }
+
+    if (!valid)
+    {
+        FileUtils::LogLine("[stats] Discarding %s (format or freq table mismatch)", this->path.c_str());
+        fclose(file);
+        return;
+    }
+
+    FileEntryHeader entryHeader;
+    for (std::uint16_t i = 0; valid && i < header.entryCount; i++)
+    {
+        valid = fread(&entryHeader, sizeof(entryHeader), 1, file) == 1;
+
+        Entry* entry = &this->entries[i];
+        entry->tid = entryHeader.tid;
+        entry->lastUsed = entryHeader.lastUsed;
+        entry->used = true;
+        memcpy(entry->stats.throttledMs, entryHeader.throttledMs, sizeof(entry->stats.throttledMs));
+        memcpy(entry->stats.throttleEpisodes, entryHeader.throttleEpisodes, sizeof(entry->stats.throttleEpisodes));
+        this->sequence = std::max(this->sequence, entryHeader.lastUsed + 1);
+
+        for (unsigned int profile = 0; valid && profile < SysClkProfile_EnumMax; profile++)
+        {
+            if (!(entryHeader.profileMask & (1 << profile)))
+            {
+                continue;
+            }
+
+            for (unsigned int module = 0; valid && module < SysClkModule_EnumMax; module++)
+            {
+                std::uint32_t count = this->freqTable[module].count;
+                valid = fread(entry->stats.timeInStateMs[profile][module], sizeof(std::uint32_t), count, file) == count;
+            }
+        }
+    }
+
+    if (!valid)
+    {
+        FileUtils::LogLine("[stats] Truncated %s, discarding", this->path.c_str());
+        memset(this->entries, 0, sizeof(this->entries));
+        this->sequence = 0;
+    }
+
+    fclose(file);
+}
+
+bool Stats::Save()
+{
+    std::scoped_lock lock{this->statsMutex};
+
+    if (!this->dirty)
+    {
+        return true;
+    }
+
+    FileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = STATS_FILE_MAGIC;
+    header.version = STATS_FILE_VERSION;
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        header.freqCount[module] = this->freqTable[module].count;
+        memcpy(header.freqList[module], this->freqTable[module].list, sizeof(header.freqList[module]));
+    }
+
+    for (unsigned int i = 0; i < STATS_MAX_TITLES; i++)
+    {
+        header.entryCount += this->entries[i].used;
+    }
+
+    FILE* file = fopen(this->path.c_str(), "wb");
+    if (!file)
+    {
+        return false;
+    }
+
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    // only the profiles a title was seen in and the populated slots are written
+    for (unsigned int i = 0; ok && i < STATS_MAX_TITLES; i++)
+    {
+        Entry* entry = &this->entries[i];
+        if (!entry->used)
+        {
+            continue;
+        }
+
+        FileEntryHeader entryHeader = {
+            .tid = entry->tid,
+            .lastUsed = entry->lastUsed,
+            .profileMask = 0,
+        };
+        memcpy(entryHeader.throttledMs, entry->stats.throttledMs, sizeof(entryHeader.throttledMs));
+        memcpy(entryHeader.throttleEpisodes, entry->stats.throttleEpisodes, sizeof(entryHeader.throttleEpisodes));
+
+        for (unsigned int profile = 0; profile < SysClkProfile_EnumMax; profile++)
+        {
+            for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+            {
+                for (std::uint32_t slot = 0; slot < this->freqTable[module].count; slot++)
+                {
+                    if (entry->stats.timeInStateMs[profile][module][slot])
+                    {
+                        entryHeader.profileMask |= 1 << profile;
+                    }
+                }
+            }
+        }
+
+        ok = fwrite(&entryHeader, sizeof(entryHeader), 1, file) == 1;
+
+        for (unsigned int profile = 0; ok && profile < SysClkProfile_EnumMax; profile++)
+        {
+            if (!(entryHeader.profileMask & (1 << profile)))
+            {
+                continue;
+            }
+
+            for (unsigned int module = 0; ok && module < SysClkModule_EnumMax; module++)
+            {
+                std::uint32_t count = this->freqTable[module].count;
+                ok = fwrite(entry->stats.timeInStateMs[profile][module], sizeof(std::uint32_t), count, file) == count;
+            }
+        }
+    }
+
+    fclose(file);
+    Metrics::Increment(SysClkMetricCounter_SdWrites);
+
+    if (ok)
+    {
+        this->dirty = false;
+    }
+
+    return ok;
+}
+
+Stats::Entry* Stats::FindEntry(std::uint64_t tid, bool create)
+{
+    if (this->currentEntry && this->currentEntry->used && this->currentEntry->tid == tid)
+    {
+        return this->currentEntry;
+    }
+
+    Entry* evict = NULL;
+    for (unsigned int i = 0; i < STATS_MAX_TITLES; i++)
+    {
+        Entry* entry = &this->entries[i];
+        if (entry->used && entry->tid == tid)
+        {
+            return entry;
+        }
+
+        if (!evict || (evict->used && (!entry->used || entry->lastUsed < evict->lastUsed)))
+        {
+            evict = entry;
+        }
+    }
+
+    if (!create)
+    {
+        return NULL;
+    }
+
+    // table is full, the least recently seen title makes room
+    memset(evict, 0, sizeof(*evict));
+    evict->tid = tid;
+    evict->lastUsed = this->sequence++;
+    evict->used = true;
+
+    return evict;
+}
+
+void Stats::AddTime(std::uint64_t tid, SysClkProfile profile, const std::uint32_t* slots, std::uint32_t ms)
+{
+    ASSERT_ENUM_VALID(SysClkProfile, profile);
+
+    std::scoped_lock lock{this->statsMutex};
+
+    Entry* entry = this->FindEntry(tid, true);
+    if (entry != this->currentEntry)
+    {
+        entry->lastUsed = this->sequence++;
+        this->currentEntry = entry;
+    }
+
+    for (unsigned int module = 0; module < SysClkModule_EnumMax; module++)
+    {
+        if (slots[module] < this->freqTable[module].count)
+        {
+            entry->stats.timeInStateMs[profile][module][slots[module]] += ms;
+        }
+    }
+
+    this->dirty = true;
+}
+
+void Stats::AddThrottledTime(std::uint64_t tid, SysClkModule module, std::uint32_t ms, bool newEpisode)
+{
+    ASSERT_ENUM_VALID(SysClkModule, module);
+
+    std::scoped_lock lock{this->statsMutex};
+
+    Entry* entry = this->FindEntry(tid, true);
+    entry->stats.throttledMs[module] += ms;
+    entry->stats.throttleEpisodes[module] += newEpisode;
+
+    this->dirty = true;
+}
+
+void Stats::GetTitleStats(std::uint64_t tid, SysClkTitleStats* out_stats)
+{
+    std::scoped_lock lock{this->statsMutex};
+
+    Entry* entry = this->FindEntry(tid, false);
+    if (entry)
+    {
+        memcpy(out_stats, &entry->stats, sizeof(*out_stats));
+    }
+    else
+    {
+        memset(out_stats, 0, sizeof(*out_stats));
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <string>
+#include <switch.h>
+#include <nxExt.h>
+#include <sysclk.h>
+
+#define STATS_MAX_TITLES 16
+#define STATS_FILE_MAGIC 0x54534B43 // "CKST"
+#define STATS_FILE_VERSION 2
+
+class Stats
+{
+  public:
+    Stats(std::string path);
+    virtual ~Stats();
+
+    static Stats* CreateDefault();
+
+    void SetFreqTable(SysClkModule module, const std::uint32_t* list, std::uint32_t count);
+    void Load();
+    bool Save();
+
+    void AddTime(std::uint64_t tid, SysClkProfile profile, const std::uint32_t* slots, std::uint32_t ms);
+    void AddThrottledTime(std::uint64_t tid, SysClkModule module, std::uint32_t ms, bool newEpisode);
+    void GetTitleStats(std::uint64_t tid, SysClkTitleStats* out_stats);
+
+  protected:
+    typedef struct
+    {
+        std::uint64_t tid;
+        std::uint32_t lastUsed;
+        bool used;
+        SysClkTitleStats stats;
+    } Entry;
+
+    typedef struct
+    {
+        std::uint32_t magic;
+        std::uint16_t version;
+        std::uint16_t entryCount;
+        std::uint32_t freqCount[SysClkModule_EnumMax];
+        std::uint32_t freqList[SysClkModule_EnumMax][SYSCLK_FREQ_LIST_MAX];
+    } FileHeader;
+
+    typedef struct
+    {
+        std::uint64_t tid;
+        std::uint32_t lastUsed;
+        std::uint32_t profileMask;
+        std::uint32_t throttledMs[SysClkModule_EnumMax];
+        std::uint32_t throttleEpisodes[SysClkModule_EnumMax];
+    } FileEntryHeader;
+
+    Entry* FindEntry(std::uint64_t tid, bool create);
+
+    std::string path;
+    LockableMutex statsMutex;
+    Entry entries[STATS_MAX_TITLES];
+    Entry* currentEntry;
+    std::uint32_t sequence;
+    bool dirty;
+    struct {
+      std::uint32_t count;
+      std::uint32_t list[SYSCLK_FREQ_LIST_MAX];
+    } freqTable[SysClkModule_EnumMax];
+};
@@ -0,0 +1,129 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#include "trace.h"
+#include <cstdio>
+#include <nxExt.h>
+#include <sysclk.h>
+#include "metrics.h"
+#include "arena.h"
+
+static LockableMutex g_trace_mutex;
+
+std::atomic_bool Trace::enabled = false;
+Trace::Event* Trace::buffer = NULL;
+std::uint32_t Trace::next = 0;
+std::uint32_t Trace::count = 0;
+
+std::uint16_t Trace::GetThreadId()
+{
+    static thread_local std::uint16_t threadId = 0;
+
+    if (!threadId)
+    {
+        std::uint64_t id = 0;
+        svcGetThreadId(&id, CUR_THREAD_HANDLE);
+        threadId = id ? id : UINT16_MAX;
+    }
+
+    return threadId;
+}
+
+void Trace::Initialize()
+{
+    std::scoped_lock lock{g_trace_mutex};
+
+    // carved at startup so toggling from ipc never touches the heap
+    Trace::buffer = Arena::AllocateArray<Event>(TRACE_BUFFER_EVENTS);
+}
+
+Result Trace::SetEnabled(bool enabled)
+{
+    std::scoped_lock lock{g_trace_mutex};
+
+    if (!Trace::buffer)
+    {
+        return SYSCLK_ERROR(OutOfMemory);
+    }
+
+    if (enabled && !Trace::enabled)
+    {
+        Trace::next = 0;
+        Trace::count = 0;
+    }
+
+    Trace::enabled = enabled;
+
+    return 0;
+}
+
+void Trace::Record(const char* name, std::uint16_t arg, std::uint64_t startTick, std::uint64_t endTick)
+{
+    std::uint16_t threadId = Trace::GetThreadId();
+
+    std::scoped_lock lock{g_trace_mutex};
+
+    if (!Trace::enabled)
+    {
+        return;
+    }
+
+    Event* event = &Trace::buffer[Trace::next];
+    event->startTick = startTick;
+    event->name = name;
+    event->durationTicks = std::min(endTick - startTick, (std::uint64_t)UINT32_MAX);
+    event->arg = arg;
+    event->threadId = threadId;
+
+    Trace::next = (Trace::next + 1) % TRACE_BUFFER_EVENTS;
+    Trace::count = std::min(Trace::count + 1, (std::uint32_t)TRACE_BUFFER_EVENTS);
+}
+
+Result Trace::Dump(const char* path)
+{
+    std::scoped_lock lock{g_trace_mutex};
+
+    if (!Trace::buffer || !Trace::count)
+    {
+        return SYSCLK_ERROR(Generic);
+    }
+
+    FILE* file = fopen(path, "w");
+    if (!file)
+    {
+        return SYSCLK_ERROR(FileWriteFailed);
+    }
+
+    // chrome trace event format, complete events with timestamps in us
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    std::uint32_t first = (Trace::next + TRACE_BUFFER_EVENTS - Trace::count) % TRACE_BUFFER_EVENTS;
+    for (std::uint32_t i = 0; i < Trace::count; i++)
+    {
+        Event* event = &Trace::buffer[(first + i) % TRACE_BUFFER_EVENTS];
+        std::uint64_t startNs = armTicksToNs(event->startTick);
+        std::uint64_t durationNs = armTicksToNs(event->durationTicks);
+
+        fprintf(file, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%lu.%03lu,\"dur\":%lu.%03lu,\"args\":{\"arg\":%u}}\n",
+            i ? "," : "",
+            event->name,
+            event->threadId,
+            startNs / 1000, startNs % 1000,
+            durationNs / 1000, durationNs % 1000,
+            event->arg
+        );
+    }
+
+    fprintf(file, "]}\n");
+    fclose(file);
+    Metrics::Increment(SysClkMetricCounter_SdWrites);
+
+    return 0;
+}
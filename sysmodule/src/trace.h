@@ -0,0 +1,78 @@
+/*
+ * --------------------------------------------------------------------------
+ * "THE BEER-WARE LICENSE" (Revision 42):
+ * <p-sam@d3vs.net>, <natinusala@gmail.com>, <m4x@m4xw.net>
+ * wrote this file. As long as you retain this notice you can do whatever you
+ * want with this stuff. If you meet any of us some day, and you think this
+ * stuff is worth it, you can buy us a beer in return.  - The sys-clk authors
+ * --------------------------------------------------------------------------
+ */
+
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <switch.h>
+
+#define TRACE_BUFFER_EVENTS 512
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+// records a complete span from here to the end of the enclosing scope
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(_traceScope, __LINE__)(name, 0)
+#define TRACE_SCOPE_ARG(name, arg) TraceScope TRACE_CONCAT(_traceScope, __LINE__)(name, arg)
+
+class Trace
+{
+  public:
+    static bool Enabled()
+    {
+        return __builtin_expect(enabled.load(std::memory_order_relaxed), false);
+    }
+
+    static void Initialize();
+    static Result SetEnabled(bool enabled);
+    static void Record(const char* name, std::uint16_t arg, std::uint64_t startTick, std::uint64_t endTick);
+    static Result Dump(const char* path);
+
+  protected:
+    typedef struct
+    {
+        std::uint64_t startTick;
+        const char* name;
+        std::uint32_t durationTicks;
+        std::uint16_t arg; // module, sensor or ipc command, keeps an event at 24 bytes
+        std::uint16_t threadId;
+    } Event;
+
+    static std::uint16_t GetThreadId();
+
+    static std::atomic_bool enabled;
+    static Event* buffer;
+    static std::uint32_t next;
+    static std::uint32_t count;
+};
+
+class TraceScope
+{
+  public:
+    TraceScope(const char* name, std::uint16_t arg)
+    {
+        this->startTick = Trace::Enabled() ? armGetSystemTick() : 0;
+        this->name = name;
+        this->arg = arg;
+    }
+
+    ~TraceScope()
+    {
+        if (__builtin_expect(this->startTick != 0, false))
+        {
+            Trace::Record(this->name, this->arg, this->startTick, armGetSystemTick());
+        }
+    }
+
+  protected:
+    std::uint64_t startTick;
+    const char* name;
+    std::uint16_t arg;
+};